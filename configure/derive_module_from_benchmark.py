@@ -6,22 +6,24 @@ import numpy as np
 import pandas as pd
 
 def main():
-	with pathlib.Path("ufuncs.json").open("r") as f:
-		ufuncs_json = json.load(f)
+	with pathlib.Path("vfuncs.json").open("r") as f:
+		vfuncs_json = json.load(f)
 
 	# To use this:
 	# - Compile the project with the 'previous' optimization as the base.
 	# - Rename the benchmark.csv file to benchmark-base.csv.
 	# - Compile the project with the target optimization.
 	# - Run this module.
+	# Instead of tests/run_tests.py, the benchmark csv files can also be created without Godot:
+	#  scons va_benchmark && build/va_benchmark/va_benchmark --output tests/gen/benchmark.csv
 	benchmark_base = pd.read_csv("../tests/gen/benchmark-base.csv", index_col=0)["numdot"]
 	benchmark_module = pd.read_csv("../tests/gen/benchmark.csv", index_col=0)["numdot"]
 
 	assert set(benchmark_base.index) == set(benchmark_module.index), "Incompatible benchmarks, re-run tests."
 
 	better_ufuncs = []
-	for ufunc in sorted(ufuncs_json["ufuncs"], key=lambda d: d["ufunc"]):
-		ufunc_name = ufunc["ufunc"]
+	for ufunc in sorted(vfuncs_json["vfuncs"], key=lambda d: d["name"]):
+		ufunc_name = ufunc["name"]
 		relevant_tests = [
 			test_name
 			for test_name in benchmark_base.index
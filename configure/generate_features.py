@@ -1,4 +1,5 @@
 import dataclasses
+import itertools
 import json
 import pathlib
 
@@ -197,12 +198,76 @@ def main():
 			"casts": [f"{dump_dtypes(input)}->{model.dumps()}" for input, model in casts.items()],
 		})
 
+	# Not a ufunc, but the same as minimum and maximum in one pass.
+	minimum_vfunc = [vfunc for vfunc in vfuncs if vfunc["name"] == "minimum"][0]
+	minimum_specializations = {
+		np.dtype(code[0]): UFuncSpecialization.parse(code)
+		for code in minimum_vfunc["specializations"]
+	}
+	clip_casts = OrderedDict()
+	for input in itertools.product(supported_dtypes, repeat=3):
+		# Same promotion as minimum(maximum(a, lo), hi).
+		common_dtype = common_dtypes[common_dtypes[input[0]][input[1]]][input[2]]
+		if all(dtype == common_dtype for dtype in input) or common_dtype not in minimum_specializations:
+			continue
+		clip_casts[input] = minimum_specializations[common_dtype]
+	vfuncs.append({
+		"name": "clip",
+		"specializations": [
+			f"{dump_dtypes(specialization.input[:1] * 3)}->{specialization.output.char}"
+			for specialization in minimum_specializations.values()
+		],
+		"casts": [
+			f"{dump_dtypes(input)}->{dump_dtypes(model.input[:1] * 3)}->{model.output.char}"
+			for input, model in clip_casts.items()
+		],
+	})
+
+	# The condition is cast to bool, the values to their common type.
+	where_casts = OrderedDict()
+	for input in itertools.product(supported_dtypes, repeat=3):
+		common_dtype = common_dtypes[input[1]][input[2]]
+		if input == (np.dtype(bool), common_dtype, common_dtype) or common_dtype not in minimum_specializations:
+			continue
+		where_casts[input] = minimum_specializations[common_dtype]
+	vfuncs.append({
+		"name": "where",
+		"specializations": [
+			f"?{dump_dtypes(specialization.input[:1] * 2)}->{specialization.output.char}"
+			for specialization in minimum_specializations.values()
+		],
+		"casts": [
+			f"{dump_dtypes(input)}->?{dump_dtypes(model.input[:1] * 2)}->{model.output.char}"
+			for input, model in where_casts.items()
+		],
+	})
+
 	# Not a ufunc because (in NumPy), it accepts a 'decimals' int parameter.
 	vfuncs.append({
 		"name": "round",
 		"specializations": ["f->f", "d->d", "F->F", "D->D"],
 		"casts": [],
 	})
+	# Not ufuncs in NumPy (or not only), but pairs of outputs that are computed in one pass over the input.
+	# Inputs without a native specialization are computed as float64.
+	non_float_dtypes = [type_ for type_ in supported_dtypes if not np.isdtype(type_, ('real floating', 'complex floating'))]
+	for ufunc_name, specializations in [
+		("sincos", ["D->DD", "F->FF", "d->dd", "f->ff"]),
+		("modf", ["d->dd", "f->ff"]),
+		("frexp", ["d->di", "f->fi"]),
+	]:
+		vfuncs.append({
+			"name": ufunc_name,
+			"specializations": specializations,
+			"casts": [f"{type_.char}->{next(code for code in specializations if code[0] == 'd')}" for type_ in non_float_dtypes],
+		})
+	# Same types as 'remainder', with the quotient as a second output.
+	remainder_vfunc = [vfunc for vfunc in vfuncs if vfunc["name"] == "remainder"][0]
+	vfuncs.append({
+		"name": "divmod",
+		"specializations": [f"{code}{code[-1]}" for code in remainder_vfunc["specializations"]],
+		"casts": [f"{code}{code[-1]}" for code in remainder_vfunc["casts"]],
+	})
 	vfuncs.append({
 		"name": "is_close",
 		# TODO Could implement other dtypes by just calling equals in the implementation.
@@ -224,6 +289,12 @@ def main():
 			"casts": casts_at_least_float32,
 			"vargs": ["const va::axes_type*"]
 		})
+	vfuncs.append({
+		"name": "quantile",
+		"specializations": specializations_at_least_float32,
+		"casts": casts_at_least_float32,
+		"vargs": ["const va::axes_type*", "double"]
+	})
 	for rfunc in ["max", "min"]:
 		vfuncs.append({
 			"name": rfunc,
@@ -231,15 +302,24 @@ def main():
 			"casts": [],
 			"vargs": ["const va::axes_type*"]
 		})
+	vfuncs.append({
+		"name": "count_nonzero",
+		"specializations": [
+			f"{type_.char}->l"
+			for type_ in supported_dtypes
+		],
+		"casts": [],
+		"vargs": ["const va::axes_type*"]
+	})
 	for rfunc in ["all", "any"]:
 		vfuncs.append({
 			"name": rfunc,
-			"specializations": ["?->?"],
-			"casts": [
-				f"{type_.char}->?->?"
+			# Native for all dtypes, so that early exits don't have to wait for a cast of the whole input.
+			"specializations": [
+				f"{type_.char}->?"
 				for type_ in supported_dtypes
-				if type_ != np.dtype(bool)
 			],
+			"casts": [],
 			"vargs": ["const va::axes_type*"]
 		})
 	vfuncs.append({
@@ -252,24 +332,6 @@ def main():
 		**[vfunc for vfunc in vfuncs if vfunc["name"] == "is_close"][0],
 		"name": "all_close",
 	})
-	vfuncs.append({
-		"name": "fft",
-		"specializations": ["D->D", "F->F"],
-		"casts": [
-			"?->D->D",
-			"B->D->D",
-			"H->D->D",
-			"I->D->D",
-			"Q->D->D",
-			"b->D->D",
-			"d->D->D",
-			"f->F->F",
-			"h->D->D",
-			"i->D->D",
-			"q->D->D"
-		],
-		"vargs": ["const std::ptrdiff_t"]
-	})
 	vfuncs.append({
 		# Copy 'multiply' type info.
 		**[vfunc for vfunc in vfuncs if vfunc["name"] == "multiply"][0],
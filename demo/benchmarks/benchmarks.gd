@@ -7,3 +7,7 @@ func _ready() -> void:
 	$Trigonometry.run_benchmark()
 	$Reductions.run_benchmark()
 	$Matrix.run_benchmark()
+	$CallOverhead.run_benchmark()
+	$ScalarReductions.run_benchmark()
+	$Sorting.run_benchmark()
+	$Scans.run_benchmark()
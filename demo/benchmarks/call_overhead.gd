@@ -0,0 +1,85 @@
+extends Benchmark
+
+# Small arrays, where the fixed cost of each call dominates the time spent computing.
+
+func run_numdot_nd(
+	test_size: int,
+	test_count: int,
+):
+	var a_nd := nd.ones(test_size, nd.DType.Float32)
+	var b_nd := nd.ones(test_size, nd.DType.Float32)
+
+	begin_section("add")
+	for t in test_count:
+		nd.add(a_nd, b_nd)
+	store_result()
+
+	begin_section("mul")
+	for t in test_count:
+		nd.multiply(a_nd, b_nd)
+	store_result()
+
+	begin_section("sin")
+	for t in test_count:
+		nd.sin(a_nd)
+	store_result()
+
+
+func run_numdot_inplace(
+	test_size: int,
+	test_count: int,
+):
+	var a_nd := nd.ones(test_size, nd.DType.Float32)
+	var b_nd := nd.ones(test_size, nd.DType.Float32)
+
+	begin_section("add")
+	for t in test_count:
+		a_nd.assign_add(a_nd, b_nd)
+	store_result()
+
+	begin_section("mul")
+	for t in test_count:
+		a_nd.assign_multiply(a_nd, b_nd)
+	store_result()
+
+	begin_section("sin")
+	for t in test_count:
+		a_nd.assign_sin(b_nd)
+	store_result()
+
+
+func run_numdot_broadcast(
+	test_size: int,
+	test_count: int,
+):
+	# Not eligible for the flat path, for comparison.
+	var a_nd := nd.ones([1, test_size], nd.DType.Float32)
+	var b_nd := nd.ones(test_size, nd.DType.Float32)
+
+	begin_section("add")
+	for t in test_count:
+		nd.add(a_nd, b_nd)
+	store_result()
+
+	begin_section("mul")
+	for t in test_count:
+		nd.multiply(a_nd, b_nd)
+	store_result()
+
+
+func run_benchmark():
+	const test_count := 100000
+
+	for test_size in [16, 256, 1024]:
+		print("Call overhead with size=%d count: %d" % [test_size, test_count])
+
+		print("NumDot nd:")
+		run_numdot_nd(test_size, test_count)
+
+		print("NumDot inplace:")
+		run_numdot_inplace(test_size, test_count)
+
+		print("NumDot broadcast:")
+		run_numdot_broadcast(test_size, test_count)
+
+	end()
@@ -24,6 +24,39 @@ func run_gdscript(
 				vector_result[y] += matrix_flat[x * 4 + y]
 	store_result()
 
+	var bases: Array[Basis] = []
+	bases.resize(test_size)
+	bases.fill(Basis(Vector3(2, 1, 1), Vector3(1, 2, 1), Vector3(1, 1, 2)))
+	var rhs := Vector3(1, 2, 3)
+
+	begin_section("solve 3x3")
+	for t in test_count:
+		for basis in bases:
+			basis.inverse() * rhs
+	store_result()
+
+	# Two edges per triangle, like when computing mesh normals.
+	var edges_a := PackedVector3Array()
+	edges_a.resize(test_size)
+	edges_a.fill(Vector3(1, 2, 3))
+	var edges_b := PackedVector3Array()
+	edges_b.resize(test_size)
+	edges_b.fill(Vector3(3, 1, 2))
+
+	begin_section("cross")
+	for t in test_count:
+		for i in test_size:
+			edges_a[i].cross(edges_b[i])
+	store_result()
+
+	var up := Vector3(0, 1, 0)
+
+	begin_section("cross broadcast")
+	for t in test_count:
+		for edge in edges_a:
+			edge.cross(up)
+	store_result()
+
 func run_numdot(
 	test_size: int,
 	test_count: int,
@@ -43,6 +76,30 @@ func run_numdot(
 		nd.matmul(matrix, vector.get(&"newaxis", &":"))
 	store_result()
 
+	var bases := nd.add(nd.ones([test_size, 3, 3], nd.DType.Float32), nd.eye(3, 0, nd.DType.Float32))
+	var rhs := nd.arange(1, 4, 1, nd.DType.Float32)
+
+	begin_section("solve 3x3")
+	for t in test_count:
+		nd.solve(bases, rhs)
+	store_result()
+
+	# Two edges per triangle, like when computing mesh normals.
+	var edges_a := nd.ones([test_size, 3], nd.DType.Float32)
+	var edges_b := nd.full([test_size, 3], 2, nd.DType.Float32)
+
+	begin_section("cross")
+	for t in test_count:
+		nd.cross(edges_a, edges_b)
+	store_result()
+
+	var up := nd.array([0, 1, 0], nd.DType.Float32)
+
+	begin_section("cross broadcast")
+	for t in test_count:
+		nd.cross(edges_a, up)
+	store_result()
+
 func run_benchmark():
 	const test_size := 1000
 	const test_count := 100
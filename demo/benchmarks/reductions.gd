@@ -80,6 +80,19 @@ func run_numdot_ndifb(
 		ndb.all(b_nd)
 	store_result()
 
+	# Decided by the first element, so these should not need to read the rest.
+	var c_nd := nd.zeros(test_size, nd.DType.Float32)
+
+	begin_section("all (early exit)")
+	for t in test_count:
+		ndb.all(c_nd)
+	store_result()
+
+	begin_section("all_close (early exit)")
+	for t in test_count:
+		ndb.all_close(a_nd, c_nd)
+	store_result()
+
 
 func run_benchmark():
 	const test_size := 50000
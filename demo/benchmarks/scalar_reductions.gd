@@ -0,0 +1,71 @@
+extends Benchmark
+
+# Full reductions to a single value, where the fixed cost of each call dominates for small arrays.
+
+func run_numdot_nd(
+	test_size: int,
+	test_count: int,
+):
+	var a_nd := nd.ones(test_size, nd.DType.Float64)
+	var b_nd := nd.ones(test_size, nd.DType.Int64)
+	var c_nd := nd.ones(test_size, nd.DType.Bool)
+
+	begin_section("sum")
+	for t in test_count:
+		nd.sum(a_nd)
+	store_result()
+
+	begin_section("max")
+	for t in test_count:
+		nd.max(b_nd)
+	store_result()
+
+	begin_section("all")
+	for t in test_count:
+		nd.all(c_nd)
+	store_result()
+
+
+func run_numdot_scalar(
+	test_size: int,
+	test_count: int,
+):
+	var a_nd := nd.ones(test_size, nd.DType.Float64)
+	var b_nd := nd.ones(test_size, nd.DType.Int64)
+	var c_nd := nd.ones(test_size, nd.DType.Bool)
+
+	begin_section("sum")
+	for t in test_count:
+		ndf.sum(a_nd)
+	store_result()
+
+	begin_section("max")
+	for t in test_count:
+		ndi.max(b_nd)
+	store_result()
+
+	begin_section("all")
+	for t in test_count:
+		ndb.all(c_nd)
+	store_result()
+
+	# Needs a cast of the result to float.
+	begin_section("sum int")
+	for t in test_count:
+		ndf.sum(b_nd)
+	store_result()
+
+
+func run_benchmark():
+	const test_count := 100000
+
+	for test_size in [10, 100, 1000]:
+		print("Scalar reductions with size=%d count: %d" % [test_size, test_count])
+
+		print("NumDot nd:")
+		run_numdot_nd(test_size, test_count)
+
+		print("NumDot ndf / ndi / ndb:")
+		run_numdot_scalar(test_size, test_count)
+
+	end()
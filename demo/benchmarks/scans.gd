@@ -0,0 +1,56 @@
+extends Benchmark
+
+# Smoothing a telemetry series with a moving average, and running totals.
+
+func run_numdot_windows(
+	test_size: int,
+	test_count: int,
+	window: int,
+):
+	var rng := nd.default_rng()
+	var series := rng.random([test_size])
+
+	begin_section("moving average")
+	for t in test_count:
+		nd.mean(nd.sliding_window_view(series, [window]), -1)
+	store_result()
+
+
+func run_numdot_rolling(
+	test_size: int,
+	test_count: int,
+	window: int,
+):
+	var rng := nd.default_rng()
+	var series := rng.random([test_size])
+
+	begin_section("moving average")
+	for t in test_count:
+		nd.rolling_mean(series, window)
+	store_result()
+
+	begin_section("moving max")
+	for t in test_count:
+		nd.rolling_max(series, window)
+	store_result()
+
+	begin_section("cumsum")
+	for t in test_count:
+		nd.cumsum(series)
+	store_result()
+
+
+func run_benchmark():
+	const test_count := 100
+	const test_size := 100000
+
+	for window in [10, 100]:
+		print("Scans with size=%d window=%d count: %d" % [test_size, window, test_count])
+
+		print("NumDot sliding_window_view:")
+		run_numdot_windows(test_size, test_count, window)
+
+		print("NumDot rolling:")
+		run_numdot_rolling(test_size, test_count, window)
+
+	end()
@@ -0,0 +1,68 @@
+extends Benchmark
+
+# Sorting sprites by depth: values, and the order to draw them in.
+
+func run_godot(
+	test_size: int,
+	test_count: int,
+):
+	var depths := PackedFloat32Array()
+	depths.resize(test_size)
+	for i in test_size:
+		depths[i] = randf()
+
+	begin_section("sort")
+	for t in test_count:
+		var sorted := depths.duplicate()
+		sorted.sort()
+	store_result()
+
+	begin_section("argsort")
+	var indices := range(test_size)
+	for t in test_count:
+		indices.sort_custom(func(a, b): return depths[a] < depths[b])
+	store_result()
+
+
+func run_numdot(
+	test_size: int,
+	test_count: int,
+):
+	var rng := nd.default_rng()
+	var depths := rng.random([test_size], nd.Float32)
+	var ids := rng.integers(1000000, null, [test_size], nd.Int32)
+
+	begin_section("sort")
+	for t in test_count:
+		nd.sort(depths)
+	store_result()
+
+	begin_section("argsort")
+	for t in test_count:
+		nd.argsort(depths)
+	store_result()
+
+	begin_section("sort int")
+	for t in test_count:
+		nd.sort(ids)
+	store_result()
+
+	begin_section("top_k 100")
+	for t in test_count:
+		nd.top_k(depths, 100)
+	store_result()
+
+
+func run_benchmark():
+	const test_count := 10
+
+	for test_size in [1000, 100000]:
+		print("Sorting with size=%d count: %d" % [test_size, test_count])
+
+		print("Godot:")
+		run_godot(test_size, test_count)
+
+		print("NumDot:")
+		run_numdot(test_size, test_count)
+
+	end()
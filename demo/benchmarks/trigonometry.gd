@@ -19,6 +19,15 @@ func run_gdscript(
 			a_packed[i] = sin(a_packed[i])
 	store_result()
 
+	var b_packed := PackedFloat32Array()
+	b_packed.resize(test_size)
+	begin_section("sincos")
+	for t in test_count:
+		for i in test_size:
+			b_packed[i] = cos(a_packed[i])
+			a_packed[i] = sin(a_packed[i])
+	store_result()
+
 	begin_section("asinh")
 	for t in test_count:
 		for i in test_size:
@@ -41,6 +50,17 @@ func run_numdot_nd(
 		nd.sin(a_nd)
 	store_result()
 
+	begin_section("sin, cos")
+	for t in test_count:
+		nd.sin(a_nd)
+		nd.cos(a_nd)
+	store_result()
+
+	begin_section("sincos")
+	for t in test_count:
+		nd.sincos(a_nd)
+	store_result()
+
 	begin_section("asinh")
 	for t in test_count:
 		nd.asinh(a_nd)
@@ -55,9 +55,8 @@ func initialize_direction_array(length: int) -> NDArray:
 
 	# Initialize direction vector of shape [length, 2]
 	# Values are normalized 2D direction vectors according to angles
-	var directions_x := nd.cos(angles)
-	var directions_y := nd.sin(angles)
-	return nd.stack([directions_x, directions_y], 1)
+	var directions_yx := nd.sincos(angles)
+	return nd.stack([directions_yx[1], directions_yx[0]], 1)
 
 
 func simulation_step(delta: float) -> void:
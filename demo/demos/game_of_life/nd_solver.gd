@@ -6,6 +6,7 @@ var image_data: NDArray
 var neighour_count: NDArray
 var neighbor_kernel: NDArray
 var tmp_inner: NDArray
+var tmp_inner_2: NDArray
 
 var rng := nd.default_rng()
 
@@ -18,6 +19,7 @@ func initialize() -> void:
 
 	neighour_count = nd.zeros_like(is_alive_inner, nd.Int8)
 	tmp_inner = nd.empty_like(is_alive_inner, nd.Bool)
+	tmp_inner_2 = nd.empty_like(is_alive_inner, nd.Bool)
 	
 	neighbor_kernel = nd.array([[1, 1, 1], [1, 0, 1], [1, 1, 1]], nd.Int8);
 
@@ -26,11 +28,12 @@ func initialize() -> void:
 func simulation_step() -> void:
 	neighour_count.assign_convolve(is_alive, neighbor_kernel)
 	
-	# This uses masks, not sure if that's the best performing action here.
-	# Boolean operations may be accelerated better!
-	is_alive_inner.set(false, tmp_inner.assign_less(neighour_count, 2))
-	is_alive_inner.set(true, tmp_inner.assign_equal(neighour_count, 3))
-	is_alive_inner.set(false, tmp_inner.assign_greater(neighour_count, 3))
+	# Cells with 2 neighbors stay as they are, all others live only with exactly 3 neighbors.
+	is_alive_inner.assign_where(
+		tmp_inner.assign_equal(neighour_count, 2),
+		is_alive_inner,
+		tmp_inner_2.assign_equal(neighour_count, 3)
+	)
 
 func on_draw() -> void:
 	image_data.set(is_alive_inner)
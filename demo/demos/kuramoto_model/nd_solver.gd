@@ -6,8 +6,8 @@ var phase: NDArray # oscillator phases
 # pre-allocations
 var rng := nd.default_rng()
 
-var phase_coherence: NDArray
-var avg_phase: NDArray
+var phase_coherence: float
+var avg_phase: float
 var phase_sin: NDArray
 var phase_cos: NDArray
 
@@ -23,8 +23,6 @@ func initialize() -> void:
 	phase = nd.multiply(2*PI, rng.random(params.N))
 	generate_frequencies()
 	
-	phase_coherence = nd.zeros(1)
-	avg_phase = nd.zeros(1)
 	phase_sin = nd.zeros(params.N)
 	phase_cos = nd.zeros(params.N)
 	
@@ -38,12 +36,14 @@ func simulation_step() -> void:
 	for i in params.sub_steps: integrator[params.integrator_idx].call(dt_substep)
 
 func compute_derivative(df: NDArray, phase: NDArray):
-	phase_sin.assign_sin(phase)
-	phase_cos.assign_cos(phase)
-	phase_coherence.assign_divide(nd.sqrt(nd.add(nd.square(nd.sum(phase_cos)), nd.square(nd.sum(phase_sin)))), phase.size)
-	avg_phase.assign_atan2(nd.sum(phase_sin), nd.sum(phase_cos))
+	# sin and cos in one pass over phase.
+	phase_sin.assign_sincos(phase_cos, phase)
+	var phase_sin_sum := ndf.sum(phase_sin)
+	var phase_cos_sum := ndf.sum(phase_cos)
+	phase_coherence = sqrt(phase_sin_sum**2 + phase_cos_sum**2) / params.N
+	avg_phase = atan2(phase_sin_sum, phase_cos_sum)
 	
-	df.assign_subtract(omega, nd.multiply(nd.multiply(params.coupling, phase_coherence), nd.sin(nd.subtract(phase, avg_phase))))
+	df.assign_subtract(omega, nd.multiply(params.coupling * phase_coherence, nd.sin(nd.subtract(phase, avg_phase))))
 
 func euler_step(dt: float) -> void:
 	compute_derivative(k1, phase)
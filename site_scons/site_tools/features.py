@@ -97,7 +97,8 @@ class VFuncInfo:
 class VFuncSpecialization:
 	vfunc_name: str
 
-	output: DType
+	# Most functions have one output, some have none (in-place) or several.
+	outputs: tuple[DType, ...]
 	input: tuple[DType, ...]
 	model_input: Optional[tuple[DType, ...]]
 
@@ -123,7 +124,7 @@ class Features:
 				features.all.append(
 					VFuncSpecialization(
 						vfunc_name=vfunc_obj["name"],
-						output=code_to_dtype[rest_parts[0]] if len(rest_parts) > 0 else None,
+						outputs=tuple(code_to_dtype[output_str] for output_str in rest_parts[0]) if len(rest_parts) > 0 else (),
 						input=tuple(code_to_dtype[input_str] for input_str in input_str),
 						model_input=None
 					)
@@ -138,7 +139,7 @@ class Features:
 				features.all.append(
 					VFuncSpecialization(
 						vfunc_name=vfunc_obj["name"],
-						output=code_to_dtype[rest_parts[0]] if len(rest_parts) > 0 else None,
+						outputs=tuple(code_to_dtype[output_str] for output_str in rest_parts[0]) if len(rest_parts) > 0 else (),
 						input=tuple(code_to_dtype[input_str] for input_str in input_str),
 						model_input=tuple(code_to_dtype[input_str] for input_str in model_input_str)
 					)
@@ -235,10 +236,12 @@ def make_module(env, sources, module_name: str, features: Features):
 			if any(dtype in complex_dtypes for dtype in specialization.input) and (
 				vfunc.name == "minimum"
 				or vfunc.name == "maximum"
+				or vfunc.name == "clip"
 				or vfunc.name == "max"
 				or vfunc.name == "min"
 				or vfunc.name == "mean"
 				or vfunc.name == "median"
+				or vfunc.name == "quantile"
 				or vfunc.name == "variance"
 				or vfunc.name == "standard_deviation"
 				or vfunc.name == "rint"
@@ -251,7 +254,7 @@ def make_module(env, sources, module_name: str, features: Features):
 				continue
 
 			input_types_cpp = "".join(f", {dtype_to_c_type[dtype]}" for dtype in specialization.input)
-			output_type_cpp = f", {dtype_to_c_type[specialization.output]}" if specialization.output is not None else ""
+			output_type_cpp = "".join(f", {dtype_to_c_type[dtype]}" for dtype in specialization.outputs)
 
 			vargs_part = "".join(f", {varg}" for varg in vfunc.vargs)
 			configure_str += f"\tadd_native<{vfunc.name}{output_type_cpp}{input_types_cpp}{vargs_part}>(tables::{vfunc.name});\n"
@@ -85,6 +85,10 @@ def generate(env, godot_cpp_env, sources):
         env.Append(CPPFLAGS=["-msimd128"])
         # TODO We could also pass -fno-vectorize for size-optimizing builds, as discussed in the linked issue.
 
+    if not env.get("threads", True):
+        # Our thread pool runs everything on the calling thread.
+        env.Append(CPPDEFINES=["NUMDOT_DISABLE_THREADS"])
+
     if openmp_threshold >= 0:
         # TODO Support is not yet complete. We somehow need include paths for each OS.
         if is_msvc:
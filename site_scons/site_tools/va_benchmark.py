@@ -0,0 +1,52 @@
+from SCons.Script import ARGLIST, ARGUMENTS
+from SCons.Tool import Tool
+from SCons.Variables.BoolVariable import _text2bool
+
+
+def exists(env):
+    return True
+
+def generate(env):
+    """
+    Builds tests/benchmark/va_benchmark.cpp against the va:: layer only, without godot-cpp.
+    Supports the use_xsimd, optimize_for_arch, numdot_config and define options of the main build.
+    """
+    features_tool = Tool("features")
+
+    is_msvc = env["CC"] == "cl"
+
+    if is_msvc:
+        env.Append(CXXFLAGS=["/std:c++20", "/EHsc", "/bigobj"])
+        env.Append(CCFLAGS=["/O2"])
+    else:
+        env.Append(CXXFLAGS=["-std=c++20"])
+        env.Append(CCFLAGS=["-O3"])
+        env.Append(LINKFLAGS=["-pthread"])
+
+    env.Append(CPPDEFINES=["NDEBUG"])
+    for key, value in ARGLIST:
+        if key == "define":
+            env.Append(CPPDEFINES=[value])
+
+    if optimize_for_arch := ARGUMENTS.get("optimize_for_arch", ""):
+        env.Append(CPPFLAGS=[f"-march={optimize_for_arch}"])
+
+    if _text2bool(ARGUMENTS.get("use_xsimd", "yes")):
+        env.Append(CCFLAGS=["-DXTENSOR_USE_XSIMD=1"])
+
+    if "numdot_config" in ARGUMENTS:
+        env["numdot_config"] = ARGUMENTS["numdot_config"]
+
+    env.Append(CPPPATH=["xtl/include", "xsimd/include", "xtensor/include", "xtensor-signal/include"])
+    env.Append(CPPPATH=["src/"])
+
+    sources = [
+        f for f in env.Glob("src/vatensor/*.cpp") + env.Glob("src/vatensor/*/*.cpp")
+        if not "/gen/" in str(f.path)
+    ]
+    features_tool.generate(env, sources)
+    sources.append("tests/benchmark/va_benchmark.cpp")
+
+    program = env.Program("build/va_benchmark/va_benchmark", source=sources)
+    env.Alias("va_benchmark", program)
+    return program
@@ -1,9 +1,11 @@
 #include "nd.hpp"
 
-#include <vatensor/linalg.hpp>                // for sum_product, dot, matmul
+#include <vatensor/einsum.hpp>                // for tensordot, einsum
+#include <vatensor/linalg.hpp>                // for sum_product, dot, matmul, solve, lu, qr, eigh, svd
 #include <vatensor/vassign.hpp>               // for assign
 #include "vatensor/vfunc/entrypoints.hpp"
 #include <cmath>                            // for double_t, isinf
+#include <numeric>                          // for iota
 #include <optional>                         // for optional
 #include <stdexcept>                        // for runtime_error
 #include <memory>                           // shared_ptr
@@ -13,10 +15,16 @@
 #include <variant>                          // for visit
 #include <gdconvert/conversion_scalar.hpp>
 #include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/zip_packer.hpp>
+#include <vatensor/scan.hpp>
+#include <vatensor/scatter.hpp>
+#include <vatensor/sort.hpp>
 #include <vatensor/stride_tricks.hpp>
 #include <vatensor/vcarray.hpp>
 #include <vatensor/vsignal.hpp>
 #include <vatensor/vio.hpp>
+#include <vatensor/vparallel.hpp>
 #include <vatensor/dtype.hpp>
 #include <vatensor/xscalar_store.hpp>
 #include <vatensor/xtensor_store.hpp>
@@ -127,6 +135,7 @@ void nd::_bind_methods() {
 	godot::ClassDB::bind_static_method("nd", D_METHOD("hsplit", "v", "indices_or_section_size"), &nd::hsplit);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("vsplit", "v", "indices_or_section_size"), &nd::vsplit);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("squeeze", "v"), &nd::squeeze);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("take", "v", "indices", "axis"), &nd::take, DEFVAL(nullptr));
 
 	godot::ClassDB::bind_static_method("nd", D_METHOD("real", "v"), &nd::real);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("imag", "v"), &nd::imag);
@@ -142,6 +151,7 @@ void nd::_bind_methods() {
 	godot::ClassDB::bind_static_method("nd", D_METHOD("multiply", "a", "b"), &nd::multiply);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("divide", "a", "b"), &nd::divide);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("remainder", "a", "b"), &nd::remainder);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("divmod", "a", "b"), &nd::divmod);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("pow", "a", "b"), &nd::pow);
 
 	godot::ClassDB::bind_static_method("nd", D_METHOD("minimum", "a", "b"), &nd::minimum);
@@ -173,11 +183,14 @@ void nd::_bind_methods() {
 	godot::ClassDB::bind_static_method("nd", D_METHOD("asinh", "a"), &nd::asinh);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("acosh", "a"), &nd::acosh);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("atanh", "a"), &nd::atanh);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("sincos", "a"), &nd::sincos);
 
 	godot::ClassDB::bind_static_method("nd", D_METHOD("sum", "a", "axes"), &nd::sum, DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("prod", "a", "axes"), &nd::prod, DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("mean", "a", "axes"), &nd::mean, DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("median", "a", "axes"), &nd::median, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("quantile", "a", "q", "axes"), &nd::quantile, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("percentile", "a", "q", "axes"), &nd::percentile, DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("var", "a", "axes"), &nd::variance, DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("std", "a", "axes"), &nd::standard_deviation, DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("max", "a", "axes"), &nd::max, DEFVAL(nullptr));
@@ -185,11 +198,32 @@ void nd::_bind_methods() {
 	godot::ClassDB::bind_static_method("nd", D_METHOD("norm", "a", "ord", "axes"), &nd::norm, DEFVAL(2), DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("count_nonzero", "a", "axes"), &nd::count_nonzero, DEFVAL(nullptr));
 
+	godot::ClassDB::bind_static_method("nd", D_METHOD("add_at", "a", "indices", "values"), &nd::add_at);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("bincount", "x", "weights", "minlength"), &nd::bincount, DEFVAL(nullptr), DEFVAL(0));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("segment_sum", "data", "segment_ids", "num_segments", "sorted"), &nd::segment_sum, DEFVAL(nullptr), DEFVAL(false));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("segment_max", "data", "segment_ids", "num_segments", "sorted"), &nd::segment_max, DEFVAL(nullptr), DEFVAL(false));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("sort", "a", "axis"), &nd::sort, DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("argsort", "a", "axis"), &nd::argsort, DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("partition", "a", "kth", "axis"), &nd::partition, DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("top_k", "a", "k", "axis", "largest"), &nd::top_k, DEFVAL(-1), DEFVAL(true));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("unique", "a"), &nd::unique);
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cumsum", "a", "axis"), &nd::cumsum, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cumprod", "a", "axis"), &nd::cumprod, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cummax", "a", "axis"), &nd::cummax, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("diff", "a", "n", "axis"), &nd::diff, DEFVAL(1), DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("rolling_sum", "a", "window", "axis"), &nd::rolling_sum, DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("rolling_mean", "a", "window", "axis"), &nd::rolling_mean, DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("rolling_max", "a", "window", "axis"), &nd::rolling_max, DEFVAL(-1));
+
 	godot::ClassDB::bind_static_method("nd", D_METHOD("floor", "a"), &nd::floor);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("ceil", "a"), &nd::ceil);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("round", "a"), &nd::round);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("trunc", "a"), &nd::trunc);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("rint", "a"), &nd::rint);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("modf", "a"), &nd::modf);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("frexp", "a"), &nd::frexp);
 
 	godot::ClassDB::bind_static_method("nd", D_METHOD("equal", "a", "b"), &nd::equal);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("not_equal", "a", "b"), &nd::not_equal);
@@ -206,6 +240,7 @@ void nd::_bind_methods() {
 	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_or", "a", "b"), &nd::logical_or);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_xor", "a", "b"), &nd::logical_xor);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_not", "a"), &nd::logical_not);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("where", "condition", "x", "y"), &nd::where);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("all", "a", "axes"), &nd::all, DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("any", "a", "axes"), &nd::any, DEFVAL(nullptr));
 
@@ -219,7 +254,17 @@ void nd::_bind_methods() {
 	godot::ClassDB::bind_static_method("nd", D_METHOD("dot", "a", "b"), &nd::dot);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("sum_product", "a", "b", "axes"), &nd::sum_product, DEFVAL(nullptr));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("matmul", "a", "b"), &nd::matmul);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("tensordot", "a", "b", "axes"), &nd::tensordot, DEFVAL(2));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("einsum", "subscripts", "operands"), &nd::einsum);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("cross", "a", "b", "axisa", "axisb", "axisc"), &nd::cross, DEFVAL(-1), DEFVAL(-1), DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("solve", "a", "b"), &nd::solve);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("inv", "a"), &nd::inv);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("det", "a"), &nd::det);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cholesky", "a"), &nd::cholesky);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("lu", "a"), &nd::lu);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("qr", "a"), &nd::qr);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("eigh", "a"), &nd::eigh);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("svd", "a"), &nd::svd);
 
 	godot::ClassDB::bind_static_method("nd", D_METHOD("sliding_window_view", "array", "window_shape"), &nd::sliding_window_view);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("convolve", "array", "kernel"), &nd::convolve);
@@ -227,14 +272,35 @@ void nd::_bind_methods() {
 	godot::ClassDB::bind_static_method("nd", D_METHOD("default_rng", "seed"), &nd::default_rng, DEFVAL(nullptr));
 
 	godot::ClassDB::bind_static_method("nd", D_METHOD("fft", "v", "axis"), &nd::fft, DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("ifft", "v", "axis"), &nd::ifft, DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("fft2", "v", "axes"), &nd::fft2, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("ifft2", "v", "axes"), &nd::ifft2, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("fftn", "v", "axes"), &nd::fftn, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("ifftn", "v", "axes"), &nd::ifftn, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("rfft", "v", "axis"), &nd::rfft, DEFVAL(-1));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("irfft", "v", "n", "axis"), &nd::irfft, DEFVAL(0), DEFVAL(-1));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("fft_freq", "n", "d"), &nd::fft_freq, DEFVAL(1));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("pad", "v", "pad_width", "pad_mode", "pad_value"), &nd::pad, DEFVAL(nd::PadMode::Constant), DEFVAL(0));
 
 	godot::ClassDB::bind_static_method("nd", D_METHOD("outer", "a", "b"), &nd::outer);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("inner", "a", "b"), &nd::inner);
 
-	godot::ClassDB::bind_static_method("nd", D_METHOD("load", "file_or_buffer"), &nd::load);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("load", "file_or_buffer", "mmap"), &nd::load, DEFVAL(false));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("dumpb", "array"), &nd::dumpb);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("save", "array", "file_or_path", "append"), &nd::save, DEFVAL(false));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("savez", "path", "arrays"), &nd::savez);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("savez_compressed", "path", "arrays"), &nd::savez_compressed);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("load_npz", "path"), &nd::load_npz);
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("set_num_threads", "num_threads"), &nd::set_num_threads);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("get_num_threads"), &nd::get_num_threads);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("set_parallel_threshold", "min_size"), &nd::set_parallel_threshold);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("get_parallel_threshold"), &nd::get_parallel_threshold);
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("begin_arena"), &nd::begin_arena);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("end_arena"), &nd::end_arena);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("clear_arena"), &nd::clear_arena);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("get_arena_stats", "reset"), &nd::get_arena_stats, DEFVAL(false));
 }
 
 template<typename Visitor, typename... Args>
@@ -260,6 +326,24 @@ Ref<NDArray> map_variants_as_arrays_with_target(Visitor&& visitor, const Args&..
 	}
 }
 
+// For functions with two outputs, returned as a pair of arrays.
+template<typename Visitor, typename... Args>
+TypedArray<NDArray> map_variants_as_arrays_with_targets2(Visitor&& visitor, const Args&... args) {
+	try {
+		std::shared_ptr<va::VArray> result0, result1;
+		std::forward<Visitor>(visitor)(&result0, &result1, variant_as_array(args)...);
+
+		auto godot_array = TypedArray<NDArray>();
+		godot_array.resize(2);
+		godot_array[0] = { memnew(NDArray(result0)) };
+		godot_array[1] = { memnew(NDArray(result1)) };
+		return godot_array;
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
 template<typename Visitor, typename VisitorNoaxes, typename... Args>
 inline Ref<NDArray> reduction(Visitor&& visitor, VisitorNoaxes&& visitor_noaxes, const Variant& axes, const Args&... args) {
 	try {
@@ -343,6 +427,11 @@ Ref<NDArray> like_visit(Visitor&& visitor, const Variant& model, nd::DType dtype
         va::func(va::store::default_allocator, target, a->data, b->data, c->data);\
     }, (varray1), (varray2), (varray3))
 
+#define VARRAY_MAP1_TO2(func, varray1) \
+	map_variants_as_arrays_with_targets2([](const va::VArrayTarget& target0, const va::VArrayTarget& target1, const std::shared_ptr<va::VArray>& varray) {\
+        va::func(va::store::default_allocator, target0, target1, varray->data);\
+    }, (varray1))
+
 #define REDUCTION1(func, varray1, axes1) \
 	reduction_new([](const va::VArrayTarget& target, const va::axes_type* axes, const va::VArray& array) {\
 		va::func(va::store::default_allocator, target, array.data, axes);\
@@ -870,6 +959,17 @@ Ref<NDArray> nd::squeeze(const Variant& v) {
 	}
 }
 
+Ref<NDArray> nd::take(const Variant& v, const Variant& indices, const Variant& axis) {
+	ERR_FAIL_COND_V_MSG(axis.get_type() != Variant::NIL && axis.get_type() != Variant::INT, {}, "axis must be null or int");
+	const auto axis_ = axis.get_type() == Variant::NIL ? std::nullopt : std::optional<std::ptrdiff_t> { static_cast<int64_t>(axis) };
+
+	return map_variants_as_arrays(
+		[axis_](const std::shared_ptr<va::VArray>& v, const std::shared_ptr<va::VArray>& indices) {
+			return va::take(va::store::default_allocator, v->data, indices->data, axis_);
+		}, v, indices
+	);
+}
+
 Ref<NDArray> nd::real(const Variant& v) {
 	return map_variants_as_arrays(
 		[](const std::shared_ptr<va::VArray>& v) {
@@ -936,6 +1036,12 @@ Ref<NDArray> nd::remainder(const Variant& a, const Variant& b) {
 	return VARRAY_MAP2(remainder, a, b);
 }
 
+TypedArray<NDArray> nd::divmod(const Variant& a, const Variant& b) {
+	return map_variants_as_arrays_with_targets2([](const va::VArrayTarget& quotient, const va::VArrayTarget& remainder, const std::shared_ptr<va::VArray>& a, const std::shared_ptr<va::VArray>& b) {
+		va::divmod(va::store::default_allocator, quotient, remainder, a->data, b->data);
+	}, a, b);
+}
+
 Ref<NDArray> nd::pow(const Variant& a, const Variant& b) {
 	return VARRAY_MAP2(pow, a, b);
 }
@@ -1036,6 +1142,10 @@ Ref<NDArray> nd::atanh(const Variant& a) {
 	return VARRAY_MAP1(atanh, a);
 }
 
+TypedArray<NDArray> nd::sincos(const Variant& a) {
+	return VARRAY_MAP1_TO2(sincos, a);
+}
+
 Ref<NDArray> nd::sum(const Variant& a, const Variant& axes) {
 	return REDUCTION1(sum, a, axes);
 }
@@ -1052,6 +1162,18 @@ Ref<NDArray> nd::median(const Variant& a, const Variant& axes) {
 	return REDUCTION1(median, a, axes);
 }
 
+Ref<NDArray> nd::quantile(const Variant& a, double q, const Variant& axes) {
+	return reduction_new([q](const va::VArrayTarget& target, const va::axes_type* axes, const va::VArray& array) {
+		va::quantile(va::store::default_allocator, target, array.data, q, axes);
+	}, axes, a);
+}
+
+Ref<NDArray> nd::percentile(const Variant& a, double q, const Variant& axes) {
+	return reduction_new([q](const va::VArrayTarget& target, const va::axes_type* axes, const va::VArray& array) {
+		va::percentile(va::store::default_allocator, target, array.data, q, axes);
+	}, axes, a);
+}
+
 Ref<NDArray> nd::variance(const Variant& a, const Variant& axes) {
 	return REDUCTION1(variance, a, axes);
 }
@@ -1092,12 +1214,174 @@ Ref<NDArray> nd::norm(const Variant& a, const Variant& ord, const Variant& axes)
 	ERR_FAIL_V_MSG({}, "This norm is currently not supported");
 }
 
+void nd::add_at(const Ref<NDArray>& a, const Variant& indices, const Variant& values) {
+	ERR_FAIL_COND_MSG(a.is_null(), "a must be an NDArray");
+
+	try {
+		const auto indices_ = variant_as_array(indices);
+		const auto values_ = variant_as_array(values);
+		a->array->prepare_write();
+		va::add_at(va::store::default_allocator, a->array->data, indices_->data, values_->data);
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+Ref<NDArray> nd::bincount(const Variant& x, const Variant& weights, int64_t minlength) {
+	ERR_FAIL_COND_V_MSG(minlength < 0, {}, "minlength must be non-negative");
+
+	try {
+		const auto x_ = variant_as_array(x);
+		if (weights.get_type() == Variant::NIL) {
+			return { memnew(NDArray(va::bincount(va::store::default_allocator, x_->data, minlength))) };
+		}
+
+		const auto weights_ = variant_as_array(weights);
+		return { memnew(NDArray(va::bincount(va::store::default_allocator, x_->data, weights_->data, minlength))) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+template <typename Reduce>
+Ref<NDArray> segment_reduction(Reduce&& reduce, const Variant& data, const Variant& segment_ids, const Variant& num_segments, bool sorted) {
+	ERR_FAIL_COND_V_MSG(num_segments.get_type() != Variant::NIL && num_segments.get_type() != Variant::INT, {}, "num_segments must be null or int");
+	ERR_FAIL_COND_V_MSG(num_segments.get_type() == Variant::INT && static_cast<int64_t>(num_segments) < 0, {}, "num_segments must be non-negative");
+	const auto num_segments_ = num_segments.get_type() == Variant::NIL ? std::nullopt : std::optional<std::size_t> { static_cast<int64_t>(num_segments) };
+
+	try {
+		const auto data_ = variant_as_array(data);
+		const auto segment_ids_ = variant_as_array(segment_ids);
+		return { memnew(NDArray(reduce(va::store::default_allocator, data_->data, segment_ids_->data, num_segments_, sorted))) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+Ref<NDArray> nd::segment_sum(const Variant& data, const Variant& segment_ids, const Variant& num_segments, bool sorted) {
+	return segment_reduction(va::segment_sum, data, segment_ids, num_segments, sorted);
+}
+
+Ref<NDArray> nd::segment_max(const Variant& data, const Variant& segment_ids, const Variant& num_segments, bool sorted) {
+	return segment_reduction(va::segment_max, data, segment_ids, num_segments, sorted);
+}
+
 Ref<NDArray> nd::count_nonzero(const Variant& a, const Variant& axes) {
 	return reduction_new([](const va::VArrayTarget& target, const va::axes_type* axes, const va::VArray& array) {
 		va::count_nonzero(va::store::default_allocator, target, array.data, axes);
 	}, axes, a);
 }
 
+Ref<NDArray> nd::sort(const Variant& a, int64_t axis) {
+	return map_variants_as_arrays(
+		[axis](const std::shared_ptr<va::VArray>& a) {
+			return va::sort(va::store::default_allocator, a->data, axis);
+		}, a
+	);
+}
+
+Ref<NDArray> nd::argsort(const Variant& a, int64_t axis) {
+	return map_variants_as_arrays(
+		[axis](const std::shared_ptr<va::VArray>& a) {
+			return va::argsort(va::store::default_allocator, a->data, axis);
+		}, a
+	);
+}
+
+Ref<NDArray> nd::partition(const Variant& a, int64_t kth, int64_t axis) {
+	return map_variants_as_arrays(
+		[kth, axis](const std::shared_ptr<va::VArray>& a) {
+			return va::partition(va::store::default_allocator, a->data, kth, axis);
+		}, a
+	);
+}
+
+TypedArray<NDArray> nd::top_k(const Variant& a, int64_t k, int64_t axis, bool largest) {
+	ERR_FAIL_COND_V_MSG(k < 0, {}, "k must be non-negative");
+
+	try {
+		const auto a_ = variant_as_array(a);
+		const auto [values, indices] = va::top_k(va::store::default_allocator, a_->data, static_cast<std::size_t>(k), axis, largest);
+
+		auto godot_array = TypedArray<NDArray>();
+		godot_array.resize(2);
+		godot_array[0] = { memnew(NDArray(values)) };
+		godot_array[1] = { memnew(NDArray(indices)) };
+		return godot_array;
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+Ref<NDArray> nd::unique(const Variant& a) {
+	return map_variants_as_arrays(
+		[](const std::shared_ptr<va::VArray>& a) {
+			return va::unique(va::store::default_allocator, a->data);
+		}, a
+	);
+}
+
+template <typename Scan>
+Ref<NDArray> scan(Scan&& scan, const Variant& a, const Variant& axis) {
+	ERR_FAIL_COND_V_MSG(axis.get_type() != Variant::NIL && axis.get_type() != Variant::INT, {}, "axis must be null or int");
+	const auto axis_ = axis.get_type() == Variant::NIL ? std::nullopt : std::optional<std::ptrdiff_t> { static_cast<int64_t>(axis) };
+
+	return map_variants_as_arrays(
+		[&scan, axis_](const std::shared_ptr<va::VArray>& a) {
+			return scan(va::store::default_allocator, a->data, axis_);
+		}, a
+	);
+}
+
+Ref<NDArray> nd::cumsum(const Variant& a, const Variant& axis) {
+	return scan(va::cumsum, a, axis);
+}
+
+Ref<NDArray> nd::cumprod(const Variant& a, const Variant& axis) {
+	return scan(va::cumprod, a, axis);
+}
+
+Ref<NDArray> nd::cummax(const Variant& a, const Variant& axis) {
+	return scan(va::cummax, a, axis);
+}
+
+Ref<NDArray> nd::diff(const Variant& a, int64_t n, int64_t axis) {
+	ERR_FAIL_COND_V_MSG(n < 0, {}, "n must be non-negative");
+
+	return map_variants_as_arrays(
+		[n, axis](const std::shared_ptr<va::VArray>& a) {
+			return va::diff(va::store::default_allocator, a->data, static_cast<std::size_t>(n), axis);
+		}, a
+	);
+}
+
+template <typename Rolling>
+Ref<NDArray> rolling(Rolling&& rolling, const Variant& a, int64_t window, int64_t axis) {
+	ERR_FAIL_COND_V_MSG(window < 1, {}, "window must be positive");
+
+	return map_variants_as_arrays(
+		[&rolling, window, axis](const std::shared_ptr<va::VArray>& a) {
+			return rolling(va::store::default_allocator, a->data, static_cast<std::size_t>(window), axis);
+		}, a
+	);
+}
+
+Ref<NDArray> nd::rolling_sum(const Variant& a, int64_t window, int64_t axis) {
+	return rolling(va::rolling_sum, a, window, axis);
+}
+
+Ref<NDArray> nd::rolling_mean(const Variant& a, int64_t window, int64_t axis) {
+	return rolling(va::rolling_mean, a, window, axis);
+}
+
+Ref<NDArray> nd::rolling_max(const Variant& a, int64_t window, int64_t axis) {
+	return rolling(va::rolling_max, a, window, axis);
+}
+
 Ref<NDArray> nd::floor(const Variant& a) {
 	return VARRAY_MAP1(floor, a);
 }
@@ -1118,6 +1402,14 @@ Ref<NDArray> nd::rint(const Variant& a) {
 	return VARRAY_MAP1(rint, a);
 }
 
+TypedArray<NDArray> nd::modf(const Variant& a) {
+	return VARRAY_MAP1_TO2(modf, a);
+}
+
+TypedArray<NDArray> nd::frexp(const Variant& a) {
+	return VARRAY_MAP1_TO2(frexp, a);
+}
+
 Ref<NDArray> nd::equal(const Variant& a, const Variant& b) {
 	return VARRAY_MAP2(equal, a, b);
 }
@@ -1176,6 +1468,10 @@ Ref<NDArray> nd::logical_not(const Variant& a) {
 	return VARRAY_MAP1(logical_not, a);
 }
 
+Ref<NDArray> nd::where(const Variant& condition, const Variant& x, const Variant& y) {
+	return VARRAY_MAP3(where, condition, x, y);
+}
+
 Ref<NDArray> nd::all(const Variant& a, const Variant& axes) {
 	return REDUCTION1(all, a, axes);
 }
@@ -1220,12 +1516,134 @@ Ref<NDArray> nd::matmul(const Variant& a, const Variant& b) {
 	return VARRAY_MAP2(matmul, a, b);
 }
 
+Ref<NDArray> nd::tensordot(const Variant& a, const Variant& b, const Variant& axes) {
+	return map_variants_as_arrays_with_target([&axes](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a, const std::shared_ptr<va::VArray>& b) {
+		va::axes_type axes_a, axes_b;
+		if (axes.get_type() == Variant::INT) {
+			// The last N axes of a, and the first N axes of b.
+			const int64_t count = axes;
+			if (count < 0 || count > static_cast<int64_t>(a->dimension()) || count > static_cast<int64_t>(b->dimension())) {
+				throw std::runtime_error("tensordot axes out of range");
+			}
+			for (int64_t i = 0; i < count; ++i) {
+				axes_a.push_back(static_cast<std::ptrdiff_t>(a->dimension()) - count + i);
+				axes_b.push_back(i);
+			}
+		}
+		else {
+			const Array pair = axes;
+			if (pair.size() != 2) throw std::runtime_error("tensordot axes must be an int or a pair of axes");
+			axes_a = variant_to_axes(pair[0]);
+			axes_b = variant_to_axes(pair[1]);
+		}
+		va::tensordot(va::store::default_allocator, target, a->data, b->data, axes_a, axes_b);
+	}, a, b);
+}
+
+Ref<NDArray> nd::einsum(const String& subscripts, const Variant& operands) {
+	try {
+		const auto arrays = variant_to_vector(operands);
+		std::vector<const va::VData*> data;
+		data.reserve(arrays.size());
+		for (const auto& array : arrays) data.push_back(&array->data);
+
+		std::shared_ptr<va::VArray> result;
+		va::einsum(va::store::default_allocator, &result, subscripts.utf8().get_data(), data);
+		return { memnew(NDArray(result)) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
 Ref<NDArray> nd::cross(const Variant& a, const Variant& b, int64_t axisa, int64_t axisb, int64_t axisc) {
 	return map_variants_as_arrays_with_target([axisa, axisb, axisc](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a, const std::shared_ptr<va::VArray>& b) {
 		va::cross(va::store::default_allocator, target, a->data, b->data, axisa, axisb, axisc);
 	}, a, b);
 }
 
+Ref<NDArray> nd::solve(const Variant& a, const Variant& b) {
+	return VARRAY_MAP2(solve, a, b);
+}
+
+Ref<NDArray> nd::inv(const Variant& a) {
+	return VARRAY_MAP1(inv, a);
+}
+
+Ref<NDArray> nd::det(const Variant& a) {
+	return VARRAY_MAP1(det, a);
+}
+
+Ref<NDArray> nd::cholesky(const Variant& a) {
+	return VARRAY_MAP1(cholesky, a);
+}
+
+TypedArray<NDArray> nd::lu(const Variant& a) {
+	try {
+		const auto a_ = variant_as_array(a);
+		const auto [p, l, u] = va::lu(va::store::default_allocator, a_->data);
+
+		auto godot_array = TypedArray<NDArray>();
+		godot_array.resize(3);
+		godot_array[0] = { memnew(NDArray(p)) };
+		godot_array[1] = { memnew(NDArray(l)) };
+		godot_array[2] = { memnew(NDArray(u)) };
+		return godot_array;
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+TypedArray<NDArray> nd::qr(const Variant& a) {
+	try {
+		const auto a_ = variant_as_array(a);
+		const auto [q, r] = va::qr(va::store::default_allocator, a_->data);
+
+		auto godot_array = TypedArray<NDArray>();
+		godot_array.resize(2);
+		godot_array[0] = { memnew(NDArray(q)) };
+		godot_array[1] = { memnew(NDArray(r)) };
+		return godot_array;
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+TypedArray<NDArray> nd::eigh(const Variant& a) {
+	try {
+		const auto a_ = variant_as_array(a);
+		const auto [w, v] = va::eigh(va::store::default_allocator, a_->data);
+
+		auto godot_array = TypedArray<NDArray>();
+		godot_array.resize(2);
+		godot_array[0] = { memnew(NDArray(w)) };
+		godot_array[1] = { memnew(NDArray(v)) };
+		return godot_array;
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+TypedArray<NDArray> nd::svd(const Variant& a) {
+	try {
+		const auto a_ = variant_as_array(a);
+		const auto [u, s, vt] = va::svd(va::store::default_allocator, a_->data);
+
+		auto godot_array = TypedArray<NDArray>();
+		godot_array.resize(3);
+		godot_array[0] = { memnew(NDArray(u)) };
+		godot_array[1] = { memnew(NDArray(s)) };
+		godot_array[2] = { memnew(NDArray(vt)) };
+		return godot_array;
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
 Ref<NDArray> nd::sliding_window_view(const Variant& array, const Variant& window_shape) {
 	try {
 		const auto array_ = variant_as_array(array);
@@ -1260,6 +1678,64 @@ Ref<NDArray> nd::fft(const Variant& array, const int64_t axis) {
 	}, array);
 }
 
+Ref<NDArray> nd::ifft(const Variant& array, const int64_t axis) {
+	return map_variants_as_arrays_with_target([axis](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::ifft(va::store::default_allocator, target, a->data, axis);
+	}, array);
+}
+
+// The given axes, or the last two axes if axes is null.
+va::axes_type variant_to_fft2_axes(const Variant& axes) {
+	if (axes.get_type() == Variant::NIL) return { -2, -1 };
+	return variant_to_axes(axes);
+}
+
+// The given axes, or all axes if axes is null.
+va::axes_type variant_to_fftn_axes(const Variant& axes, const std::size_t dimension) {
+	if (axes.get_type() != Variant::NIL) return variant_to_axes(axes);
+
+	va::axes_type axes_(dimension);
+	std::iota(axes_.begin(), axes_.end(), 0);
+	return axes_;
+}
+
+Ref<NDArray> nd::fft2(const Variant& array, const Variant& axes) {
+	return map_variants_as_arrays_with_target([&axes](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::fftn(va::store::default_allocator, target, a->data, variant_to_fft2_axes(axes));
+	}, array);
+}
+
+Ref<NDArray> nd::ifft2(const Variant& array, const Variant& axes) {
+	return map_variants_as_arrays_with_target([&axes](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::ifftn(va::store::default_allocator, target, a->data, variant_to_fft2_axes(axes));
+	}, array);
+}
+
+Ref<NDArray> nd::fftn(const Variant& array, const Variant& axes) {
+	return map_variants_as_arrays_with_target([&axes](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::fftn(va::store::default_allocator, target, a->data, variant_to_fftn_axes(axes, a->dimension()));
+	}, array);
+}
+
+Ref<NDArray> nd::ifftn(const Variant& array, const Variant& axes) {
+	return map_variants_as_arrays_with_target([&axes](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::ifftn(va::store::default_allocator, target, a->data, variant_to_fftn_axes(axes, a->dimension()));
+	}, array);
+}
+
+Ref<NDArray> nd::rfft(const Variant& array, const int64_t axis) {
+	return map_variants_as_arrays_with_target([axis](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::rfft(va::store::default_allocator, target, a->data, axis);
+	}, array);
+}
+
+Ref<NDArray> nd::irfft(const Variant& array, const int64_t n, const int64_t axis) {
+	return map_variants_as_arrays_with_target([n, axis](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		if (n < 0) throw std::runtime_error("n must not be negative");
+		va::irfft(va::store::default_allocator, target, a->data, static_cast<std::size_t>(n), axis);
+	}, array);
+}
+
 Ref<NDArray> nd::fft_freq(const int64_t n, const double_t freq) {
 	return { memnew(NDArray(va::fft_freq(va::store::default_allocator, n, freq))) };
 }
@@ -1303,7 +1779,7 @@ Ref<NDArray> nd::inner(const Variant& a, const Variant& b) {
 	return VARRAY_MAP2(inner, a, b);
 }
 
-Ref<NDArray> nd::load(const Variant& variant) {
+Ref<NDArray> nd::load(const Variant& variant, const bool mmap) {
 	try {
 		switch (variant.get_type()) {
 			case Variant::PACKED_BYTE_ARRAY: {
@@ -1313,6 +1789,15 @@ Ref<NDArray> nd::load(const Variant& variant) {
 			}
 			case Variant::STRING: {
 				const String path = variant;
+				if (mmap) {
+					// Files packed into the project (e.g. in exports) cannot be mapped; they are read normally instead.
+					const String global_path = ProjectSettings::get_singleton()->globalize_path(path);
+					try {
+						const auto result = va::load_npy_mmap(global_path.utf8().get_data());
+						return { memnew(NDArray(result)) };
+					}
+					catch (std::runtime_error&) {}
+				}
 				const PackedByteArray data = FileAccess::get_file_as_bytes(path);
 				const auto result = va::load_npy(reinterpret_cast<const char*>(data.ptr()), data.size());
 				return { memnew(NDArray(result)) };
@@ -1339,9 +1824,12 @@ PackedByteArray nd::dumpb(const Variant& array) {
 	try {
 		const auto array_ = variant_as_array(array);
 		auto packed = PackedByteArray();
-		const auto string = va::save_npy(array_->data);
-		packed.resize(static_cast<int64_t>(string.size()));
-		std::copy_n(string.data(), string.size(), packed.ptrw());
+		packed.resize(static_cast<int64_t>(va::npy_size(array_->data)));
+		auto* ptr = reinterpret_cast<char*>(packed.ptrw());
+		va::write_npy(array_->data, [&ptr](const char* data, const std::size_t size) {
+			std::copy_n(data, size, ptr);
+			ptr += size;
+		});
 		return packed;
 	}
 	catch (std::runtime_error& error) {
@@ -1349,8 +1837,187 @@ PackedByteArray nd::dumpb(const Variant& array) {
 	}
 }
 
+void nd::save(const Variant& array, const Variant& file_or_path, const bool append) {
+	try {
+		const auto array_ = variant_as_array(array);
+
+		Ref<FileAccess> file;
+		switch (file_or_path.get_type()) {
+			case Variant::STRING:
+			case Variant::STRING_NAME: {
+				const String path = file_or_path;
+				file = FileAccess::open(path, append && FileAccess::file_exists(path) ? FileAccess::READ_WRITE : FileAccess::WRITE);
+				ERR_FAIL_COND_MSG(file.is_null(), "Could not open file for writing.");
+				break;
+			}
+			case Variant::OBJECT: {
+				if (const auto file_access = Object::cast_to<FileAccess>(file_or_path)) {
+					file = Ref<FileAccess>(file_access);
+					break;
+				}
+			}
+			default:
+				ERR_FAIL_MSG("Unsupported type.");
+		}
+
+		// Reused between writes, so that at most one chunk is copied at a time.
+		PackedByteArray chunk;
+		const va::ByteWriter write = [&file, &chunk](const char* data, const std::size_t size) {
+			chunk.resize(static_cast<int64_t>(size));
+			std::copy_n(data, size, chunk.ptrw());
+			file->store_buffer(chunk);
+		};
+
+		if (!append) {
+			va::write_npy(array_->data, write);
+			return;
+		}
+
+		if (file->get_length() == 0) {
+			// New file; the array is its first row.
+			va::write_npy(array_->sliced_data({ xt::newaxis() }), write);
+			return;
+		}
+
+		// Read the header, which is at most 12 bytes before its length is known.
+		file->seek(0);
+		const PackedByteArray preamble = file->get_buffer(12);
+		ERR_FAIL_COND_MSG(preamble.size() < 10, "Not a npy file.");
+		const std::size_t header_size = preamble[6] == 1
+			? 10 + (preamble[8] | preamble[9] << 8)
+			: 12 + (preamble[8] | preamble[9] << 8 | preamble[10] << 16 | static_cast<uint32_t>(preamble[11]) << 24);
+		file->seek(0);
+		const PackedByteArray header_data = file->get_buffer(static_cast<int64_t>(header_size));
+		const va::NpyHeader header = va::read_npy_header(reinterpret_cast<const char*>(header_data.ptr()), header_data.size());
+
+		std::size_t n_bytes = va::size_of_dtype_in_bytes(header.dtype);
+		for (const auto dim : header.shape) n_bytes *= dim;
+		ERR_FAIL_COND_MSG(file->get_length() != header.data_offset + n_bytes, "The npy file size does not match its header.");
+
+		// Check before writing anything, so that the file stays valid on error.
+		const std::string new_header = va::append_npy_header(header, array_->data);
+
+		file->seek_end();
+		va::write_npy_data(array_->data, write);
+		file->seek(0);
+		write(new_header.data(), new_header.size());
+		file->seek_end();
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+void nd::savez(const String& path, const Dictionary& arrays) {
+	try {
+		// Keeps the arrays alive while they are written.
+		std::vector<std::shared_ptr<va::VArray>> varrays;
+		std::vector<std::pair<std::string, va::VData>> named_arrays;
+		const Array keys = arrays.keys();
+		for (int64_t i = 0; i < keys.size(); ++i) {
+			varrays.push_back(variant_as_array(arrays[keys[i]]));
+			named_arrays.emplace_back(String(keys[i]).utf8().get_data(), varrays.back()->data);
+		}
+
+		const Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		ERR_FAIL_COND_MSG(file.is_null(), "Could not open file for writing.");
+
+		PackedByteArray chunk;
+		va::write_npz(named_arrays, [&file, &chunk](const char* data, const std::size_t size) {
+			chunk.resize(static_cast<int64_t>(size));
+			std::copy_n(data, size, chunk.ptrw());
+			file->store_buffer(chunk);
+		});
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+void nd::savez_compressed(const String& path, const Dictionary& arrays) {
+	try {
+		const Array keys = arrays.keys();
+		std::vector<std::shared_ptr<va::VArray>> varrays;
+		for (int64_t i = 0; i < keys.size(); ++i) {
+			varrays.push_back(variant_as_array(arrays[keys[i]]));
+		}
+
+		Ref<ZIPPacker> packer;
+		packer.instantiate();
+		ERR_FAIL_COND_MSG(packer->open(path) != OK, "Could not open file for writing.");
+
+		// Each array is deflated as it is written, one chunk at a time.
+		PackedByteArray chunk;
+		for (int64_t i = 0; i < keys.size(); ++i) {
+			packer->start_file(String(keys[i]) + ".npy");
+			va::write_npy(varrays[i]->data, [&packer, &chunk](const char* data, const std::size_t size) {
+				chunk.resize(static_cast<int64_t>(size));
+				std::copy_n(data, size, chunk.ptrw());
+				packer->write_file(chunk);
+			});
+			packer->close_file();
+		}
+		packer->close();
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+Ref<NDArchive> nd::load_npz(const String& path) {
+	return NDArchive::open(path);
+}
+
+void nd::set_num_threads(const int64_t num_threads) {
+	ERR_FAIL_COND_MSG(num_threads < 0, "num_threads must be non-negative.");
+	va::parallel::set_num_threads(static_cast<std::size_t>(num_threads));
+}
+
+int64_t nd::get_num_threads() {
+	return static_cast<int64_t>(va::parallel::get_num_threads());
+}
+
+void nd::set_parallel_threshold(const int64_t min_size) {
+	ERR_FAIL_COND_MSG(min_size < 0, "min_size must be non-negative.");
+	va::parallel::set_min_size(static_cast<std::size_t>(min_size));
+}
+
+int64_t nd::get_parallel_threshold() {
+	return static_cast<int64_t>(va::parallel::get_min_size());
+}
+
+void nd::begin_arena() {
+	va::store::default_allocator.arena_depth += 1;
+}
+
+void nd::end_arena() {
+	ERR_FAIL_COND_MSG(va::store::default_allocator.arena_depth == 0, "No arena is open.");
+	va::store::default_allocator.arena_depth -= 1;
+}
+
+void nd::clear_arena() {
+	va::store::default_allocator.pooled_allocator.pool->clear();
+}
+
+Dictionary nd::get_arena_stats(const bool reset) {
+	auto& pool = *va::store::default_allocator.pooled_allocator.pool;
+	const auto stats = pool.stats();
+	if (reset) pool.reset_stats();
+
+	Dictionary dict;
+	dict["allocations"] = static_cast<int64_t>(stats.allocations);
+	dict["hits"] = static_cast<int64_t>(stats.hits);
+	dict["misses"] = static_cast<int64_t>(stats.misses);
+	dict["evictions"] = static_cast<int64_t>(stats.evictions);
+	dict["hit_rate"] = stats.allocations == 0 ? 0.0 : static_cast<double_t>(stats.hits) / static_cast<double_t>(stats.allocations);
+	dict["cached_buffers"] = static_cast<int64_t>(stats.cached_buffers);
+	dict["cached_bytes"] = static_cast<int64_t>(stats.cached_bytes);
+	return dict;
+}
+
 #undef VARRAY_MAP1
 #undef VARRAY_MAP2
 #undef VARRAY_MAP3
+#undef VARRAY_MAP1_TO2
 #undef REDUCTION1
 #undef REDUCTION2
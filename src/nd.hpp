@@ -7,9 +7,11 @@
 #include "godot_cpp/classes/object.hpp"       // for Object
 #include "godot_cpp/classes/wrapped.hpp"      // for GDCLASS
 #include "godot_cpp/core/class_db.hpp"        // for ClassDB (ptr only), DEFVAL
+#include "godot_cpp/variant/dictionary.hpp"   // for Dictionary
 #include "godot_cpp/variant/string_name.hpp"  // for StringName
 #include "godot_cpp/variant/variant.hpp"      // for Variant
 #include "godot_cpp/variant/vector4i.hpp"     // for Vector4i
+#include "ndarchive.hpp"                        // for NDArchive
 #include "ndarray.hpp"                          // for NDArray
 #include "ndrandomgenerator.hpp"
 #include "vatensor/varray.hpp"                           // for DType
@@ -117,6 +119,7 @@ public:
 	static TypedArray<NDArray> hsplit(const Variant& v, const Variant& indices_or_section_size);
 	static TypedArray<NDArray> vsplit(const Variant& v, const Variant& indices_or_section_size);
 	static Ref<NDArray> squeeze(const Variant& v);
+	static Ref<NDArray> take(const Variant& v, const Variant& indices, const Variant& axis = nullptr);
 
 	// Complex.
 	static Ref<NDArray> real(const Variant& a);
@@ -135,6 +138,7 @@ public:
 	static Ref<NDArray> multiply(const Variant& a, const Variant& b);
 	static Ref<NDArray> divide(const Variant& a, const Variant& b);
 	static Ref<NDArray> remainder(const Variant& a, const Variant& b);
+	static TypedArray<NDArray> divmod(const Variant& a, const Variant& b);
 	static Ref<NDArray> pow(const Variant& a, const Variant& b);
 
 	static Ref<NDArray> minimum(const Variant& a, const Variant& b);
@@ -167,12 +171,15 @@ public:
 	static Ref<NDArray> asinh(const Variant& a);
 	static Ref<NDArray> acosh(const Variant& a);
 	static Ref<NDArray> atanh(const Variant& a);
+	static TypedArray<NDArray> sincos(const Variant& a);
 
 	// Reductions.
 	static Ref<NDArray> sum(const Variant& a, const Variant& axes);
 	static Ref<NDArray> prod(const Variant& a, const Variant& axes);
 	static Ref<NDArray> mean(const Variant& a, const Variant& axes);
 	static Ref<NDArray> median(const Variant& a, const Variant& axes);
+	static Ref<NDArray> quantile(const Variant& a, double q, const Variant& axes);
+	static Ref<NDArray> percentile(const Variant& a, double q, const Variant& axes);
 	static Ref<NDArray> variance(const Variant& a, const Variant& axes);
 	static Ref<NDArray> standard_deviation(const Variant& a, const Variant& axes);
 	static Ref<NDArray> max(const Variant& a, const Variant& axes);
@@ -180,12 +187,36 @@ public:
 	static Ref<NDArray> norm(const Variant& a, const Variant& ord, const Variant& axes);
 	static Ref<NDArray> count_nonzero(const Variant& a, const Variant& axes);
 
+	// Scatter accumulation.
+	static void add_at(const Ref<NDArray>& a, const Variant& indices, const Variant& values);
+	static Ref<NDArray> bincount(const Variant& x, const Variant& weights = nullptr, int64_t minlength = 0);
+	static Ref<NDArray> segment_sum(const Variant& data, const Variant& segment_ids, const Variant& num_segments = nullptr, bool sorted = false);
+	static Ref<NDArray> segment_max(const Variant& data, const Variant& segment_ids, const Variant& num_segments = nullptr, bool sorted = false);
+
+	// Sorting.
+	static Ref<NDArray> sort(const Variant& a, int64_t axis = -1);
+	static Ref<NDArray> argsort(const Variant& a, int64_t axis = -1);
+	static Ref<NDArray> partition(const Variant& a, int64_t kth, int64_t axis = -1);
+	static TypedArray<NDArray> top_k(const Variant& a, int64_t k, int64_t axis = -1, bool largest = true);
+	static Ref<NDArray> unique(const Variant& a);
+
+	// Scans.
+	static Ref<NDArray> cumsum(const Variant& a, const Variant& axis = nullptr);
+	static Ref<NDArray> cumprod(const Variant& a, const Variant& axis = nullptr);
+	static Ref<NDArray> cummax(const Variant& a, const Variant& axis = nullptr);
+	static Ref<NDArray> diff(const Variant& a, int64_t n = 1, int64_t axis = -1);
+	static Ref<NDArray> rolling_sum(const Variant& a, int64_t window, int64_t axis = -1);
+	static Ref<NDArray> rolling_mean(const Variant& a, int64_t window, int64_t axis = -1);
+	static Ref<NDArray> rolling_max(const Variant& a, int64_t window, int64_t axis = -1);
+
 	// Rounding.
 	static Ref<NDArray> floor(const Variant& a);
 	static Ref<NDArray> ceil(const Variant& a);
 	static Ref<NDArray> round(const Variant& a);
 	static Ref<NDArray> trunc(const Variant& a);
 	static Ref<NDArray> rint(const Variant& a);
+	static TypedArray<NDArray> modf(const Variant& a);
+	static TypedArray<NDArray> frexp(const Variant& a);
 
 	// Comparisons.
 	static Ref<NDArray> equal(const Variant& a, const Variant& b);
@@ -204,6 +235,7 @@ public:
 	static Ref<NDArray> logical_or(const Variant& a, const Variant& b);
 	static Ref<NDArray> logical_xor(const Variant& a, const Variant& b);
 	static Ref<NDArray> logical_not(const Variant& a);
+	static Ref<NDArray> where(const Variant& condition, const Variant& x, const Variant& y);
 	static Ref<NDArray> all(const Variant& a, const Variant& axes);
 	static Ref<NDArray> any(const Variant& a, const Variant& axes);
 
@@ -219,7 +251,17 @@ public:
 	static Ref<NDArray> dot(const Variant& a, const Variant& b);
 	static Ref<NDArray> sum_product(const Variant& a, const Variant& b, const Variant& axes);
 	static Ref<NDArray> matmul(const Variant& a, const Variant& b);
+	static Ref<NDArray> tensordot(const Variant& a, const Variant& b, const Variant& axes = 2);
+	static Ref<NDArray> einsum(const String& subscripts, const Variant& operands);
 	static Ref<NDArray> cross(const Variant& a, const Variant& b, int64_t axisa=-1, int64_t axisb=-1, int64_t axisc=-1);
+	static Ref<NDArray> solve(const Variant& a, const Variant& b);
+	static Ref<NDArray> inv(const Variant& a);
+	static Ref<NDArray> det(const Variant& a);
+	static Ref<NDArray> cholesky(const Variant& a);
+	static TypedArray<NDArray> lu(const Variant& a);
+	static TypedArray<NDArray> qr(const Variant& a);
+	static TypedArray<NDArray> eigh(const Variant& a);
+	static TypedArray<NDArray> svd(const Variant& a);
 
 	// Convolutions.
 	static Ref<NDArray> sliding_window_view(const Variant& array, const Variant& window_shape);
@@ -230,6 +272,13 @@ public:
 
 	// Signal.
 	static Ref<NDArray> fft(const Variant& array, int64_t axis);
+	static Ref<NDArray> ifft(const Variant& array, int64_t axis);
+	static Ref<NDArray> fft2(const Variant& array, const Variant& axes);
+	static Ref<NDArray> ifft2(const Variant& array, const Variant& axes);
+	static Ref<NDArray> fftn(const Variant& array, const Variant& axes);
+	static Ref<NDArray> ifftn(const Variant& array, const Variant& axes);
+	static Ref<NDArray> rfft(const Variant& array, int64_t axis);
+	static Ref<NDArray> irfft(const Variant& array, int64_t n, int64_t axis);
 	static Ref<NDArray> fft_freq(int64_t n, double_t freq);
 	static Ref<NDArray> pad(const Variant& array, const Variant& pad_width, PadMode pad_mode = PadMode::Constant, const Variant& pad_value = 0);
 
@@ -238,8 +287,24 @@ public:
 	static Ref<NDArray> inner(const Variant& a, const Variant& b);
 
 	// IO.
-	static Ref<NDArray> load(const Variant& variant);
+	static Ref<NDArray> load(const Variant& variant, bool mmap);
 	static PackedByteArray dumpb(const Variant& array);
+	static void save(const Variant& array, const Variant& file_or_path, bool append);
+	static void savez(const String& path, const Dictionary& arrays);
+	static void savez_compressed(const String& path, const Dictionary& arrays);
+	static Ref<NDArchive> load_npz(const String& path);
+
+	// Threading.
+	static void set_num_threads(int64_t num_threads);
+	static int64_t get_num_threads();
+	static void set_parallel_threshold(int64_t min_size);
+	static int64_t get_parallel_threshold();
+
+	// Memory.
+	static void begin_arena();
+	static void end_arena();
+	static void clear_arena();
+	static Dictionary get_arena_stats(bool reset = false);
 };
 
 VARIANT_ENUM_CAST(nd::DType);
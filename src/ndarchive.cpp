@@ -0,0 +1,115 @@
+#include "ndarchive.hpp"
+
+#include <stdexcept>                               // for runtime_error
+#include <vatensor/vio.hpp>                        // for load_npy, read_npy_header
+#include "gdconvert/packed_array_store.hpp"        // for VStorePackedByteArray
+#include "godot_cpp/core/class_db.hpp"             // for D_METHOD, ClassDB
+#include "godot_cpp/core/error_macros.hpp"         // for ERR_FAIL_V_MSG
+#include "godot_cpp/core/memory.hpp"               // for memnew
+
+using namespace godot;
+
+void NDArchive::_bind_methods() {
+	godot::ClassDB::bind_method(D_METHOD("keys"), &NDArchive::keys);
+	godot::ClassDB::bind_method(D_METHOD("has", "name"), &NDArchive::has);
+	godot::ClassDB::bind_method(D_METHOD("get_array", "name"), &NDArchive::get_array);
+}
+
+NDArchive::NDArchive() = default;
+
+NDArchive::~NDArchive() {
+	if (reader.is_valid()) reader->close();
+}
+
+String NDArchive::_to_string() const {
+	return "NDArchive(" + String(", ").join(keys()) + ")";
+}
+
+bool NDArchive::_get(const StringName& p_name, Variant& r_ret) const {
+	if (!files.has(p_name)) return false;
+
+	r_ret = get_array(p_name);
+	return true;
+}
+
+PackedStringArray NDArchive::keys() const {
+	const Array names = files.keys();
+	PackedStringArray result;
+	for (int64_t i = 0; i < names.size(); ++i) {
+		result.push_back(names[i]);
+	}
+	return result;
+}
+
+bool NDArchive::has(const String& name) const {
+	return files.has(name);
+}
+
+// Wraps the bytes of a .npy file without copying its data.
+std::shared_ptr<va::VArray> varray_from_npy_bytes(PackedByteArray&& bytes) {
+	const auto* data = reinterpret_cast<const char*>(bytes.ptr());
+	const va::NpyHeader header = va::read_npy_header(data, bytes.size());
+
+	const std::size_t item_size = va::size_of_dtype_in_bytes(header.dtype);
+	std::size_t count = 1;
+	for (const auto dim : header.shape) count *= dim;
+
+	if (header.data_offset % item_size != 0) {
+		// The data is not aligned for its dtype; this needs a copy.
+		return va::load_npy(data, bytes.size());
+	}
+	if (header.data_offset + count * item_size > static_cast<std::size_t>(bytes.size())) {
+		throw std::runtime_error("Npy file is truncated");
+	}
+
+	const auto data_offset = static_cast<std::ptrdiff_t>(header.data_offset / item_size);
+	auto compute = std::visit([data, &header](auto t) -> va::VData {
+		using T = decltype(t);
+		return va::make_compute<T*>(
+			const_cast<T*>(reinterpret_cast<const T*>(data + header.data_offset)),
+			header.shape,
+			va::strides_type {}, // ignored
+			header.fortran_order ? xt::layout_type::column_major : xt::layout_type::row_major
+		);
+	}, va::dtype_to_variant_unchecked(header.dtype));
+
+	auto store = std::make_shared<numdot::VStorePackedByteArray>(std::move(bytes));
+	return std::make_shared<va::VArray>(va::VArray {
+		std::shared_ptr<va::VStore>(store),
+		compute,
+		data_offset
+	});
+}
+
+Ref<NDArray> NDArchive::get_array(const String& name) const {
+	if (loaded.has(name)) return loaded[name];
+	ERR_FAIL_COND_V_MSG(!files.has(name), {}, "Array is not in the archive: " + name);
+
+	try {
+		PackedByteArray bytes = reader->read_file(files[name]);
+		ERR_FAIL_COND_V_MSG(bytes.is_empty(), {}, "Could not read array from the archive: " + name);
+
+		Ref<NDArray> result = { memnew(NDArray(varray_from_npy_bytes(std::move(bytes)))) };
+		loaded[name] = result;
+		return result;
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+Ref<NDArchive> NDArchive::open(const String& path) {
+	Ref<ZIPReader> reader;
+	reader.instantiate();
+	ERR_FAIL_COND_V_MSG(reader->open(path) != OK, {}, "Could not open archive: " + path);
+
+	Ref<NDArchive> archive = { memnew(NDArchive()) };
+	archive->reader = reader;
+	const PackedStringArray file_names = reader->get_files();
+	for (int64_t i = 0; i < file_names.size(); ++i) {
+		const String file = file_names[i];
+		// Like NumPy, the .npy extension is not part of the name.
+		archive->files[file.ends_with(".npy") ? file.substr(0, file.length() - 4) : file] = file;
+	}
+	return archive;
+}
@@ -0,0 +1,46 @@
+#ifndef NUMDOT_NDARCHIVE_H
+#define NUMDOT_NDARCHIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>           // for RefCounted
+#include <godot_cpp/classes/zip_reader.hpp>            // for ZIPReader
+#include <godot_cpp/variant/variant.hpp>               // for Variant
+#include "godot_cpp/classes/ref.hpp"                   // for Ref
+#include "godot_cpp/classes/wrapped.hpp"               // for GDCLASS
+#include "godot_cpp/variant/dictionary.hpp"            // for Dictionary
+#include "godot_cpp/variant/packed_string_array.hpp"   // for PackedStringArray
+#include "ndarray.hpp"
+
+namespace godot {
+	class ClassDB;
+}
+
+using namespace godot;
+
+// An opened .npz archive.
+// Arrays are only read (and decompressed) when they are first accessed.
+class NDArchive : public RefCounted {
+	GDCLASS(NDArchive, RefCounted)
+
+protected:
+	static void _bind_methods();
+	String _to_string() const;
+	bool _get(const StringName& p_name, Variant& r_ret) const;
+
+public:
+	Ref<ZIPReader> reader;
+	// Array name -> file name in the archive.
+	Dictionary files;
+	// Array name -> NDArray, for arrays that were accessed before.
+	mutable Dictionary loaded;
+
+	NDArchive();
+	~NDArchive() override;
+
+	[[nodiscard]] PackedStringArray keys() const;
+	[[nodiscard]] bool has(const String& name) const;
+	[[nodiscard]] Ref<NDArray> get_array(const String& name) const;
+
+	static Ref<NDArchive> open(const String& path);
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include <gdconvert/conversion_ints.hpp>             // for variants_to_axes
 #include <vatensor/linalg.hpp>                       // for sum_product, dot
 #include <vatensor/vassign.hpp>                      // for assign
+#include <vatensor/vsignal.hpp>                      // for fft, ifft, rfft, irfft
 #include <vatensor/xtensor_store.hpp>                        // for abs, add, clip
 #include <vatensor/vcarray.hpp>                        // fill_c_array_flat
 #include "vatensor/vfunc/entrypoints.hpp"
@@ -27,6 +28,7 @@
 #include "godot_cpp/variant/string_name.hpp"       // for StringName
 #include "godot_cpp/variant/variant.hpp"           // for Variant
 #include "nd.hpp"                                    // for nd
+#include "ndexpr.hpp"                                // for variant_as_expr
 #include "vatensor/varray.hpp"                       // for VArray, VArrayTarget
 #include "xtensor/core/xiterator.hpp"                   // for operator==
 #include "xtensor/views/xstrided_view.hpp"               // for xstrided_slice_vector
@@ -91,6 +93,8 @@ void NDArray::_bind_methods() {
 	numdot::bind_vararg_method(numdot::VD_METHOD("get_basis"), &NDArray::get_basis);
 	numdot::bind_vararg_method(numdot::VD_METHOD("get_projection"), &NDArray::get_projection);
 
+	godot::ClassDB::bind_method(D_METHOD("put", "indices", "values", "axis"), &NDArray::put, DEFVAL(nullptr));
+
 	godot::ClassDB::bind_method(D_METHOD("to_bool"), &NDArray::to_bool);
 	godot::ClassDB::bind_method(D_METHOD("to_int"), &NDArray::to_int);
 	godot::ClassDB::bind_method(D_METHOD("to_float"), &NDArray::to_float);
@@ -120,6 +124,8 @@ void NDArray::_bind_methods() {
 
 	godot::ClassDB::bind_method(D_METHOD("to_godot_array"), &NDArray::to_godot_array);
 
+	godot::ClassDB::bind_method(D_METHOD("assign_eval", "expr"), &NDArray::assign_eval);
+
 	godot::ClassDB::bind_method(D_METHOD("assign_conjugate", "a"), &NDArray::assign_conjugate);
 	godot::ClassDB::bind_method(D_METHOD("assign_angle", "a"), &NDArray::assign_angle);
 
@@ -149,6 +155,7 @@ void NDArray::_bind_methods() {
 
 	godot::ClassDB::bind_method(D_METHOD("assign_sin", "a"), &NDArray::assign_sin);
 	godot::ClassDB::bind_method(D_METHOD("assign_cos", "a"), &NDArray::assign_cos);
+	godot::ClassDB::bind_method(D_METHOD("assign_sincos", "cos_target", "a"), &NDArray::assign_sincos);
 	godot::ClassDB::bind_method(D_METHOD("assign_tan", "a"), &NDArray::assign_tan);
 	godot::ClassDB::bind_method(D_METHOD("assign_asin", "a"), &NDArray::assign_asin);
 	godot::ClassDB::bind_method(D_METHOD("assign_acos", "a"), &NDArray::assign_acos);
@@ -188,6 +195,7 @@ void NDArray::_bind_methods() {
 	godot::ClassDB::bind_method(D_METHOD("assign_logical_or", "a", "b"), &NDArray::assign_logical_or);
 	godot::ClassDB::bind_method(D_METHOD("assign_logical_xor", "a", "b"), &NDArray::assign_logical_xor);
 	godot::ClassDB::bind_method(D_METHOD("assign_logical_not", "a"), &NDArray::assign_logical_not);
+	godot::ClassDB::bind_method(D_METHOD("assign_where", "condition", "x", "y"), &NDArray::assign_where);
 	godot::ClassDB::bind_method(D_METHOD("assign_all", "a", "axes"), &NDArray::assign_all, DEFVAL(nullptr));
 	godot::ClassDB::bind_method(D_METHOD("assign_any", "a", "axes"), &NDArray::assign_any, DEFVAL(nullptr));
 
@@ -204,6 +212,11 @@ void NDArray::_bind_methods() {
 	godot::ClassDB::bind_method(D_METHOD("assign_cross", "a", "b", "axisa", "axisb", "axisc"), &NDArray::assign_cross, DEFVAL(-1), DEFVAL(-1), DEFVAL(-1));
 
 	godot::ClassDB::bind_method(D_METHOD("assign_convolve", "array", "kernel"), &NDArray::assign_convolve);
+
+	godot::ClassDB::bind_method(D_METHOD("assign_fft", "a", "axis"), &NDArray::assign_fft, DEFVAL(-1));
+	godot::ClassDB::bind_method(D_METHOD("assign_ifft", "a", "axis"), &NDArray::assign_ifft, DEFVAL(-1));
+	godot::ClassDB::bind_method(D_METHOD("assign_rfft", "a", "axis"), &NDArray::assign_rfft, DEFVAL(-1));
+	godot::ClassDB::bind_method(D_METHOD("assign_irfft", "a", "n", "axis"), &NDArray::assign_irfft, DEFVAL(0), DEFVAL(-1));
 }
 
 NDArray::NDArray() = default;
@@ -367,12 +380,12 @@ Ref<NDArray> NDArray::squeeze() const {
 }
 
 va::VData get_write(va::VArray& array, const xt::xstrided_slice_vector& sv) {
-	// TODO Need to prepare_write()?
+	array.prepare_write();
 	return array.sliced_data(sv);
 }
 
 va::VData get_write(va::VArray& array, const single_axis_slice& sv) {
-	// TODO Need to prepare_write()?
+	array.prepare_write();
 	return array.sliced_data(std::get<0>(sv), std::get<1>(sv));
 }
 
@@ -431,7 +444,7 @@ void NDArray::set(const Variant** args, GDExtensionInt arg_count, GDExtensionCal
 				array->prepare_write();
 
 				const auto value_ = variant_as_array(value);
-				va::set_at_indices(array->data, slice.index_list->data, value_->data);
+				va::set_at_indices(va::store::default_allocator, array->data, slice.index_list->data, value_->data);
 			}
 			else {
 				// Mask
@@ -450,7 +463,7 @@ void NDArray::set(const Variant** args, GDExtensionInt arg_count, GDExtensionCal
 						return;
 					default:
 						const auto value_ = variant_as_array(value);
-						va::set_at_mask(compute, slice.mask->data, value_->data);
+						va::set_at_mask(va::store::default_allocator, compute, slice.mask->data, value_->data);
 						return;
 				}
 			}
@@ -578,6 +591,21 @@ Projection NDArray::get_projection(const Variant** args, GDExtensionInt arg_coun
 	return get_slice_tensor<Projection>(array, args, arg_count, error);
 }
 
+void NDArray::put(const Variant& indices, const Variant& values, const Variant& axis) {
+	ERR_FAIL_COND_MSG(axis.get_type() != Variant::NIL && axis.get_type() != Variant::INT, "axis must be null or int");
+	const auto axis_ = axis.get_type() == Variant::NIL ? std::nullopt : std::optional<std::ptrdiff_t> { static_cast<int64_t>(axis) };
+
+	try {
+		const auto indices_ = variant_as_array(indices);
+		const auto values_ = variant_as_array(values);
+		array->prepare_write();
+		va::put(va::store::default_allocator, array->data, indices_->data, values_->data, axis_);
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
 bool NDArray::to_bool() const { return static_cast<bool>(*this); }
 int64_t NDArray::to_int() const { return static_cast<int64_t>(*this); }
 double_t NDArray::to_float() const { return static_cast<double_t>(*this); }
@@ -828,6 +856,17 @@ inline void reduction_inplace_new(Visitor&& visitor, va::VArray& target, const V
 	}, *this->array, (axes1), (varray1), (varray2));\
 	return {this}
 
+Ref<NDArray> NDArray::assign_eval(const Variant& expr) {
+	try {
+		array->prepare_write();
+		va::expr::evaluate(va::store::default_allocator, &array->data, variant_as_expr(expr));
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+	return {this};
+}
+
 Ref<NDArray> NDArray::assign_conjugate(const Variant& a) {
 	VARRAY_MAP1(conjugate, a);
 }
@@ -925,6 +964,21 @@ Ref<NDArray> NDArray::assign_cos(const Variant& a) {
 	VARRAY_MAP1(cos, a);
 }
 
+Ref<NDArray> NDArray::assign_sincos(const Ref<NDArray>& cos_target, const Variant& a) {
+	ERR_FAIL_COND_V_MSG(cos_target.is_null(), {this}, "cos_target must be an NDArray");
+
+	try {
+		array->prepare_write();
+		cos_target->array->prepare_write();
+		const auto a_ = variant_as_array(a);
+		va::sincos(va::store::default_allocator, &array->data, &cos_target->array->data, a_->data);
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({this}, error.what());
+	}
+	return {this};
+}
+
 Ref<NDArray> NDArray::assign_tan(const Variant& a) {
 	VARRAY_MAP1(tan, a);
 }
@@ -1081,6 +1135,10 @@ Ref<NDArray> NDArray::assign_logical_not(const Variant& a) {
 	VARRAY_MAP1(logical_not, a);
 }
 
+Ref<NDArray> NDArray::assign_where(const Variant& condition, const Variant& x, const Variant& y) {
+	VARRAY_MAP3(where, condition, x, y);
+}
+
 Ref<NDArray> NDArray::assign_all(const Variant& a, const Variant& axes) {
 	REDUCTION1_NEW(all, a, axes);
 }
@@ -1139,6 +1197,35 @@ Ref<NDArray> NDArray::assign_convolve(const Variant& array, const Variant& kerne
 	return {this};
 }
 
+Ref<NDArray> NDArray::assign_fft(const Variant& a, const int64_t axis) {
+	map_variants_as_arrays_inplace([axis](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::fft(va::store::default_allocator, target, a->data, axis);
+	}, *this->array, a);
+	return {this};
+}
+
+Ref<NDArray> NDArray::assign_ifft(const Variant& a, const int64_t axis) {
+	map_variants_as_arrays_inplace([axis](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::ifft(va::store::default_allocator, target, a->data, axis);
+	}, *this->array, a);
+	return {this};
+}
+
+Ref<NDArray> NDArray::assign_rfft(const Variant& a, const int64_t axis) {
+	map_variants_as_arrays_inplace([axis](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		va::rfft(va::store::default_allocator, target, a->data, axis);
+	}, *this->array, a);
+	return {this};
+}
+
+Ref<NDArray> NDArray::assign_irfft(const Variant& a, const int64_t n, const int64_t axis) {
+	map_variants_as_arrays_inplace([n, axis](const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& a) {
+		if (n < 0) throw std::runtime_error("n must not be negative");
+		va::irfft(va::store::default_allocator, target, a->data, static_cast<std::size_t>(n), axis);
+	}, *this->array, a);
+	return {this};
+}
+
 #define CONVERT_TO_SCALAR(type)\
 try {\
 	return static_cast<type>(*array);\
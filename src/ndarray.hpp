@@ -102,6 +102,8 @@ public:
 	Basis get_basis(const Variant** args, GDExtensionInt arg_count, GDExtensionCallError& error);
 	Projection get_projection(const Variant** args, GDExtensionInt arg_count, GDExtensionCallError& error);
 
+	void put(const Variant& indices, const Variant& values, const Variant& axis = nullptr);
+
 	[[nodiscard]] Ref<NDArray> as_type(va::DType dtype) const;
 	[[nodiscard]] Ref<NDArray> copy() const;
 	Ref<NDArray> transpose(const Variant** args, GDExtensionInt arg_count, GDExtensionCallError& error);
@@ -137,6 +139,9 @@ public:
 
 	[[nodiscard]] TypedArray<NDArray> to_godot_array() const;
 
+	// Deferred expressions.
+	Ref<NDArray> assign_eval(const Variant& expr);
+
 	// Complex.
 	Ref<NDArray> assign_conjugate(const Variant& a);
 	Ref<NDArray> assign_angle(const Variant& a);
@@ -169,6 +174,7 @@ public:
 	// Trigonometric functions.
 	Ref<NDArray> assign_sin(const Variant& a);
 	Ref<NDArray> assign_cos(const Variant& a);
+	Ref<NDArray> assign_sincos(const Ref<NDArray>& cos_target, const Variant& a);
 	Ref<NDArray> assign_tan(const Variant& a);
 	Ref<NDArray> assign_asin(const Variant& a);
 	Ref<NDArray> assign_acos(const Variant& a);
@@ -212,6 +218,7 @@ public:
 	Ref<NDArray> assign_logical_or(const Variant& a, const Variant& b);
 	Ref<NDArray> assign_logical_xor(const Variant& a, const Variant& b);
 	Ref<NDArray> assign_logical_not(const Variant& a);
+	Ref<NDArray> assign_where(const Variant& condition, const Variant& x, const Variant& y);
 	Ref<NDArray> assign_all(const Variant& a, const Variant& axes);
 	Ref<NDArray> assign_any(const Variant& a, const Variant& axes);
 
@@ -232,6 +239,12 @@ public:
 	// Convolutions
 	Ref<NDArray> assign_convolve(const Variant& array, const Variant& kernel);
 
+	// Signal.
+	Ref<NDArray> assign_fft(const Variant& a, int64_t axis=-1);
+	Ref<NDArray> assign_ifft(const Variant& a, int64_t axis=-1);
+	Ref<NDArray> assign_rfft(const Variant& a, int64_t axis=-1);
+	Ref<NDArray> assign_irfft(const Variant& a, int64_t n=0, int64_t axis=-1);
+
 	// Conversion to other types.
 	explicit operator bool() const;
 	explicit operator int64_t() const;
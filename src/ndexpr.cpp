@@ -0,0 +1,372 @@
+#include "ndexpr.hpp"
+
+#include <stdexcept>                               // for runtime_error
+#include <vatensor/xtensor_store.hpp>              // for default_allocator
+#include "gdconvert/conversion_array.hpp"          // for variant_as_array
+#include "godot_cpp/core/class_db.hpp"             // for D_METHOD, ClassDB
+#include "godot_cpp/core/error_macros.hpp"         // for ERR_FAIL_V_MSG
+#include "godot_cpp/core/memory.hpp"               // for memnew
+#include "vatensor/vfunc/tables.hpp"               // for tables
+
+using namespace godot;
+
+void NDExpr::_bind_methods() {
+	godot::ClassDB::bind_method(D_METHOD("get_dtype"), &NDExpr::dtype);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "dtype", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_READ_ONLY), "", "get_dtype");
+	godot::ClassDB::bind_method(D_METHOD("get_shape"), &NDExpr::shape);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "shape", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_READ_ONLY), "", "get_shape");
+
+	godot::ClassDB::bind_method(D_METHOD("eval"), &NDExpr::eval);
+
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("of", "a"), &NDExpr::of);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("negative", "a"), &NDExpr::negative);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("sign", "a"), &NDExpr::sign);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("abs", "a"), &NDExpr::abs);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("square", "a"), &NDExpr::square);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("sqrt", "a"), &NDExpr::sqrt);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("exp", "a"), &NDExpr::exp);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("log", "a"), &NDExpr::log);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("rad2deg", "a"), &NDExpr::rad2deg);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("deg2rad", "a"), &NDExpr::deg2rad);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("conjugate", "a"), &NDExpr::conjugate);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("sin", "a"), &NDExpr::sin);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("cos", "a"), &NDExpr::cos);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("tan", "a"), &NDExpr::tan);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("asin", "a"), &NDExpr::asin);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("acos", "a"), &NDExpr::acos);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("atan", "a"), &NDExpr::atan);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("sinh", "a"), &NDExpr::sinh);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("cosh", "a"), &NDExpr::cosh);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("tanh", "a"), &NDExpr::tanh);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("asinh", "a"), &NDExpr::asinh);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("acosh", "a"), &NDExpr::acosh);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("atanh", "a"), &NDExpr::atanh);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("ceil", "a"), &NDExpr::ceil);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("floor", "a"), &NDExpr::floor);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("trunc", "a"), &NDExpr::trunc);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("round", "a"), &NDExpr::round);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("rint", "a"), &NDExpr::rint);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("logical_not", "a"), &NDExpr::logical_not);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("bitwise_not", "a"), &NDExpr::bitwise_not);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("isnan", "a"), &NDExpr::isnan);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("isfinite", "a"), &NDExpr::isfinite);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("isinf", "a"), &NDExpr::isinf);
+
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("add", "a", "b"), &NDExpr::add);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("subtract", "a", "b"), &NDExpr::subtract);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("multiply", "a", "b"), &NDExpr::multiply);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("divide", "a", "b"), &NDExpr::divide);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("remainder", "a", "b"), &NDExpr::remainder);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("pow", "a", "b"), &NDExpr::pow);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("minimum", "a", "b"), &NDExpr::minimum);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("maximum", "a", "b"), &NDExpr::maximum);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("atan2", "a", "b"), &NDExpr::atan2);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("logical_and", "a", "b"), &NDExpr::logical_and);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("logical_or", "a", "b"), &NDExpr::logical_or);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("logical_xor", "a", "b"), &NDExpr::logical_xor);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("bitwise_and", "a", "b"), &NDExpr::bitwise_and);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("bitwise_or", "a", "b"), &NDExpr::bitwise_or);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("bitwise_xor", "a", "b"), &NDExpr::bitwise_xor);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("bitwise_left_shift", "a", "b"), &NDExpr::bitwise_left_shift);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("bitwise_right_shift", "a", "b"), &NDExpr::bitwise_right_shift);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("equal", "a", "b"), &NDExpr::equal);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("not_equal", "a", "b"), &NDExpr::not_equal);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("less", "a", "b"), &NDExpr::less);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("less_equal", "a", "b"), &NDExpr::less_equal);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("greater", "a", "b"), &NDExpr::greater);
+	godot::ClassDB::bind_static_method("NDExpr", D_METHOD("greater_equal", "a", "b"), &NDExpr::greater_equal);
+}
+
+NDExpr::NDExpr() = default;
+
+NDExpr::~NDExpr() = default;
+
+String NDExpr::_to_string() const {
+	if (!node) return "<NDExpr: null>";
+	return "<NDExpr: " + Variant(shape()).stringify() + ">";
+}
+
+va::DType NDExpr::dtype() const {
+	ERR_FAIL_COND_V_MSG(!node, va::DTypeMax, "Expression is empty.");
+	return node->dtype;
+}
+
+PackedInt64Array NDExpr::shape() const {
+	ERR_FAIL_COND_V_MSG(!node, {}, "Expression is empty.");
+
+	PackedInt64Array packed;
+	packed.resize(static_cast<int64_t>(node->shape.size()));
+	std::copy(node->shape.begin(), node->shape.end(), packed.ptrw());
+	return packed;
+}
+
+Ref<NDArray> NDExpr::eval() const {
+	ERR_FAIL_COND_V_MSG(!node, {}, "Expression is empty.");
+
+	try {
+		std::shared_ptr<va::VArray> result;
+		va::expr::evaluate(va::store::default_allocator, &result, node);
+		return { memnew(NDArray(result)) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+va::expr::NodePtr variant_as_expr(const Variant& a) {
+	if (a.get_type() == Variant::OBJECT) {
+		if (const auto expr = Object::cast_to<NDExpr>(a)) {
+			if (!expr->node) throw std::runtime_error("Expression is empty.");
+			return expr->node;
+		}
+	}
+
+	return va::expr::leaf(variant_as_array(a));
+}
+
+template<typename Visitor, typename... Args>
+Ref<NDExpr> map_variants_as_exprs(Visitor&& visitor, const Args&... args) {
+	try {
+		return { memnew(NDExpr(std::forward<Visitor>(visitor)(variant_as_expr(args)...))) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+#define EXPR_MAP1(func, a) \
+	map_variants_as_exprs([](const va::expr::NodePtr& a_) {\
+		return va::expr::unary(va::vfunc::tables::func, a_);\
+	}, (a))
+
+#define EXPR_MAP2(func, a, b) \
+	map_variants_as_exprs([](const va::expr::NodePtr& a_, const va::expr::NodePtr& b_) {\
+		return va::expr::binary(va::vfunc::tables::func, a_, b_);\
+	}, (a), (b))
+
+Ref<NDExpr> NDExpr::of(const Variant& a) {
+	return map_variants_as_exprs([](const va::expr::NodePtr& a_) { return a_; }, a);
+}
+
+Ref<NDExpr> NDExpr::negative(const Variant& a) {
+	return EXPR_MAP1(negative, a);
+}
+
+Ref<NDExpr> NDExpr::sign(const Variant& a) {
+	return EXPR_MAP1(sign, a);
+}
+
+Ref<NDExpr> NDExpr::abs(const Variant& a) {
+	return EXPR_MAP1(abs, a);
+}
+
+Ref<NDExpr> NDExpr::square(const Variant& a) {
+	return EXPR_MAP1(square, a);
+}
+
+Ref<NDExpr> NDExpr::sqrt(const Variant& a) {
+	return EXPR_MAP1(sqrt, a);
+}
+
+Ref<NDExpr> NDExpr::exp(const Variant& a) {
+	return EXPR_MAP1(exp, a);
+}
+
+Ref<NDExpr> NDExpr::log(const Variant& a) {
+	return EXPR_MAP1(log, a);
+}
+
+Ref<NDExpr> NDExpr::rad2deg(const Variant& a) {
+	return EXPR_MAP1(rad2deg, a);
+}
+
+Ref<NDExpr> NDExpr::deg2rad(const Variant& a) {
+	return EXPR_MAP1(deg2rad, a);
+}
+
+Ref<NDExpr> NDExpr::conjugate(const Variant& a) {
+	return EXPR_MAP1(conjugate, a);
+}
+
+Ref<NDExpr> NDExpr::sin(const Variant& a) {
+	return EXPR_MAP1(sin, a);
+}
+
+Ref<NDExpr> NDExpr::cos(const Variant& a) {
+	return EXPR_MAP1(cos, a);
+}
+
+Ref<NDExpr> NDExpr::tan(const Variant& a) {
+	return EXPR_MAP1(tan, a);
+}
+
+Ref<NDExpr> NDExpr::asin(const Variant& a) {
+	return EXPR_MAP1(asin, a);
+}
+
+Ref<NDExpr> NDExpr::acos(const Variant& a) {
+	return EXPR_MAP1(acos, a);
+}
+
+Ref<NDExpr> NDExpr::atan(const Variant& a) {
+	return EXPR_MAP1(atan, a);
+}
+
+Ref<NDExpr> NDExpr::sinh(const Variant& a) {
+	return EXPR_MAP1(sinh, a);
+}
+
+Ref<NDExpr> NDExpr::cosh(const Variant& a) {
+	return EXPR_MAP1(cosh, a);
+}
+
+Ref<NDExpr> NDExpr::tanh(const Variant& a) {
+	return EXPR_MAP1(tanh, a);
+}
+
+Ref<NDExpr> NDExpr::asinh(const Variant& a) {
+	return EXPR_MAP1(asinh, a);
+}
+
+Ref<NDExpr> NDExpr::acosh(const Variant& a) {
+	return EXPR_MAP1(acosh, a);
+}
+
+Ref<NDExpr> NDExpr::atanh(const Variant& a) {
+	return EXPR_MAP1(atanh, a);
+}
+
+Ref<NDExpr> NDExpr::ceil(const Variant& a) {
+	return EXPR_MAP1(ceil, a);
+}
+
+Ref<NDExpr> NDExpr::floor(const Variant& a) {
+	return EXPR_MAP1(floor, a);
+}
+
+Ref<NDExpr> NDExpr::trunc(const Variant& a) {
+	return EXPR_MAP1(trunc, a);
+}
+
+Ref<NDExpr> NDExpr::round(const Variant& a) {
+	return EXPR_MAP1(round, a);
+}
+
+Ref<NDExpr> NDExpr::rint(const Variant& a) {
+	return EXPR_MAP1(rint, a);
+}
+
+Ref<NDExpr> NDExpr::logical_not(const Variant& a) {
+	return EXPR_MAP1(logical_not, a);
+}
+
+Ref<NDExpr> NDExpr::bitwise_not(const Variant& a) {
+	return EXPR_MAP1(bitwise_not, a);
+}
+
+Ref<NDExpr> NDExpr::isnan(const Variant& a) {
+	return EXPR_MAP1(isnan, a);
+}
+
+Ref<NDExpr> NDExpr::isfinite(const Variant& a) {
+	return EXPR_MAP1(isfinite, a);
+}
+
+Ref<NDExpr> NDExpr::isinf(const Variant& a) {
+	return EXPR_MAP1(isinf, a);
+}
+
+Ref<NDExpr> NDExpr::add(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(add, a, b);
+}
+
+Ref<NDExpr> NDExpr::subtract(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(subtract, a, b);
+}
+
+Ref<NDExpr> NDExpr::multiply(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(multiply, a, b);
+}
+
+Ref<NDExpr> NDExpr::divide(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(divide, a, b);
+}
+
+Ref<NDExpr> NDExpr::remainder(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(remainder, a, b);
+}
+
+Ref<NDExpr> NDExpr::pow(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(pow, a, b);
+}
+
+Ref<NDExpr> NDExpr::minimum(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(minimum, a, b);
+}
+
+Ref<NDExpr> NDExpr::maximum(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(maximum, a, b);
+}
+
+Ref<NDExpr> NDExpr::atan2(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(atan2, a, b);
+}
+
+Ref<NDExpr> NDExpr::logical_and(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(logical_and, a, b);
+}
+
+Ref<NDExpr> NDExpr::logical_or(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(logical_or, a, b);
+}
+
+Ref<NDExpr> NDExpr::logical_xor(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(logical_xor, a, b);
+}
+
+Ref<NDExpr> NDExpr::bitwise_and(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(bitwise_and, a, b);
+}
+
+Ref<NDExpr> NDExpr::bitwise_or(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(bitwise_or, a, b);
+}
+
+Ref<NDExpr> NDExpr::bitwise_xor(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(bitwise_xor, a, b);
+}
+
+Ref<NDExpr> NDExpr::bitwise_left_shift(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(bitwise_left_shift, a, b);
+}
+
+Ref<NDExpr> NDExpr::bitwise_right_shift(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(bitwise_right_shift, a, b);
+}
+
+Ref<NDExpr> NDExpr::equal(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(equal, a, b);
+}
+
+Ref<NDExpr> NDExpr::not_equal(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(not_equal, a, b);
+}
+
+Ref<NDExpr> NDExpr::less(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(less, a, b);
+}
+
+Ref<NDExpr> NDExpr::less_equal(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(less_equal, a, b);
+}
+
+Ref<NDExpr> NDExpr::greater(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(greater, a, b);
+}
+
+Ref<NDExpr> NDExpr::greater_equal(const Variant& a, const Variant& b) {
+	return EXPR_MAP2(greater_equal, a, b);
+}
+
+#undef EXPR_MAP1
+#undef EXPR_MAP2
@@ -0,0 +1,101 @@
+#ifndef NUMDOT_NDEXPR_H
+#define NUMDOT_NDEXPR_H
+
+#include <godot_cpp/classes/ref_counted.hpp>           // for RefCounted
+#include <godot_cpp/variant/variant.hpp>               // for Variant
+#include <utility>                                     // for move
+#include "godot_cpp/classes/ref.hpp"                   // for Ref
+#include "godot_cpp/classes/wrapped.hpp"               // for GDCLASS
+#include "godot_cpp/variant/packed_int64_array.hpp"    // for PackedInt64Array
+#include "vatensor/vexpr.hpp"                          // for NodePtr
+#include "ndarray.hpp"
+
+namespace godot {
+	class ClassDB;
+}
+
+using namespace godot;
+
+// A deferred element-wise expression.
+// Operations are only recorded; the graph is evaluated in one fused, blocked pass on eval() or NDArray.assign_eval().
+class NDExpr : public RefCounted {
+	GDCLASS(NDExpr, RefCounted)
+
+protected:
+	static void _bind_methods();
+	String _to_string() const;
+
+public:
+	va::expr::NodePtr node;
+
+	NDExpr();
+	explicit NDExpr(va::expr::NodePtr node) : node(std::move(node)) {};
+	~NDExpr() override;
+
+	[[nodiscard]] va::DType dtype() const;
+	[[nodiscard]] PackedInt64Array shape() const;
+
+	[[nodiscard]] Ref<NDArray> eval() const;
+
+	static Ref<NDExpr> of(const Variant& a);
+	static Ref<NDExpr> negative(const Variant& a);
+	static Ref<NDExpr> sign(const Variant& a);
+	static Ref<NDExpr> abs(const Variant& a);
+	static Ref<NDExpr> square(const Variant& a);
+	static Ref<NDExpr> sqrt(const Variant& a);
+	static Ref<NDExpr> exp(const Variant& a);
+	static Ref<NDExpr> log(const Variant& a);
+	static Ref<NDExpr> rad2deg(const Variant& a);
+	static Ref<NDExpr> deg2rad(const Variant& a);
+	static Ref<NDExpr> conjugate(const Variant& a);
+	static Ref<NDExpr> sin(const Variant& a);
+	static Ref<NDExpr> cos(const Variant& a);
+	static Ref<NDExpr> tan(const Variant& a);
+	static Ref<NDExpr> asin(const Variant& a);
+	static Ref<NDExpr> acos(const Variant& a);
+	static Ref<NDExpr> atan(const Variant& a);
+	static Ref<NDExpr> sinh(const Variant& a);
+	static Ref<NDExpr> cosh(const Variant& a);
+	static Ref<NDExpr> tanh(const Variant& a);
+	static Ref<NDExpr> asinh(const Variant& a);
+	static Ref<NDExpr> acosh(const Variant& a);
+	static Ref<NDExpr> atanh(const Variant& a);
+	static Ref<NDExpr> ceil(const Variant& a);
+	static Ref<NDExpr> floor(const Variant& a);
+	static Ref<NDExpr> trunc(const Variant& a);
+	static Ref<NDExpr> round(const Variant& a);
+	static Ref<NDExpr> rint(const Variant& a);
+	static Ref<NDExpr> logical_not(const Variant& a);
+	static Ref<NDExpr> bitwise_not(const Variant& a);
+	static Ref<NDExpr> isnan(const Variant& a);
+	static Ref<NDExpr> isfinite(const Variant& a);
+	static Ref<NDExpr> isinf(const Variant& a);
+
+	static Ref<NDExpr> add(const Variant& a, const Variant& b);
+	static Ref<NDExpr> subtract(const Variant& a, const Variant& b);
+	static Ref<NDExpr> multiply(const Variant& a, const Variant& b);
+	static Ref<NDExpr> divide(const Variant& a, const Variant& b);
+	static Ref<NDExpr> remainder(const Variant& a, const Variant& b);
+	static Ref<NDExpr> pow(const Variant& a, const Variant& b);
+	static Ref<NDExpr> minimum(const Variant& a, const Variant& b);
+	static Ref<NDExpr> maximum(const Variant& a, const Variant& b);
+	static Ref<NDExpr> atan2(const Variant& a, const Variant& b);
+	static Ref<NDExpr> logical_and(const Variant& a, const Variant& b);
+	static Ref<NDExpr> logical_or(const Variant& a, const Variant& b);
+	static Ref<NDExpr> logical_xor(const Variant& a, const Variant& b);
+	static Ref<NDExpr> bitwise_and(const Variant& a, const Variant& b);
+	static Ref<NDExpr> bitwise_or(const Variant& a, const Variant& b);
+	static Ref<NDExpr> bitwise_xor(const Variant& a, const Variant& b);
+	static Ref<NDExpr> bitwise_left_shift(const Variant& a, const Variant& b);
+	static Ref<NDExpr> bitwise_right_shift(const Variant& a, const Variant& b);
+	static Ref<NDExpr> equal(const Variant& a, const Variant& b);
+	static Ref<NDExpr> not_equal(const Variant& a, const Variant& b);
+	static Ref<NDExpr> less(const Variant& a, const Variant& b);
+	static Ref<NDExpr> less_equal(const Variant& a, const Variant& b);
+	static Ref<NDExpr> greater(const Variant& a, const Variant& b);
+	static Ref<NDExpr> greater_equal(const Variant& a, const Variant& b);
+};
+
+va::expr::NodePtr variant_as_expr(const Variant& a);
+
+#endif
@@ -9,6 +9,8 @@
 #include "ndb.hpp"                         // for ndb
 #include "ndi.hpp"                         // for ndi
 #include "ndarray.hpp"                    // for NDArray
+#include "ndarchive.hpp"                  // for NDArchive
+#include "ndexpr.hpp"                     // for NDExpr
 #include "ndrandomgenerator.hpp"                    // for NDRandomGenerator
 
 using namespace godot;
@@ -23,6 +25,8 @@ void initialize_numdot_module(ModuleInitializationLevel p_level) {
 	GDREGISTER_CLASS(ndi);
 	GDREGISTER_CLASS(ndb);
 	GDREGISTER_CLASS(NDArray);
+	GDREGISTER_CLASS(NDExpr);
+	GDREGISTER_CLASS(NDArchive);
 	GDREGISTER_CLASS(NDRandomGenerator);
 }
 
@@ -0,0 +1,661 @@
+#include "decompose.hpp"
+
+#include <algorithm>                       // for copy, fill_n, min, stable_sort, swap_ranges
+#include <cmath>                           // for abs, copysign, hypot, sqrt
+#include <complex>                         // for complex, conj, norm
+#include <limits>                          // for numeric_limits
+#include <memory>                          // for unique_ptr
+#include <numeric>                         // for iota
+#include <utility>                         // for pair, swap
+#include <vector>                          // for vector
+
+#include "gemm.hpp"
+
+using namespace va::decompose;
+
+namespace {
+	// Large LU decompositions are done in panels of this many columns, so that most of the work is a gemm.
+	constexpr std::size_t lu_block_size = 64;
+	constexpr std::size_t blocked_lu_min_size = 2 * lu_block_size;
+
+	template <typename T>
+	struct real_of { using type = T; };
+	template <typename T>
+	struct real_of<std::complex<T>> { using type = T; };
+
+	template <typename T>
+	T conjugate(const T x) { return x; }
+	template <typename T>
+	std::complex<T> conjugate(const std::complex<T> x) { return std::conj(x); }
+
+	template <typename T>
+	T real_part(const T x) { return x; }
+	template <typename T>
+	T real_part(const std::complex<T> x) { return x.real(); }
+
+	template <typename T>
+	T imag_part(const T) { return T(0); }
+	template <typename T>
+	T imag_part(const std::complex<T> x) { return x.imag(); }
+
+	// |x|^2
+	template <typename T>
+	T abs2(const T x) { return x * x; }
+	template <typename T>
+	T abs2(const std::complex<T> x) { return std::norm(x); }
+
+	// Pivots are chosen by |re| + |im|, like LAPACK, which avoids a square root per element.
+	template <typename T>
+	T magnitude(const T x) { return std::abs(x); }
+	template <typename T>
+	T magnitude(const std::complex<T> x) { return std::abs(x.real()) + std::abs(x.imag()); }
+
+	// Decomposes columns [begin, end) of a, choosing pivots from rows [begin, n). Rows are swapped in full.
+	// The elimination only updates columns before end; the caller updates the rest.
+	template <std::size_t N, typename T>
+	std::size_t lu_panel(T* a, const std::size_t n_, const std::size_t begin, const std::size_t end, std::size_t* pivots) {
+		const std::size_t n = N == 0 ? n_ : N;
+		std::size_t swaps = 0;
+
+		for (std::size_t j = begin; j < end; ++j) {
+			std::size_t pivot = j;
+			auto max = magnitude(a[j * n + j]);
+			for (std::size_t i = j + 1; i < n; ++i) {
+				const auto value = magnitude(a[i * n + j]);
+				if (value > max) {
+					max = value;
+					pivot = i;
+				}
+			}
+
+			pivots[j] = pivot;
+			T* pivot_row = a + j * n;
+			if (pivot != j) {
+				std::swap_ranges(pivot_row, pivot_row + n, a + pivot * n);
+				++swaps;
+			}
+
+			const T diagonal = pivot_row[j];
+			if (diagonal == T(0)) continue;
+
+			for (std::size_t i = j + 1; i < n; ++i) {
+				T* row = a + i * n;
+				const T factor = row[j] / diagonal;
+				row[j] = factor;
+				for (std::size_t c = j + 1; c < end; ++c) row[c] -= factor * pivot_row[c];
+			}
+		}
+
+		return swaps;
+	}
+
+	// Right-looking blocked LU: After each panel, the rows to its right are solved with the panel's L,
+	// and the remaining matrix is updated with one gemm.
+	template <typename T>
+	std::size_t lu_blocked(T* a, const std::size_t n, std::size_t* pivots) {
+		std::size_t swaps = 0;
+		// Sized for the first update, which is the largest.
+		const std::unique_ptr<T[]> update(new T[(n - lu_block_size) * (n - lu_block_size)]);
+
+		for (std::size_t begin = 0; begin < n; begin += lu_block_size) {
+			const std::size_t end = std::min(n, begin + lu_block_size);
+			swaps += lu_panel<0>(a, n, begin, end, pivots);
+			if (end == n) break;
+
+			// U12 = L11^-1 A12
+			for (std::size_t j = begin; j < end; ++j) {
+				const T* row_j = a + j * n;
+				for (std::size_t i = j + 1; i < end; ++i) {
+					T* row_i = a + i * n;
+					const T factor = row_i[j];
+					for (std::size_t c = end; c < n; ++c) row_i[c] -= factor * row_j[c];
+				}
+			}
+
+			// A22 -= L21 U12
+			const std::size_t rest = n - end;
+			va::gemm::gemm<T>(
+				rest, rest, end - begin,
+				va::gemm::Matrix<const T> { a + end * n + begin, static_cast<std::ptrdiff_t>(n), 1 },
+				va::gemm::Matrix<const T> { a + begin * n + end, static_cast<std::ptrdiff_t>(n), 1 },
+				va::gemm::Matrix<T> { update.get(), static_cast<std::ptrdiff_t>(rest), 1 }
+			);
+			for (std::size_t i = 0; i < rest; ++i) {
+				T* row = a + (end + i) * n + end;
+				const T* update_row = update.get() + i * rest;
+				for (std::size_t c = 0; c < rest; ++c) row[c] -= update_row[c];
+			}
+		}
+
+		return swaps;
+	}
+}
+
+template <std::size_t N, typename T>
+std::size_t Square<N, T>::lu(T* a, const std::size_t n, std::size_t* pivots) {
+	if constexpr (N == 0) {
+		if (n >= blocked_lu_min_size) return lu_blocked(a, n, pivots);
+	}
+	return lu_panel<N>(a, n, 0, N == 0 ? n : N, pivots);
+}
+
+template <std::size_t N, typename T>
+bool Square<N, T>::lu_solve(const T* lu, const std::size_t* pivots, const std::size_t n_, T* b, const std::size_t k) {
+	const std::size_t n = N == 0 ? n_ : N;
+
+	for (std::size_t i = 0; i < n; ++i) {
+		if (lu[i * n + i] == T(0)) return false;
+	}
+
+	for (std::size_t i = 0; i < n; ++i) {
+		if (pivots[i] != i) std::swap_ranges(b + i * k, b + i * k + k, b + pivots[i] * k);
+	}
+
+	// L y = P^T b
+	for (std::size_t i = 1; i < n; ++i) {
+		T* row = b + i * k;
+		for (std::size_t j = 0; j < i; ++j) {
+			const T factor = lu[i * n + j];
+			const T* row_j = b + j * k;
+			for (std::size_t c = 0; c < k; ++c) row[c] -= factor * row_j[c];
+		}
+	}
+
+	// U x = y
+	for (std::size_t i = n; i-- > 0;) {
+		T* row = b + i * k;
+		for (std::size_t j = i + 1; j < n; ++j) {
+			const T factor = lu[i * n + j];
+			const T* row_j = b + j * k;
+			for (std::size_t c = 0; c < k; ++c) row[c] -= factor * row_j[c];
+		}
+		const T diagonal = lu[i * n + i];
+		for (std::size_t c = 0; c < k; ++c) row[c] /= diagonal;
+	}
+
+	return true;
+}
+
+template <std::size_t N, typename T>
+T Square<N, T>::lu_det(const T* lu, const std::size_t n_, const std::size_t swaps) {
+	const std::size_t n = N == 0 ? n_ : N;
+
+	T det = swaps % 2 == 0 ? T(1) : T(-1);
+	for (std::size_t i = 0; i < n; ++i) det *= lu[i * n + i];
+	return det;
+}
+
+template <std::size_t N, typename T>
+bool Square<N, T>::cholesky(T* a, const std::size_t n_) {
+	using R = typename real_of<T>::type;
+	const std::size_t n = N == 0 ? n_ : N;
+
+	for (std::size_t j = 0; j < n; ++j) {
+		T* row_j = a + j * n;
+
+		R diagonal = real_part(row_j[j]);
+		for (std::size_t p = 0; p < j; ++p) diagonal -= abs2(row_j[p]);
+		// Also catches NaN.
+		if (!(diagonal > R(0))) return false;
+
+		const R l_jj = std::sqrt(diagonal);
+		row_j[j] = l_jj;
+
+		for (std::size_t i = j + 1; i < n; ++i) {
+			T* row_i = a + i * n;
+			T sum = row_i[j];
+			for (std::size_t p = 0; p < j; ++p) sum -= row_i[p] * conjugate(row_j[p]);
+			row_i[j] = sum / l_jj;
+		}
+
+		std::fill_n(row_j + j + 1, n - j - 1, T(0));
+	}
+
+	return true;
+}
+
+template <typename T>
+void va::decompose::qr(T* a, const std::size_t m, const std::size_t n, T* q, T* r, T* work) {
+	using R = typename real_of<T>::type;
+	const std::size_t k = std::min(m, n);
+
+	// Column j is reduced by H_j = I - tau_j v v^H, where v[j] = 1, and the rest of v is stored below the diagonal.
+	// Rows are updated as a whole, so that memory is read in order; w accumulates v^H A for each column.
+	T* tau = work;
+	T* w = work + k;
+
+	for (std::size_t j = 0; j < k; ++j) {
+		const T alpha = a[j * n + j];
+		R tail_norm2 = 0;
+		for (std::size_t i = j + 1; i < m; ++i) tail_norm2 += abs2(a[i * n + j]);
+
+		if (tail_norm2 == R(0) && imag_part(alpha) == R(0)) {
+			tau[j] = T(0);
+			continue;
+		}
+
+		const R beta = -std::copysign(std::sqrt(abs2(alpha) + tail_norm2), real_part(alpha));
+		tau[j] = (T(beta) - alpha) / T(beta);
+		const T scale = T(1) / (alpha - T(beta));
+		for (std::size_t i = j + 1; i < m; ++i) a[i * n + j] *= scale;
+		a[j * n + j] = T(beta);
+
+		// A = H_j^H A, on the columns right of j.
+		const T tau_conj = conjugate(tau[j]);
+		for (std::size_t c = j + 1; c < n; ++c) w[c] = a[j * n + c];
+		for (std::size_t i = j + 1; i < m; ++i) {
+			const T v = conjugate(a[i * n + j]);
+			const T* row = a + i * n;
+			for (std::size_t c = j + 1; c < n; ++c) w[c] += v * row[c];
+		}
+		for (std::size_t c = j + 1; c < n; ++c) {
+			w[c] *= tau_conj;
+			a[j * n + c] -= w[c];
+		}
+		for (std::size_t i = j + 1; i < m; ++i) {
+			const T v = a[i * n + j];
+			T* row = a + i * n;
+			for (std::size_t c = j + 1; c < n; ++c) row[c] -= w[c] * v;
+		}
+	}
+
+	for (std::size_t i = 0; i < k; ++i) {
+		std::fill_n(r + i * n, i, T(0));
+		std::copy(a + i * n + i, a + i * n + n, r + i * n + i);
+	}
+
+	// Q = H_0 ... H_(k-1) I, applied from the right-most reflection, which only touches the bottom right corner.
+	for (std::size_t i = 0; i < m; ++i) {
+		for (std::size_t c = 0; c < k; ++c) q[i * k + c] = i == c ? T(1) : T(0);
+	}
+	for (std::size_t j = k; j-- > 0;) {
+		if (tau[j] == T(0)) continue;
+
+		for (std::size_t c = j; c < k; ++c) w[c] = q[j * k + c];
+		for (std::size_t i = j + 1; i < m; ++i) {
+			const T v = conjugate(a[i * n + j]);
+			const T* row = q + i * k;
+			for (std::size_t c = j; c < k; ++c) w[c] += v * row[c];
+		}
+		for (std::size_t c = j; c < k; ++c) {
+			w[c] *= tau[j];
+			q[j * k + c] -= w[c];
+		}
+		for (std::size_t i = j + 1; i < m; ++i) {
+			const T v = a[i * n + j];
+			T* row = q + i * k;
+			for (std::size_t c = j; c < k; ++c) row[c] -= w[c] * v;
+		}
+	}
+}
+
+namespace {
+	// Rotations stop when the off-diagonal elements are this many epsilons smaller than the diagonal.
+	// Jacobi methods converge quadratically, so this is rarely reached.
+	constexpr std::size_t max_jacobi_sweeps = 64;
+	// Implicit QR steps per eigenvalue, before the tridiagonal iteration gives up.
+	constexpr std::size_t max_qr_steps = 30;
+
+	template <typename T>
+	void set_identity(T* a, const std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) {
+			for (std::size_t j = 0; j < n; ++j) a[i * n + j] = i == j ? T(1) : T(0);
+		}
+	}
+
+	// Copies the lower triangle of a to the upper triangle.
+	template <typename T>
+	void symmetrize_lower(T* a, const std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) {
+			for (std::size_t j = i + 1; j < n; ++j) a[i * n + j] = a[j * n + i];
+		}
+	}
+
+	// (c, s) of the Jacobi rotation J = [[c, s], [-s, c]] such that J^T [[app, apq], [apq, aqq]] J is diagonal.
+	// Of the two solutions, this is the one with the smaller angle.
+	template <typename T>
+	std::pair<T, T> jacobi_rotation(const T app, const T apq, const T aqq) {
+		const T theta = (aqq - app) / (2 * apq);
+		const T t = std::copysign(T(1), theta) / (std::abs(theta) + std::hypot(theta, T(1)));
+		const T c = 1 / std::hypot(t, T(1));
+		return { c, t * c };
+	}
+
+	// x, y = c x - s y, s x + c y, for count elements of x and y, which are stride apart.
+	template <typename T>
+	void rotate(T* x, T* y, const std::size_t count, const std::ptrdiff_t stride, const T c, const T s) {
+		for (std::size_t i = 0; i < count; ++i) {
+			const T xi = x[static_cast<std::ptrdiff_t>(i) * stride];
+			const T yi = y[static_cast<std::ptrdiff_t>(i) * stride];
+			x[static_cast<std::ptrdiff_t>(i) * stride] = c * xi - s * yi;
+			y[static_cast<std::ptrdiff_t>(i) * stride] = s * xi + c * yi;
+		}
+	}
+
+	// Sorts w ascending, and the columns of v (n x n) along with it.
+	template <typename T>
+	void sort_eigenpairs(T* w, T* v, const std::size_t n) {
+		for (std::size_t i = 0; i + 1 < n; ++i) {
+			std::size_t min = i;
+			for (std::size_t j = i + 1; j < n; ++j) {
+				if (w[j] < w[min]) min = j;
+			}
+			if (min == i) continue;
+
+			std::swap(w[i], w[min]);
+			for (std::size_t row = 0; row < n; ++row) std::swap(v[row * n + i], v[row * n + min]);
+		}
+	}
+
+	// One implicit symmetric QR step with a Wilkinson shift on the unreduced block [l, h] of the tridiagonal matrix (d, e).
+	// The rotations chase a bulge down the diagonal, and are applied to the columns of v (n x n).
+	template <typename T>
+	void tridiagonal_qr_step(T* d, T* e, T* v, const std::size_t n, const std::size_t l, const std::size_t h) {
+		// The eigenvalue of the trailing 2 x 2 block that is closer to d[h].
+		const T delta = (d[h - 1] - d[h]) / 2;
+		const T mu = d[h] - e[h - 1] * e[h - 1] / (delta + std::copysign(std::hypot(delta, e[h - 1]), delta));
+
+		T x = d[l] - mu;
+		T z = e[l];
+		for (std::size_t k = l; k < h; ++k) {
+			// Rotates rows and columns k, k + 1 by [[c, -s], [s, c]], which zeroes z against x.
+			const T r = std::hypot(x, z);
+			const T c = r == 0 ? T(1) : x / r;
+			const T s = r == 0 ? T(0) : -z / r;
+			if (k > l) e[k - 1] = r;
+
+			const T dk = d[k];
+			const T dk1 = d[k + 1];
+			const T ek = e[k];
+			d[k] = c * c * dk - 2 * c * s * ek + s * s * dk1;
+			d[k + 1] = s * s * dk + 2 * c * s * ek + c * c * dk1;
+			e[k] = c * s * (dk - dk1) + (c * c - s * s) * ek;
+
+			if (k + 1 < h) {
+				// The bulge at (k, k + 2).
+				x = e[k];
+				z = -s * e[k + 1];
+				e[k + 1] *= c;
+			}
+
+			rotate(v + k, v + k + 1, n, static_cast<std::ptrdiff_t>(n), c, s);
+		}
+	}
+}
+
+template <std::size_t N, typename T>
+void Symmetric<N, T>::jacobi(T* a, const std::size_t n_, T* w, T* v) {
+	const std::size_t n = N == 0 ? n_ : N;
+	constexpr T epsilon = std::numeric_limits<T>::epsilon();
+
+	symmetrize_lower(a, n);
+	set_identity(v, n);
+
+	for (std::size_t sweep = 0; sweep < max_jacobi_sweeps; ++sweep) {
+		T off_diagonal = 0;
+		T diagonal = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			diagonal += a[i * n + i] * a[i * n + i];
+			for (std::size_t j = i + 1; j < n; ++j) off_diagonal += a[i * n + j] * a[i * n + j];
+		}
+		if (off_diagonal <= epsilon * epsilon * diagonal) break;
+
+		for (std::size_t p = 0; p < n; ++p) {
+			for (std::size_t q = p + 1; q < n; ++q) {
+				const T app = a[p * n + p];
+				const T apq = a[p * n + q];
+				const T aqq = a[q * n + q];
+				if (std::abs(apq) <= epsilon * std::sqrt(std::abs(app * aqq))) {
+					// Negligible, and would only cause rotations by rounding errors.
+					a[p * n + q] = a[q * n + p] = T(0);
+					continue;
+				}
+
+				// A = J^T A J, V = V J.
+				const auto [c, s] = jacobi_rotation(app, apq, aqq);
+				rotate(a + p, a + q, n, static_cast<std::ptrdiff_t>(n), c, s);
+				rotate(a + p * n, a + q * n, n, 1, c, s);
+				rotate(v + p, v + q, n, static_cast<std::ptrdiff_t>(n), c, s);
+				a[p * n + q] = a[q * n + p] = T(0);
+			}
+		}
+	}
+
+	for (std::size_t i = 0; i < n; ++i) w[i] = a[i * n + i];
+	sort_eigenpairs(w, v, n);
+}
+
+template <typename T>
+bool va::decompose::eigh_tridiagonal(T* a, const std::size_t n, T* w, T* v, T* work) {
+	constexpr T epsilon = std::numeric_limits<T>::epsilon();
+	T* e = work;
+	T* p = work + n;
+
+	symmetrize_lower(a, n);
+	set_identity(v, n);
+
+	// A = H_k A H_k for k < n - 2, where H_k = I - beta u u^T zeroes column k below the subdiagonal.
+	// u is stored in column k, below the diagonal, and the subdiagonal in e.
+	for (std::size_t k = 0; k + 2 < n; ++k) {
+		const std::size_t m = n - k - 1;
+		T* u = a + (k + 1) * n + k;
+		const auto u_at = [u, n](const std::size_t i) -> T& { return u[i * n]; };
+
+		T tail_norm2 = 0;
+		for (std::size_t i = 1; i < m; ++i) tail_norm2 += u_at(i) * u_at(i);
+		if (tail_norm2 == 0) {
+			e[k] = u_at(0);
+			continue;
+		}
+
+		const T alpha = -std::copysign(std::sqrt(u_at(0) * u_at(0) + tail_norm2), u_at(0));
+		u_at(0) -= alpha;
+		const T beta = 2 / (u_at(0) * u_at(0) + tail_norm2);
+		e[k] = alpha;
+
+		// S = S - u q^T - q u^T on the trailing m x m block S, with p = beta S u and q = p - (beta / 2) (p^T u) u.
+		T* s = a + (k + 1) * n + k + 1;
+		T pu = 0;
+		for (std::size_t i = 0; i < m; ++i) {
+			T sum = 0;
+			for (std::size_t j = 0; j < m; ++j) sum += s[i * n + j] * u_at(j);
+			p[i] = beta * sum;
+			pu += p[i] * u_at(i);
+		}
+		const T K = beta / 2 * pu;
+		for (std::size_t i = 0; i < m; ++i) p[i] -= K * u_at(i);
+		for (std::size_t i = 0; i < m; ++i) {
+			for (std::size_t j = 0; j < m; ++j) s[i * n + j] -= u_at(i) * p[j] + p[i] * u_at(j);
+		}
+
+		// V = V H_k.
+		for (std::size_t row = 0; row < n; ++row) {
+			T* v_row = v + row * n + k + 1;
+			T sum = 0;
+			for (std::size_t i = 0; i < m; ++i) sum += v_row[i] * u_at(i);
+			sum *= beta;
+			for (std::size_t i = 0; i < m; ++i) v_row[i] -= sum * u_at(i);
+		}
+	}
+	if (n >= 2) e[n - 2] = a[(n - 1) * n + n - 2];
+	for (std::size_t i = 0; i < n; ++i) w[i] = a[i * n + i];
+
+	// QR steps on the trailing unreduced block, until all subdiagonal elements are negligible.
+	std::size_t steps = 0;
+	for (std::size_t end = n; end > 1;) {
+		const auto is_negligible = [w, e, epsilon](const std::size_t i) {
+			return std::abs(e[i]) <= epsilon * (std::abs(w[i]) + std::abs(w[i + 1]));
+		};
+
+		const std::size_t h = end - 1;
+		if (is_negligible(h - 1)) {
+			e[h - 1] = 0;
+			--end;
+			continue;
+		}
+
+		std::size_t l = h - 1;
+		while (l > 0 && !is_negligible(l - 1)) --l;
+		if (l > 0) e[l - 1] = 0;
+
+		if (++steps > max_qr_steps * n) return false;
+		tridiagonal_qr_step(w, e, v, n, l, h);
+	}
+
+	sort_eigenpairs(w, v, n);
+	return true;
+}
+
+template <typename T>
+void va::decompose::svd(const T* a, const std::size_t m, const std::size_t n, T* u, T* s, T* vt, T* work) {
+	constexpr T epsilon = std::numeric_limits<T>::epsilon();
+	const std::size_t k = std::min(m, n);
+
+	// The k columns (if m >= n) or rows (otherwise) of a are rotated until they are orthogonal.
+	// Then, their norms are the singular values, and the rotations make up the other factor.
+	const bool by_columns = m >= n;
+	const std::size_t length = by_columns ? m : n;
+	const std::ptrdiff_t vector_stride = by_columns ? 1 : static_cast<std::ptrdiff_t>(n);
+	const std::ptrdiff_t element_stride = by_columns ? static_cast<std::ptrdiff_t>(n) : 1;
+
+	T* rotations = work;
+	T* vectors = work + k * k;
+	std::copy(a, a + m * n, vectors);
+	set_identity(rotations, k);
+
+	for (std::size_t sweep = 0; sweep < max_jacobi_sweeps; ++sweep) {
+		bool is_rotated = false;
+
+		for (std::size_t p = 0; p < k; ++p) {
+			for (std::size_t q = p + 1; q < k; ++q) {
+				T* x = vectors + static_cast<std::ptrdiff_t>(p) * vector_stride;
+				T* y = vectors + static_cast<std::ptrdiff_t>(q) * vector_stride;
+
+				// The Gram matrix [[alpha, gamma], [gamma, beta]] of x and y.
+				T alpha = 0;
+				T beta = 0;
+				T gamma = 0;
+				for (std::size_t i = 0; i < length; ++i) {
+					const T xi = x[static_cast<std::ptrdiff_t>(i) * element_stride];
+					const T yi = y[static_cast<std::ptrdiff_t>(i) * element_stride];
+					alpha += xi * xi;
+					beta += yi * yi;
+					gamma += xi * yi;
+				}
+				if (std::abs(gamma) <= epsilon * std::sqrt(alpha * beta)) continue;
+
+				is_rotated = true;
+				const auto [c, s_] = jacobi_rotation(alpha, gamma, beta);
+				rotate(x, y, length, element_stride, c, s_);
+				rotate(rotations + p, rotations + q, k, static_cast<std::ptrdiff_t>(k), c, s_);
+			}
+		}
+
+		if (!is_rotated) break;
+	}
+
+	std::vector<std::size_t> order(k);
+	for (std::size_t j = 0; j < k; ++j) {
+		T norm2 = 0;
+		const T* x = vectors + static_cast<std::ptrdiff_t>(j) * vector_stride;
+		for (std::size_t i = 0; i < length; ++i) norm2 += x[static_cast<std::ptrdiff_t>(i) * element_stride] * x[static_cast<std::ptrdiff_t>(i) * element_stride];
+		s[j] = std::sqrt(norm2);
+	}
+	std::iota(order.begin(), order.end(), std::size_t { 0 });
+	std::stable_sort(order.begin(), order.end(), [s](const std::size_t i, const std::size_t j) { return s[i] > s[j]; });
+
+	// The normalized vectors go to the columns of u or the rows of vt, and the rotations to the other.
+	T* normalized_out = by_columns ? u : vt;
+	const std::ptrdiff_t normalized_element_stride = by_columns ? static_cast<std::ptrdiff_t>(k) : 1;
+	const std::ptrdiff_t normalized_vector_stride = by_columns ? 1 : static_cast<std::ptrdiff_t>(n);
+	T* rotations_out = by_columns ? vt : u;
+	const std::ptrdiff_t rotations_element_stride = by_columns ? 1 : static_cast<std::ptrdiff_t>(k);
+	const std::ptrdiff_t rotations_vector_stride = by_columns ? static_cast<std::ptrdiff_t>(n) : 1;
+	const auto normalized_at = [=](const std::size_t vector, const std::size_t i) -> T& {
+		return normalized_out[static_cast<std::ptrdiff_t>(vector) * normalized_vector_stride + static_cast<std::ptrdiff_t>(i) * normalized_element_stride];
+	};
+	const auto rotations_at = [=](const std::size_t vector, const std::size_t i) -> T& {
+		return rotations_out[static_cast<std::ptrdiff_t>(vector) * rotations_vector_stride + static_cast<std::ptrdiff_t>(i) * rotations_element_stride];
+	};
+
+	std::vector<T> sorted_s(k);
+	for (std::size_t j = 0; j < k; ++j) {
+		const std::size_t source = order[j];
+		sorted_s[j] = s[source];
+
+		for (std::size_t i = 0; i < k; ++i) rotations_at(j, i) = rotations[i * k + source];
+
+		const T* x = vectors + static_cast<std::ptrdiff_t>(source) * vector_stride;
+		if (s[source] != 0) {
+			for (std::size_t i = 0; i < length; ++i) normalized_at(j, i) = x[static_cast<std::ptrdiff_t>(i) * element_stride] / s[source];
+			continue;
+		}
+
+		// The vector of a zero singular value is any unit vector orthogonal to the previous ones.
+		// Of the standard basis vectors, the one that is furthest from their span is projected out of it (twice, for accuracy).
+		const auto project_out = [&](const std::size_t j_) {
+			for (std::size_t pass = 0; pass < 2; ++pass) {
+				for (std::size_t other = 0; other < j; ++other) {
+					T dot = 0;
+					for (std::size_t i = 0; i < length; ++i) dot += normalized_at(other, i) * normalized_at(j_, i);
+					for (std::size_t i = 0; i < length; ++i) normalized_at(j_, i) -= dot * normalized_at(other, i);
+				}
+			}
+			T norm2 = 0;
+			for (std::size_t i = 0; i < length; ++i) norm2 += normalized_at(j_, i) * normalized_at(j_, i);
+			return norm2;
+		};
+
+		std::size_t best = 0;
+		T best_norm2 = -1;
+		for (std::size_t candidate = 0; candidate < length; ++candidate) {
+			for (std::size_t i = 0; i < length; ++i) normalized_at(j, i) = i == candidate ? T(1) : T(0);
+			const T norm2 = project_out(j);
+			if (norm2 > best_norm2) {
+				best_norm2 = norm2;
+				best = candidate;
+			}
+		}
+		for (std::size_t i = 0; i < length; ++i) normalized_at(j, i) = i == best ? T(1) : T(0);
+		const T norm = std::sqrt(project_out(j));
+		for (std::size_t i = 0; i < length; ++i) normalized_at(j, i) /= norm;
+	}
+	std::copy(sorted_s.begin(), sorted_s.end(), s);
+}
+
+template struct va::decompose::Square<0, float>;
+template struct va::decompose::Square<2, float>;
+template struct va::decompose::Square<3, float>;
+template struct va::decompose::Square<4, float>;
+template struct va::decompose::Square<0, double>;
+template struct va::decompose::Square<2, double>;
+template struct va::decompose::Square<3, double>;
+template struct va::decompose::Square<4, double>;
+template struct va::decompose::Square<0, std::complex<float>>;
+template struct va::decompose::Square<2, std::complex<float>>;
+template struct va::decompose::Square<3, std::complex<float>>;
+template struct va::decompose::Square<4, std::complex<float>>;
+template struct va::decompose::Square<0, std::complex<double>>;
+template struct va::decompose::Square<2, std::complex<double>>;
+template struct va::decompose::Square<3, std::complex<double>>;
+template struct va::decompose::Square<4, std::complex<double>>;
+
+template void va::decompose::qr<float>(float*, std::size_t, std::size_t, float*, float*, float*);
+template void va::decompose::qr<double>(double*, std::size_t, std::size_t, double*, double*, double*);
+template void va::decompose::qr<std::complex<float>>(std::complex<float>*, std::size_t, std::size_t, std::complex<float>*, std::complex<float>*, std::complex<float>*);
+template void va::decompose::qr<std::complex<double>>(std::complex<double>*, std::size_t, std::size_t, std::complex<double>*, std::complex<double>*, std::complex<double>*);
+
+template struct va::decompose::Symmetric<0, float>;
+template struct va::decompose::Symmetric<2, float>;
+template struct va::decompose::Symmetric<3, float>;
+template struct va::decompose::Symmetric<4, float>;
+template struct va::decompose::Symmetric<0, double>;
+template struct va::decompose::Symmetric<2, double>;
+template struct va::decompose::Symmetric<3, double>;
+template struct va::decompose::Symmetric<4, double>;
+
+template bool va::decompose::eigh_tridiagonal<float>(float*, std::size_t, float*, float*, float*);
+template bool va::decompose::eigh_tridiagonal<double>(double*, std::size_t, double*, double*, double*);
+
+template void va::decompose::svd<float>(const float*, std::size_t, std::size_t, float*, float*, float*, float*);
+template void va::decompose::svd<double>(const double*, std::size_t, std::size_t, double*, double*, double*, double*);
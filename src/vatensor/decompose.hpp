@@ -0,0 +1,56 @@
+#ifndef VATENSOR_DECOMPOSE_HPP
+#define VATENSOR_DECOMPOSE_HPP
+
+#include <complex>                         // for complex
+#include <cstddef>                         // for size_t
+
+// Matrix decompositions on raw memory, for float, double and their complex types.
+// Matrices are contiguous and row-major. Every call handles one matrix; batches are split by the caller.
+namespace va::decompose {
+	// Kernels for n x n matrices. If N > 0, n must be N, and the loops have a fixed length, so that they are unrolled.
+	// Instantiated in decompose.cpp for N = 0 (any size), 2, 3 and 4.
+	template <std::size_t N, typename T>
+	struct Square {
+		// LU decomposition with partial pivoting, in place: a = P L U, with L unit lower triangular.
+		// Row i was swapped with row pivots[i] >= i at step i. Returns the number of swaps that were not no-ops.
+		// Columns without a non-zero pivot are skipped, so singular matrices are decomposed, too.
+		static std::size_t lu(T* a, std::size_t n, std::size_t* pivots);
+
+		// Solves a x = b in place, where b is n x k, from the result of lu.
+		// Returns false, without changing b, if a is singular.
+		static bool lu_solve(const T* lu, const std::size_t* pivots, std::size_t n, T* b, std::size_t k);
+
+		// Product of the diagonal of the result of lu, with the sign of its permutation.
+		static T lu_det(const T* lu, std::size_t n, std::size_t swaps);
+
+		// Cholesky decomposition a = L L^H, in place. Only the lower triangle of a is read, and the upper is zeroed.
+		// Returns false if a is not positive definite.
+		static bool cholesky(T* a, std::size_t n);
+	};
+
+	// Eigen decomposition a = V diag(w) V^T of real symmetric n x n matrices, for float and double.
+	// Only the lower triangle of a is read, and a is overwritten. w is ascending, and the columns of v are the eigenvectors.
+	template <std::size_t N, typename T>
+	struct Symmetric {
+		// Cyclic Jacobi rotations. Accurate, and fast for small n.
+		// Instantiated in decompose.cpp for N = 0 (any size), 2, 3 and 4.
+		static void jacobi(T* a, std::size_t n, T* w, T* v);
+	};
+
+	// Like Symmetric::jacobi, with Householder tridiagonalization and implicit QR steps with Wilkinson shifts,
+	// which takes fewer operations for larger n. work holds 2 n elements. Returns false if the iteration did not converge.
+	template <typename T>
+	bool eigh_tridiagonal(T* a, std::size_t n, T* w, T* v, T* work);
+
+	// Reduced singular value decomposition a = U diag(s) V^T of a real m x n matrix, with one-sided Jacobi rotations.
+	// With k = min(m, n), u is m x k, s has k descending elements, and vt is k x n. work holds k * k + m * n elements.
+	template <typename T>
+	void svd(const T* a, std::size_t m, std::size_t n, T* u, T* s, T* vt, T* work);
+
+	// Reduced QR decomposition a = Q R with Householder reflections, where k = min(m, n).
+	// a (m x n) is overwritten. q is m x k, r is k x n, and work holds k + n elements of scratch memory.
+	template <typename T>
+	void qr(T* a, std::size_t m, std::size_t n, T* q, T* r, T* work);
+}
+
+#endif //VATENSOR_DECOMPOSE_HPP
@@ -0,0 +1,332 @@
+#include "dft.hpp"
+
+#include <algorithm>                       // for copy, fill_n
+#include <array>                           // for array
+#include <cmath>                           // for acos, sqrt
+#include <mutex>                           // for mutex, lock_guard
+#include <unordered_map>                   // for unordered_map
+#include <utility>                         // for swap
+
+#include "util.hpp"
+
+using namespace va::dft;
+
+namespace {
+	template <typename T>
+	using Complex = std::complex<T>;
+
+	// Prime factors up to this size get their own pass. Larger ones use Bluestein's algorithm.
+	constexpr std::size_t max_direct_radix = 31;
+	// Old plans are dropped when there are more, so that arbitrary sizes cannot grow the cache forever.
+	constexpr std::size_t max_cached_plans = 64;
+
+	const double pi = std::acos(-1.0);
+
+	using va::util::complex_multiply;
+
+	// -i a
+	template <typename T>
+	Complex<T> rotate_negative(const Complex<T> a) {
+		return { a.imag(), -a.real() };
+	}
+
+	// e^(-2 pi i numerator / denominator), computed in double precision.
+	template <typename T>
+	Complex<T> root_of_unity(const std::size_t numerator, const std::size_t denominator) {
+		const double angle = -2.0 * pi * static_cast<double>(numerator % denominator) / static_cast<double>(denominator);
+		return Complex<T>(std::polar(1.0, angle));
+	}
+
+	// Looks up a plan by size, or makes it without holding the lock, since making a plan may need other plans.
+	template <typename P, typename F>
+	std::shared_ptr<const P> get_cached(std::mutex& mutex, std::unordered_map<std::size_t, std::shared_ptr<const P>>& cache, const std::size_t n, F&& make) {
+		{
+			std::lock_guard lock(mutex);
+			if (const auto it = cache.find(n); it != cache.end()) return it->second;
+		}
+
+		std::shared_ptr<const P> plan = make();
+
+		std::lock_guard lock(mutex);
+		if (cache.size() >= max_cached_plans) cache.clear();
+		return cache.emplace(n, std::move(plan)).first->second;
+	}
+
+	// In the following passes, element p + j m of each sequence in x is butterflied into element radix p + k in y.
+	// Sequences are interleaved with stride s, which grows by the radix with every pass.
+
+	template <typename T>
+	void pass2(const typename Plan<T>::Stage& stage, const Complex<T>* x, Complex<T>* y, const std::size_t s) {
+		const std::size_t m = stage.m;
+		for (std::size_t p = 0; p < m; ++p) {
+			const Complex<T> w1 = stage.twiddles[p];
+			const Complex<T>* x0 = x + s * p;
+			const Complex<T>* x1 = x + s * (p + m);
+			Complex<T>* y0 = y + s * 2 * p;
+			Complex<T>* y1 = y0 + s;
+			for (std::size_t q = 0; q < s; ++q) {
+				const Complex<T> a0 = x0[q];
+				const Complex<T> a1 = x1[q];
+				y0[q] = a0 + a1;
+				y1[q] = complex_multiply(a0 - a1, w1);
+			}
+		}
+	}
+
+	template <typename T>
+	void pass3(const typename Plan<T>::Stage& stage, const Complex<T>* x, Complex<T>* y, const std::size_t s) {
+		const std::size_t m = stage.m;
+		const T sin60 = static_cast<T>(std::sqrt(3.0) / 2);
+		for (std::size_t p = 0; p < m; ++p) {
+			const Complex<T> w1 = stage.twiddles[p * 2];
+			const Complex<T> w2 = stage.twiddles[p * 2 + 1];
+			const Complex<T>* x0 = x + s * p;
+			const Complex<T>* x1 = x + s * (p + m);
+			const Complex<T>* x2 = x + s * (p + 2 * m);
+			Complex<T>* y0 = y + s * 3 * p;
+			Complex<T>* y1 = y0 + s;
+			Complex<T>* y2 = y1 + s;
+			for (std::size_t q = 0; q < s; ++q) {
+				const Complex<T> a0 = x0[q];
+				const Complex<T> t1 = x1[q] + x2[q];
+				const Complex<T> t2 = a0 - t1 * T(0.5);
+				const Complex<T> t3 = rotate_negative(x1[q] - x2[q]) * sin60;
+				y0[q] = a0 + t1;
+				y1[q] = complex_multiply(t2 + t3, w1);
+				y2[q] = complex_multiply(t2 - t3, w2);
+			}
+		}
+	}
+
+	template <typename T>
+	void pass4(const typename Plan<T>::Stage& stage, const Complex<T>* x, Complex<T>* y, const std::size_t s) {
+		const std::size_t m = stage.m;
+		for (std::size_t p = 0; p < m; ++p) {
+			const Complex<T> w1 = stage.twiddles[p * 3];
+			const Complex<T> w2 = stage.twiddles[p * 3 + 1];
+			const Complex<T> w3 = stage.twiddles[p * 3 + 2];
+			const Complex<T>* x0 = x + s * p;
+			const Complex<T>* x1 = x + s * (p + m);
+			const Complex<T>* x2 = x + s * (p + 2 * m);
+			const Complex<T>* x3 = x + s * (p + 3 * m);
+			Complex<T>* y0 = y + s * 4 * p;
+			Complex<T>* y1 = y0 + s;
+			Complex<T>* y2 = y1 + s;
+			Complex<T>* y3 = y2 + s;
+			for (std::size_t q = 0; q < s; ++q) {
+				const Complex<T> t0 = x0[q] + x2[q];
+				const Complex<T> t1 = x0[q] - x2[q];
+				const Complex<T> t2 = x1[q] + x3[q];
+				const Complex<T> t3 = rotate_negative(x1[q] - x3[q]);
+				y0[q] = t0 + t2;
+				y1[q] = complex_multiply(t1 + t3, w1);
+				y2[q] = complex_multiply(t0 - t2, w2);
+				y3[q] = complex_multiply(t1 - t3, w3);
+			}
+		}
+	}
+
+	// Any radix up to max_direct_radix, as a direct DFT of radix elements.
+	template <typename T>
+	void pass_generic(const typename Plan<T>::Stage& stage, const Complex<T>* x, Complex<T>* y, const std::size_t s) {
+		const std::size_t radix = stage.radix;
+		const std::size_t m = stage.m;
+		std::array<Complex<T>, max_direct_radix> a;
+
+		for (std::size_t p = 0; p < m; ++p) {
+			const Complex<T>* w = stage.twiddles.data() + p * (radix - 1);
+			for (std::size_t q = 0; q < s; ++q) {
+				for (std::size_t j = 0; j < radix; ++j) a[j] = x[q + s * (p + j * m)];
+
+				for (std::size_t k = 0; k < radix; ++k) {
+					Complex<T> sum = a[0];
+					for (std::size_t j = 1; j < radix; ++j) sum += complex_multiply(a[j], stage.roots[j * k % radix]);
+					y[q + s * (radix * p + k)] = k == 0 ? sum : complex_multiply(sum, w[k - 1]);
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	void bluestein(const Plan<T>& plan, Complex<T>* data, Complex<T>* work, const std::size_t count) {
+		const Plan<T>& convolution_plan = *plan.convolution_plan;
+		const std::size_t n = plan.n;
+		const std::size_t m = convolution_plan.n;
+		Complex<T>* a = work;
+		Complex<T>* convolution_work = work + m * count;
+
+		for (std::size_t k = 0; k < n; ++k) {
+			for (std::size_t q = 0; q < count; ++q) a[k * count + q] = complex_multiply(data[k * count + q], plan.chirp[k]);
+		}
+		std::fill_n(a + n * count, (m - n) * count, Complex<T>(0));
+
+		// The convolution with the chirp, as a product of spectra. The inverse transform is conj(fft(conj(x))).
+		execute(convolution_plan, a, convolution_work, count);
+		for (std::size_t k = 0; k < m; ++k) {
+			for (std::size_t q = 0; q < count; ++q) a[k * count + q] = std::conj(complex_multiply(a[k * count + q], plan.chirp_spectrum[k]));
+		}
+		execute(convolution_plan, a, convolution_work, count);
+
+		for (std::size_t k = 0; k < n; ++k) {
+			for (std::size_t q = 0; q < count; ++q) data[k * count + q] = complex_multiply(std::conj(a[k * count + q]), plan.chirp[k]);
+		}
+	}
+
+	template <typename T>
+	std::shared_ptr<const Plan<T>> make_plan(const std::size_t n) {
+		auto plan = std::make_shared<Plan<T>>();
+		plan->n = n;
+		plan->work_size = n;
+
+		std::vector<std::size_t> radices;
+		std::size_t rest = n;
+		for (; rest % 4 == 0 && rest > 1; rest /= 4) radices.push_back(4);
+		for (; rest % 2 == 0 && rest > 1; rest /= 2) radices.push_back(2);
+		for (std::size_t factor = 3; factor * factor <= rest; factor += 2) {
+			for (; rest % factor == 0; rest /= factor) radices.push_back(factor);
+		}
+		if (rest > 1) radices.push_back(rest);
+
+		if (!radices.empty() && *std::max_element(radices.begin(), radices.end()) > max_direct_radix) {
+			// x[k] = e^(-pi i k^2 / n), and the convolution must hold 2 n - 1 elements without wrapping around.
+			std::size_t m = 1;
+			while (m < 2 * n - 1) m *= 2;
+			plan->convolution_plan = get_plan<T>(m);
+			plan->work_size = 2 * m;
+
+			plan->chirp.resize(n);
+			for (std::size_t k = 0; k < n; ++k) plan->chirp[k] = root_of_unity<T>(k * k % (2 * n), 2 * n);
+
+			std::vector<Complex<T>> kernel(m, Complex<T>(0));
+			kernel[0] = std::conj(plan->chirp[0]);
+			for (std::size_t k = 1; k < n; ++k) kernel[k] = kernel[m - k] = std::conj(plan->chirp[k]);
+			std::vector<Complex<T>> kernel_work(plan->convolution_plan->work_size);
+			execute(*plan->convolution_plan, kernel.data(), kernel_work.data(), 1);
+
+			// Scaled by 1 / m for the inverse transform.
+			const T scale = T(1) / static_cast<T>(m);
+			plan->chirp_spectrum.resize(m);
+			for (std::size_t k = 0; k < m; ++k) plan->chirp_spectrum[k] = kernel[k] * scale;
+			return plan;
+		}
+
+		std::size_t length = n;
+		for (const std::size_t radix : radices) {
+			typename Plan<T>::Stage stage;
+			stage.radix = radix;
+			stage.m = length / radix;
+
+			stage.twiddles.resize(stage.m * (radix - 1));
+			for (std::size_t p = 0; p < stage.m; ++p) {
+				for (std::size_t k = 1; k < radix; ++k) stage.twiddles[p * (radix - 1) + k - 1] = root_of_unity<T>(p * k, length);
+			}
+			if (radix > 4) {
+				stage.roots.resize(radix);
+				for (std::size_t j = 0; j < radix; ++j) stage.roots[j] = root_of_unity<T>(j, radix);
+			}
+
+			plan->stages.push_back(std::move(stage));
+			length /= radix;
+		}
+		return plan;
+	}
+}
+
+template <typename T>
+std::shared_ptr<const Plan<T>> va::dft::get_plan(const std::size_t n) {
+	static std::mutex mutex;
+	static std::unordered_map<std::size_t, std::shared_ptr<const Plan<T>>> cache;
+	return get_cached(mutex, cache, n, [n]() { return make_plan<T>(n); });
+}
+
+template <typename T>
+void va::dft::execute(const Plan<T>& plan, std::complex<T>* data, std::complex<T>* work, const std::size_t count) {
+	if (plan.convolution_plan) {
+		bluestein(plan, data, work, count);
+		return;
+	}
+
+	// Stockham passes alternate between data and work.
+	Complex<T>* x = data;
+	Complex<T>* y = work;
+	std::size_t s = count;
+	for (const auto& stage : plan.stages) {
+		switch (stage.radix) {
+			case 2: pass2<T>(stage, x, y, s); break;
+			case 3: pass3<T>(stage, x, y, s); break;
+			case 4: pass4<T>(stage, x, y, s); break;
+			default: pass_generic<T>(stage, x, y, s); break;
+		}
+		std::swap(x, y);
+		s *= stage.radix;
+	}
+	if (x != data) std::copy(x, x + plan.n * count, data);
+}
+
+template <typename T>
+std::shared_ptr<const RealPlan<T>> va::dft::get_real_plan(const std::size_t n) {
+	static std::mutex mutex;
+	static std::unordered_map<std::size_t, std::shared_ptr<const RealPlan<T>>> cache;
+	return get_cached(mutex, cache, n, [n]() {
+		auto plan = std::make_shared<RealPlan<T>>();
+		plan->n = n;
+		plan->half_plan = get_plan<T>(n / 2);
+		plan->twiddles.resize(n / 2 + 1);
+		for (std::size_t k = 0; k <= n / 2; ++k) plan->twiddles[k] = root_of_unity<T>(k, n);
+		return std::shared_ptr<const RealPlan<T>>(std::move(plan));
+	});
+}
+
+template <typename T>
+void va::dft::unpack_real(const RealPlan<T>& plan, const std::complex<T>* z, std::complex<T>* x, const std::size_t count) {
+	const std::size_t h = plan.n / 2;
+
+	// The transforms of the even and odd elements are E = (Z[k] + conj(Z[h - k])) / 2 and O = (Z[k] - conj(Z[h - k])) / 2i.
+	// Then, X[k] = E + w^k O.
+	for (std::size_t k = 0; k <= h; ++k) {
+		const Complex<T> w = plan.twiddles[k];
+		const Complex<T>* zk = z + (k % h) * count;
+		const Complex<T>* zc = z + ((h - k) % h) * count;
+		Complex<T>* xk = x + k * count;
+		for (std::size_t q = 0; q < count; ++q) {
+			const Complex<T> conj_zc = std::conj(zc[q]);
+			const Complex<T> even = (zk[q] + conj_zc) * T(0.5);
+			const Complex<T> odd = rotate_negative(zk[q] - conj_zc) * T(0.5);
+			xk[q] = even + complex_multiply(w, odd);
+		}
+	}
+}
+
+template <typename T>
+void va::dft::pack_real(const RealPlan<T>& plan, const std::complex<T>* x, std::complex<T>* z, const std::size_t count) {
+	const std::size_t h = plan.n / 2;
+
+	// E = (X[k] + conj(X[h - k])) / 2 and O = (X[k] - conj(X[h - k])) / 2 w^k, and Z[k] = E + i O.
+	for (std::size_t k = 0; k < h; ++k) {
+		const Complex<T> w = std::conj(plan.twiddles[k]);
+		const Complex<T>* xk = x + k * count;
+		const Complex<T>* xc = x + (h - k) * count;
+		Complex<T>* zk = z + k * count;
+		for (std::size_t q = 0; q < count; ++q) {
+			const Complex<T> conj_xc = std::conj(xc[q]);
+			const Complex<T> even = (xk[q] + conj_xc) * T(0.5);
+			const Complex<T> odd = complex_multiply(xk[q] - conj_xc, w) * T(0.5);
+			zk[q] = even - rotate_negative(odd);
+		}
+	}
+}
+
+template struct va::dft::Plan<float>;
+template struct va::dft::Plan<double>;
+
+template std::shared_ptr<const Plan<float>> va::dft::get_plan<float>(std::size_t);
+template std::shared_ptr<const Plan<double>> va::dft::get_plan<double>(std::size_t);
+template void va::dft::execute<float>(const Plan<float>&, std::complex<float>*, std::complex<float>*, std::size_t);
+template void va::dft::execute<double>(const Plan<double>&, std::complex<double>*, std::complex<double>*, std::size_t);
+
+template std::shared_ptr<const RealPlan<float>> va::dft::get_real_plan<float>(std::size_t);
+template std::shared_ptr<const RealPlan<double>> va::dft::get_real_plan<double>(std::size_t);
+template void va::dft::unpack_real<float>(const RealPlan<float>&, const std::complex<float>*, std::complex<float>*, std::size_t);
+template void va::dft::unpack_real<double>(const RealPlan<double>&, const std::complex<double>*, std::complex<double>*, std::size_t);
+template void va::dft::pack_real<float>(const RealPlan<float>&, const std::complex<float>*, std::complex<float>*, std::size_t);
+template void va::dft::pack_real<double>(const RealPlan<double>&, const std::complex<double>*, std::complex<double>*, std::size_t);
@@ -0,0 +1,70 @@
+#ifndef VATENSOR_DFT_HPP
+#define VATENSOR_DFT_HPP
+
+#include <complex>                         // for complex
+#include <cstddef>                         // for size_t
+#include <memory>                          // for shared_ptr
+#include <vector>                          // for vector
+
+// Fast Fourier transforms on raw memory, for float and double precision.
+// Several sequences are transformed at once, interleaved element by element, so that the butterflies vectorize across them.
+namespace va::dft {
+	template <typename T>
+	struct Plan {
+		// One radix pass of the Stockham autosort algorithm, which needs no bit reversal for any mix of radices.
+		struct Stage {
+			std::size_t radix;
+			// Number of butterflies per sequence.
+			std::size_t m;
+			// e^(-2 pi i p k / (radix m)) for p < m and 0 < k < radix, at p * (radix - 1) + k - 1.
+			std::vector<std::complex<T>> twiddles;
+			// e^(-2 pi i j / radix), for radices without a specialized butterfly.
+			std::vector<std::complex<T>> roots;
+		};
+
+		std::size_t n;
+		std::vector<Stage> stages;
+
+		// Sizes with a large prime factor are transformed with Bluestein's algorithm instead:
+		// As a convolution with a chirp, of a size that has only small factors.
+		std::shared_ptr<const Plan> convolution_plan;
+		std::vector<std::complex<T>> chirp;
+		std::vector<std::complex<T>> chirp_spectrum;
+
+		// Elements of work memory per sequence that execute needs.
+		std::size_t work_size;
+	};
+
+	// Plans are cached by size, because transforms are usually repeated with the same sizes, e.g. every frame.
+	template <typename T>
+	std::shared_ptr<const Plan<T>> get_plan(std::size_t n);
+
+	// Forward transform X[k] = sum_j x[j] e^(-2 pi i j k / n), without normalization, in place.
+	// Transforms count sequences, where element j of sequence q is data[j * count + q].
+	// work holds plan.work_size * count elements.
+	template <typename T>
+	void execute(const Plan<T>& plan, std::complex<T>* data, std::complex<T>* work, std::size_t count);
+
+	// For transforms of an even number n of real elements, as complex transforms of n / 2 elements.
+	template <typename T>
+	struct RealPlan {
+		std::size_t n;
+		std::shared_ptr<const Plan<T>> half_plan;
+		// e^(-2 pi i k / n) for k <= n / 2.
+		std::vector<std::complex<T>> twiddles;
+	};
+
+	template <typename T>
+	std::shared_ptr<const RealPlan<T>> get_real_plan(std::size_t n);
+
+	// With z[j] = x[2 j] + i x[2 j + 1], turns the transform of z (n / 2 elements) into the transform of the real x (n / 2 + 1 elements).
+	// Sequences are interleaved like in execute.
+	template <typename T>
+	void unpack_real(const RealPlan<T>& plan, const std::complex<T>* z, std::complex<T>* x, std::size_t count);
+
+	// The inverse of unpack_real: Turns the transform of a real x into the transform of z, whose inverse transform is x packed into z.
+	template <typename T>
+	void pack_real(const RealPlan<T>& plan, const std::complex<T>* x, std::complex<T>* z, std::size_t count);
+}
+
+#endif //VATENSOR_DFT_HPP
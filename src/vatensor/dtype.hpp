@@ -66,6 +66,10 @@ namespace va {
 		return static_cast<size_t>(dtype) <= DTypeMax;
 	}
 
+	constexpr bool is_integer_dtype(const DType dtype) noexcept {
+		return dtype >= DType::Int8 && dtype <= DType::UInt64;
+	}
+
 	template<typename Variant, std::size_t... Is>
 	constexpr auto make_variant_array(std::index_sequence<Is...>) {
 		return std::array<Variant, sizeof...(Is)> { Variant{std::in_place_index_t<Is>{}}... };
@@ -0,0 +1,550 @@
+#include "einsum.hpp"
+
+#include <algorithm>                       // for count, max, none_of
+#include <array>                           // for array
+#include <cctype>                          // for isalpha
+#include <cstddef>                         // for size_t, ptrdiff_t
+#include <limits>                          // for numeric_limits
+#include <memory>                          // for unique_ptr, shared_ptr
+#include <mutex>                           // for mutex, lock_guard
+#include <stdexcept>                       // for runtime_error
+#include <string_view>                     // for string_view
+#include <tuple>                           // for make_tuple
+#include <type_traits>                     // for decay_t
+#include <unordered_map>                   // for unordered_map
+#include <utility>                         // for move, pair
+#include <variant>                         // for visit, get
+#include "create.hpp"
+#include "elementwise.hpp"
+#include "gemm.hpp"
+#include "util.hpp"
+#include "vcall.hpp"
+#include "vparallel.hpp"
+
+using namespace va;
+
+namespace {
+	// The subscripts of einsum. Each character is the label of an axis. An ellipsis is stored as a single '.'.
+	struct Subscripts {
+		std::vector<std::string> inputs;
+		std::string output;
+	};
+
+	// Sizes of the labels, indexed by their character.
+	using LabelSizes = std::array<std::size_t, 128>;
+
+	// Internal labels, e.g. of the axes an ellipsis stands for, start here. They sort before all letters.
+	constexpr char first_internal_label = 1;
+	constexpr std::size_t max_internal_labels = ' ' - first_internal_label;
+
+	std::string parse_term(const std::string_view term) {
+		std::string labels;
+		for (std::size_t i = 0; i < term.size();) {
+			const char c = term[i];
+			if (c == '.') {
+				if (term.substr(i, 3) != "..." || labels.find('.') != std::string::npos) {
+					throw std::runtime_error("invalid ellipsis in einsum subscripts");
+				}
+				labels += '.';
+				i += 3;
+				continue;
+			}
+			if (c != ' ') {
+				if (!std::isalpha(static_cast<unsigned char>(c))) throw std::runtime_error("einsum subscripts must be letters");
+				labels += c;
+			}
+			++i;
+		}
+		return labels;
+	}
+
+	Subscripts parse_subscripts(const std::string& subscripts) {
+		Subscripts result;
+		const std::size_t arrow = subscripts.find("->");
+		const std::string_view inputs = std::string_view(subscripts).substr(0, arrow);
+
+		for (std::size_t begin = 0;;) {
+			const std::size_t end = inputs.find(',', begin);
+			result.inputs.push_back(parse_term(inputs.substr(begin, end == std::string_view::npos ? end : end - begin)));
+			if (end == std::string_view::npos) break;
+			begin = end + 1;
+		}
+
+		if (arrow != std::string::npos) {
+			result.output = parse_term(std::string_view(subscripts).substr(arrow + 2));
+			for (std::size_t i = 0; i < result.output.size(); ++i) {
+				const char label = result.output[i];
+				if (result.output.find(label, i + 1) != std::string::npos) {
+					throw std::runtime_error("einsum output subscripts contain a label more than once");
+				}
+				if (std::none_of(result.inputs.begin(), result.inputs.end(), [label](const std::string& input) { return input.find(label) != std::string::npos; })) {
+					throw std::runtime_error(std::string("einsum output subscript '") + label + "' does not appear in the inputs");
+				}
+			}
+			return result;
+		}
+
+		// Implicit output: The broadcast axes, followed by the labels that appear once, in alphabetical order.
+		LabelSizes counts {};
+		bool has_ellipsis = false;
+		for (const auto& input : result.inputs) {
+			for (const char label : input) {
+				if (label == '.') has_ellipsis = true;
+				else ++counts[static_cast<unsigned char>(label)];
+			}
+		}
+		if (has_ellipsis) result.output += '.';
+		for (std::size_t label = 0; label < counts.size(); ++label) {
+			if (counts[label] == 1) result.output += static_cast<char>(label);
+		}
+		return result;
+	}
+
+	// The same subscripts are usually used every frame, so they are only parsed once.
+	constexpr std::size_t max_cached_subscripts = 256;
+
+	Subscripts parse_subscripts_cached(const std::string& subscripts) {
+		static std::mutex mutex;
+		static std::unordered_map<std::string, Subscripts> cache;
+
+		{
+			std::lock_guard lock(mutex);
+			if (const auto it = cache.find(subscripts); it != cache.end()) return it->second;
+		}
+
+		Subscripts parsed = parse_subscripts(subscripts);
+
+		std::lock_guard lock(mutex);
+		if (cache.size() >= max_cached_subscripts) cache.clear();
+		cache.emplace(subscripts, parsed);
+		return parsed;
+	}
+
+	// Replaces the ellipsis of a term by labels of the axes it stands for, aligned to the right.
+	std::string expand_ellipsis(const std::string& labels, const std::size_t ellipsis_dimension, const std::size_t broadcast_dimension) {
+		const std::size_t position = labels.find('.');
+		if (position == std::string::npos) return labels;
+
+		std::string broadcast_labels;
+		for (std::size_t i = broadcast_dimension - ellipsis_dimension; i < broadcast_dimension; ++i) {
+			broadcast_labels += static_cast<char>(first_internal_label + i);
+		}
+		return std::string(labels).replace(position, 1, broadcast_labels);
+	}
+
+	std::size_t label_index(const char label) {
+		return static_cast<unsigned char>(label);
+	}
+
+	std::size_t size_of(const std::string& labels, const LabelSizes& sizes) {
+		std::size_t size = 1;
+		for (const char label : labels) size *= sizes[label_index(label)];
+		return size;
+	}
+
+	bool is_row_major(const shape_type& shape, const strides_type& strides) {
+		std::ptrdiff_t expected = 1;
+		for (std::size_t i = shape.size(); i-- > 0;) {
+			if (shape[i] == 1) continue;
+			if (strides[i] != expected) return false;
+			expected *= static_cast<std::ptrdiff_t>(shape[i]);
+		}
+		return true;
+	}
+
+	// A strided view of an operand or intermediate result, with one label per axis.
+	template <typename T>
+	struct Tensor {
+		const T* ptr = nullptr;
+		std::string labels;
+		shape_type shape;
+		strides_type strides;
+		// Owns the data of intermediate results.
+		std::unique_ptr<T[]> storage;
+	};
+
+	// A view of an operand, where axes of size 1 are broadcast to the size of their label,
+	// and axes with the same label are merged into their diagonal.
+	template <typename T, typename A>
+	Tensor<T> make_tensor(const A& array, const std::string& labels, const LabelSizes& sizes) {
+		Tensor<T> tensor;
+		tensor.ptr = array.data() + array.data_offset();
+
+		for (std::size_t axis = 0; axis < labels.size(); ++axis) {
+			const std::ptrdiff_t stride = array.shape()[axis] == 1 ? 0 : array.strides()[axis];
+			const std::size_t existing = tensor.labels.find(labels[axis]);
+			if (existing != std::string::npos) {
+				tensor.strides[existing] += stride;
+				continue;
+			}
+
+			tensor.labels += labels[axis];
+			tensor.shape.push_back(sizes[label_index(labels[axis])]);
+			tensor.strides.push_back(stride);
+		}
+		return tensor;
+	}
+
+	// Sum of the elements of a strided block at ptr, over [begin, end) of its first axis. The last axis is innermost.
+	template <typename T>
+	T sum_strided(const T* ptr, const shape_type& shape, const strides_type& strides, const std::size_t axis, const std::size_t begin, const std::size_t end) {
+		T sum = T(0);
+		if (axis + 1 == shape.size()) {
+			for (std::size_t i = begin; i < end; ++i) sum += ptr[static_cast<std::ptrdiff_t>(i) * strides[axis]];
+			return sum;
+		}
+		for (std::size_t i = begin; i < end; ++i) {
+			sum += sum_strided(ptr + static_cast<std::ptrdiff_t>(i) * strides[axis], shape, strides, axis + 1, 0, shape[axis + 1]);
+		}
+		return sum;
+	}
+
+	// Writes tensor to out, which is row-major, with its axes in order. The axes of reduce are summed.
+	template <typename T>
+	void gather(const Tensor<T>& tensor, const std::string& order, const std::string& reduce, T* out) {
+		shape_type shape;
+		std::array<strides_type, 2> strides;
+		for (const char label : order) {
+			const std::size_t axis = tensor.labels.find(label);
+			shape.push_back(tensor.shape[axis]);
+			strides[1].push_back(tensor.strides[axis]);
+		}
+		strides[0].resize(shape.size());
+		std::ptrdiff_t stride = 1;
+		for (std::size_t i = shape.size(); i-- > 0;) {
+			strides[0][i] = shape[i] == 1 ? 0 : stride;
+			stride *= static_cast<std::ptrdiff_t>(shape[i]);
+		}
+
+		std::size_t size = 1;
+		for (const auto dim : shape) size *= dim;
+		if (size == 0) return;
+
+		// The summed axes, in the order of the tensor's axes, so that they flatten if they are contiguous.
+		shape_type reduce_shape;
+		std::array<strides_type, 1> reduce_strides;
+		for (std::size_t axis = 0; axis < tensor.labels.size(); ++axis) {
+			if (reduce.find(tensor.labels[axis]) == std::string::npos) continue;
+			reduce_shape.push_back(tensor.shape[axis]);
+			reduce_strides[0].push_back(tensor.strides[axis]);
+		}
+		std::size_t reduce_size = 1;
+		for (const auto dim : reduce_shape) reduce_size *= dim;
+		if (!reduce_shape.empty()) elementwise::try_flatten(reduce_shape, reduce_strides);
+
+		if (shape.empty()) {
+			shape = shape_type { 1 };
+			strides = { strides_type { 0 }, strides_type { 0 } };
+		}
+		elementwise::try_flatten(shape, strides);
+
+		const std::size_t total = size * reduce_size;
+		const std::size_t output_chunks = parallel::num_chunks(total, size);
+		const std::size_t reduce_chunks = reduce_shape.empty() ? 1 : parallel::num_chunks(total, reduce_shape[0]);
+
+		const auto run = [&](const auto& fn) {
+			const auto ptrs = std::make_tuple(out, tensor.ptr);
+			if (output_chunks <= 1) {
+				elementwise::walk(fn, ptrs, shape, strides, 0, size);
+				return;
+			}
+			parallel::run(output_chunks, [&fn, &ptrs, &shape, &strides, output_chunks, size](const std::size_t chunk) {
+				const auto [begin, end] = parallel::chunk_range(chunk, output_chunks, size);
+				elementwise::walk(fn, ptrs, shape, strides, begin, end);
+			});
+		};
+
+		if (reduce_shape.empty()) {
+			run([](T& result, const T& element) { result = element; });
+			return;
+		}
+
+		const shape_type& reduce_shape_ = reduce_shape;
+		const strides_type& reduce_strides_ = reduce_strides[0];
+		if (reduce_chunks <= output_chunks) {
+			run([&reduce_shape_, &reduce_strides_](T& result, const T& element) {
+				result = sum_strided(&element, reduce_shape_, reduce_strides_, 0, 0, reduce_shape_[0]);
+			});
+			return;
+		}
+
+		// Few outputs and many summed elements: Each chunk sums part of the outermost summed axis, and the partial sums are added.
+		// Not a vector, because std::vector<bool> cannot be written to concurrently.
+		const std::unique_ptr<T[]> partials(new T[reduce_chunks * size]);
+		parallel::run(reduce_chunks, [&](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, reduce_chunks, reduce_shape_[0]);
+			const auto ptrs = std::make_tuple(partials.get() + chunk * size, tensor.ptr);
+			elementwise::walk([&reduce_shape_, &reduce_strides_, begin, end](T& result, const T& element) {
+				result = sum_strided(&element, reduce_shape_, reduce_strides_, 0, begin, end);
+			}, ptrs, shape, strides, 0, size);
+		});
+		for (std::size_t i = 0; i < size; ++i) {
+			T sum = partials[i];
+			for (std::size_t chunk = 1; chunk < reduce_chunks; ++chunk) sum += partials[chunk * size + i];
+			out[i] = sum;
+		}
+	}
+
+	// Row-major data of tensor, with its axes in order, and the axes of reduce summed.
+	// If the tensor is laid out like that already, this is its own data. Otherwise, it is packed into buffer.
+	template <typename T>
+	const T* pack(const Tensor<T>& tensor, const std::string& order, const std::string& reduce, std::unique_ptr<T[]>& buffer) {
+		if (reduce.empty()) {
+			shape_type shape;
+			strides_type strides;
+			for (const char label : order) {
+				const std::size_t axis = tensor.labels.find(label);
+				shape.push_back(tensor.shape[axis]);
+				strides.push_back(tensor.strides[axis]);
+			}
+			if (is_row_major(shape, strides)) return tensor.ptr;
+		}
+
+		std::size_t size = 1;
+		for (const char label : order) size *= tensor.shape[tensor.labels.find(label)];
+		buffer.reset(new T[size]);
+		gather(tensor, order, reduce, buffer.get());
+		return buffer.get();
+	}
+
+	// c[i] = a[i] b[i] for batches of row-major matrices, with a: m x k, b: k x n, c: m x n.
+	template <typename T>
+	void multiply_batches(const std::size_t batches, const std::size_t m, const std::size_t n, const std::size_t k, const T* a, const T* b, T* c) {
+		const auto multiply = [=](const std::size_t batch) {
+			const T* a_ = a + batch * m * k;
+			const T* b_ = b + batch * k * n;
+			T* c_ = c + batch * m * n;
+
+			if (n == 1) {
+				gemm::gemv<T>(m, k, gemm::Matrix<const T> { a_, static_cast<std::ptrdiff_t>(k), 1 }, b_, 1, c_, 1);
+			}
+			else if (m == 1) {
+				gemm::gevm<T>(n, k, a_, 1, gemm::Matrix<const T> { b_, static_cast<std::ptrdiff_t>(n), 1 }, c_, 1);
+			}
+			else {
+				gemm::gemm<T>(
+					m, n, k,
+					gemm::Matrix<const T> { a_, static_cast<std::ptrdiff_t>(k), 1 },
+					gemm::Matrix<const T> { b_, static_cast<std::ptrdiff_t>(n), 1 },
+					gemm::Matrix<T> { c_, static_cast<std::ptrdiff_t>(n), 1 }
+				);
+			}
+		};
+
+		// Like in matmul, many small products are split by batch. Otherwise, the kernels split each product.
+		const std::size_t chunks = batches > 1 && m * n * k < parallel::get_min_size()
+			? parallel::num_chunks(batches * m * n * k, batches)
+			: 1;
+		parallel::run(chunks, [&multiply, chunks, batches](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, batches);
+			for (std::size_t batch = begin; batch < end; ++batch) multiply(batch);
+		});
+	}
+
+	// Contracts a and b to a tensor with the labels of keep that either of them has.
+	// Labels of both are batch axes if they are kept, and summed by the matrix product if not.
+	// Labels of only one are summed before the product, unless they are kept.
+	template <typename T>
+	Tensor<T> contract_pair(const Tensor<T>& a, const Tensor<T>& b, const std::string& keep, const LabelSizes& sizes) {
+		std::string batch, free_a, free_b, contracted, reduced_a, reduced_b;
+		for (const char label : a.labels) {
+			const bool is_kept = keep.find(label) != std::string::npos;
+			if (b.labels.find(label) != std::string::npos) (is_kept ? batch : contracted) += label;
+			else (is_kept ? free_a : reduced_a) += label;
+		}
+		for (const char label : b.labels) {
+			if (a.labels.find(label) != std::string::npos) continue;
+			(keep.find(label) != std::string::npos ? free_b : reduced_b) += label;
+		}
+
+		std::unique_ptr<T[]> a_buffer;
+		std::unique_ptr<T[]> b_buffer;
+		const T* a_packed = pack(a, batch + free_a + contracted, reduced_a, a_buffer);
+		const T* b_packed = pack(b, batch + contracted + free_b, reduced_b, b_buffer);
+
+		const std::size_t batches = size_of(batch, sizes);
+		const std::size_t m = size_of(free_a, sizes);
+		const std::size_t n = size_of(free_b, sizes);
+		const std::size_t k = size_of(contracted, sizes);
+
+		Tensor<T> result;
+		result.labels = batch + free_a + free_b;
+		result.storage.reset(new T[batches * m * n]);
+		result.ptr = result.storage.get();
+		result.shape.resize(result.labels.size());
+		result.strides.resize(result.labels.size());
+		std::ptrdiff_t stride = 1;
+		for (std::size_t i = result.labels.size(); i-- > 0;) {
+			result.shape[i] = sizes[label_index(result.labels[i])];
+			result.strides[i] = stride;
+			stride *= static_cast<std::ptrdiff_t>(result.shape[i]);
+		}
+
+		multiply_batches(batches, m, n, k, a_packed, b_packed, result.storage.get());
+		return result;
+	}
+
+	// Contracts the tensors pairwise, until one is left. Labels that are not in output are summed as soon as possible.
+	template <typename T>
+	Tensor<T> contract_all(std::vector<Tensor<T>> tensors, const std::string& output, const LabelSizes& sizes) {
+		// Labels that must survive the contraction of tensors i and j: those of the output, and of the other tensors.
+		const auto kept_labels = [&tensors, &output](const std::size_t i, const std::size_t j) {
+			std::string keep = output;
+			for (std::size_t other = 0; other < tensors.size(); ++other) {
+				if (other != i && other != j) keep += tensors[other].labels;
+			}
+			return keep;
+		};
+
+		while (tensors.size() > 1) {
+			// Greedy order: The pair with the smallest result goes first, then the one with the least work.
+			// This keeps intermediates small, and avoids outer products while there are shared labels.
+			std::size_t best_i = 0;
+			std::size_t best_j = 1;
+			std::pair best_cost { std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max() };
+			for (std::size_t i = 0; i < tensors.size(); ++i) {
+				for (std::size_t j = i + 1; j < tensors.size(); ++j) {
+					const std::string keep = kept_labels(i, j);
+					std::string labels = tensors[i].labels;
+					for (const char label : tensors[j].labels) {
+						if (labels.find(label) == std::string::npos) labels += label;
+					}
+
+					std::pair<std::size_t, std::size_t> cost { 1, size_of(labels, sizes) };
+					for (const char label : labels) {
+						if (keep.find(label) != std::string::npos) cost.first *= sizes[label_index(label)];
+					}
+					if (cost < best_cost) {
+						best_cost = cost;
+						best_i = i;
+						best_j = j;
+					}
+				}
+			}
+
+			Tensor<T> result = contract_pair(tensors[best_i], tensors[best_j], kept_labels(best_i, best_j), sizes);
+			tensors.erase(tensors.begin() + static_cast<std::ptrdiff_t>(best_j));
+			tensors.erase(tensors.begin() + static_cast<std::ptrdiff_t>(best_i));
+			tensors.push_back(std::move(result));
+		}
+
+		return std::move(tensors[0]);
+	}
+
+	// Einstein summation, where every label is a character, and operands have exactly one label per axis.
+	void contract(VStoreAllocator& allocator, const VArrayTarget& target, const std::vector<const VData*>& operands, const std::vector<std::string>& labels, const std::string& output) {
+		if (operands.empty()) throw std::runtime_error("einsum needs at least one operand");
+
+		LabelSizes sizes;
+		sizes.fill(1);
+		for (std::size_t i = 0; i < operands.size(); ++i) {
+			const auto& shape = va::shape(*operands[i]);
+			for (std::size_t axis = 0; axis < shape.size(); ++axis) {
+				std::size_t& size = sizes[label_index(labels[i][axis])];
+				if (shape[axis] == 1 || shape[axis] == size) continue;
+				if (size != 1) throw std::runtime_error("operands could not be broadcast together in einsum");
+				size = shape[axis];
+			}
+		}
+
+		DType dtype = va::dtype(*operands[0]);
+		for (const auto operand : operands) dtype = va::dtype_common_type(dtype, va::dtype(*operand));
+
+		shape_type result_shape;
+		for (const char label : output) result_shape.push_back(sizes[label_index(label)]);
+		// Operands and target may overlap, so the result is computed into a new array.
+		const auto result = va::empty(allocator, dtype, result_shape);
+
+		std::vector<std::shared_ptr<VArray>> casts(operands.size());
+		std::vector<const VData*> data(operands.size());
+		for (std::size_t i = 0; i < operands.size(); ++i) {
+			data[i] = operands[i];
+			if (va::dtype(*operands[i]) != dtype) {
+				casts[i] = va::copy_as_dtype(allocator, *operands[i], dtype);
+				data[i] = &casts[i]->data;
+			}
+		}
+
+		std::visit([&data, &labels, &output, &sizes](auto& result_array) {
+			using T = typename std::decay_t<decltype(result_array)>::value_type;
+
+			std::vector<Tensor<T>> tensors;
+			tensors.reserve(data.size());
+			for (std::size_t i = 0; i < data.size(); ++i) {
+				tensors.push_back(make_tensor<T>(std::get<compute_case<T*>>(*data[i]), labels[i], sizes));
+			}
+			const Tensor<T> tensor = contract_all(std::move(tensors), output, sizes);
+
+			std::string reduce;
+			for (const char label : tensor.labels) {
+				if (output.find(label) == std::string::npos) reduce += label;
+			}
+			gather(tensor, output, reduce, result_array.data() + result_array.data_offset());
+		}, result->data);
+
+		if (const auto target_data = std::get_if<VData*>(&target)) {
+			va::assign(**target_data, result->data);
+		}
+		else {
+			*std::get<std::shared_ptr<VArray>*>(target) = result;
+		}
+	}
+}
+
+void va::tensordot(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b, const axes_type& axes_a, const axes_type& axes_b) {
+	if (axes_a.size() != axes_b.size()) throw std::runtime_error("tensordot needs as many axes of a as of b");
+
+	const auto& a_shape = va::shape(a);
+	const auto& b_shape = va::shape(b);
+	if (a_shape.size() + b_shape.size() > max_internal_labels) throw std::runtime_error("too many dimensions for tensordot");
+
+	std::string a_labels;
+	for (std::size_t i = 0; i < a_shape.size(); ++i) a_labels += static_cast<char>(first_internal_label + i);
+	std::string b_labels(b_shape.size(), '\0');
+
+	for (std::size_t i = 0; i < axes_a.size(); ++i) {
+		const std::size_t axis_a = util::normalize_axis(axes_a[i], a_shape.size());
+		const std::size_t axis_b = util::normalize_axis(axes_b[i], b_shape.size());
+		if (b_labels[axis_b] != '\0') throw std::runtime_error("repeated axis in tensordot");
+		if (a_shape[axis_a] != b_shape[axis_b]) throw std::runtime_error("shape mismatch for sum in tensordot");
+		if (std::count(b_labels.begin(), b_labels.end(), a_labels[axis_a]) > 0) throw std::runtime_error("repeated axis in tensordot");
+		b_labels[axis_b] = a_labels[axis_a];
+	}
+
+	std::string output;
+	for (const char label : a_labels) {
+		if (b_labels.find(label) == std::string::npos) output += label;
+	}
+	for (std::size_t i = 0; i < b_shape.size(); ++i) {
+		if (b_labels[i] != '\0') continue;
+		b_labels[i] = static_cast<char>(first_internal_label + a_shape.size() + i);
+		output += b_labels[i];
+	}
+
+	contract(allocator, target, { &a, &b }, { a_labels, b_labels }, output);
+}
+
+void va::einsum(VStoreAllocator& allocator, const VArrayTarget& target, const std::string& subscripts, const std::vector<const VData*>& operands) {
+	const Subscripts parsed = parse_subscripts_cached(subscripts);
+	if (parsed.inputs.size() != operands.size()) throw std::runtime_error("einsum subscripts do not match the number of operands");
+
+	std::vector<std::size_t> ellipsis_dimensions(operands.size());
+	std::size_t broadcast_dimension = 0;
+	for (std::size_t i = 0; i < operands.size(); ++i) {
+		const bool has_ellipsis = parsed.inputs[i].find('.') != std::string::npos;
+		const std::size_t explicit_dimension = parsed.inputs[i].size() - (has_ellipsis ? 1 : 0);
+		const std::size_t dimension = va::dimension(*operands[i]);
+		if (has_ellipsis ? dimension < explicit_dimension : dimension != explicit_dimension) {
+			throw std::runtime_error("einsum subscripts do not match the dimension of an operand");
+		}
+		ellipsis_dimensions[i] = dimension - explicit_dimension;
+		broadcast_dimension = std::max(broadcast_dimension, ellipsis_dimensions[i]);
+	}
+	if (broadcast_dimension > max_internal_labels) throw std::runtime_error("too many dimensions for einsum");
+
+	std::vector<std::string> labels(operands.size());
+	for (std::size_t i = 0; i < operands.size(); ++i) {
+		labels[i] = expand_ellipsis(parsed.inputs[i], ellipsis_dimensions[i], broadcast_dimension);
+	}
+	contract(allocator, target, operands, labels, expand_ellipsis(parsed.output, broadcast_dimension, broadcast_dimension));
+}
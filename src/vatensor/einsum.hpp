@@ -0,0 +1,19 @@
+#ifndef VATENSOR_EINSUM_HPP
+#define VATENSOR_EINSUM_HPP
+
+#include <string>                          // for string
+#include <vector>                          // for vector
+
+#include "varray.hpp"
+
+namespace va {
+	// Sum of products over axes_a of a and axes_b of b, which are paired up in order.
+	// The result has the other axes of a, followed by the other axes of b.
+	void tensordot(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b, const axes_type& axes_a, const axes_type& axes_b);
+
+	// Einstein summation over the operands, like numpy.einsum, e.g. "ij,jk->ik".
+	// Supports ellipsis ("...") and implicit output. Axes of size 1 are broadcast.
+	void einsum(VStoreAllocator& allocator, const VArrayTarget& target, const std::string& subscripts, const std::vector<const VData*>& operands);
+}
+
+#endif //VATENSOR_EINSUM_HPP
@@ -0,0 +1,137 @@
+#ifndef VATENSOR_ELEMENTWISE_HPP
+#define VATENSOR_ELEMENTWISE_HPP
+
+#include <algorithm>                       // for equal, min
+#include <array>                           // for array
+#include <cstddef>                         // for size_t, ptrdiff_t
+#include <stdexcept>                       // for runtime_error
+#include <tuple>                           // for get, make_tuple
+#include <utility>                         // for index_sequence
+
+#include "dtype.hpp"
+#include "vparallel.hpp"
+
+// Element-wise functions with several outputs, on raw memory.
+// xtensor assigns one expression to one container, so functions like sincos would need one pass per output.
+// Here, all outputs are written in the same traversal of the inputs.
+namespace va::elementwise {
+	// Element strides of an operand, broadcast to shape. Broadcast axes have stride 0.
+	template <typename E>
+	strides_type broadcast_strides(const E& e, const shape_type& shape) {
+		strides_type result(shape.size(), 0);
+		const std::size_t offset = shape.size() - e.dimension();
+		for (std::size_t i = 0; i < e.dimension(); ++i) {
+			if (e.shape()[i] != 1) result[offset + i] = e.strides()[i];
+		}
+		return result;
+	}
+
+	// If all operands are row-major arrays of the shape, or single elements, they can be traversed as 1-D arrays.
+	// Replaces shape and strides by the 1-D equivalent in that case.
+	template <std::size_t N>
+	void try_flatten(shape_type& shape, std::array<strides_type, N>& strides) {
+		std::size_t size = 1;
+		for (const auto dim : shape) size *= dim;
+
+		std::array<strides_type, N> flat_strides;
+		for (std::size_t k = 0; k < N; ++k) {
+			bool is_row_major = true;
+			bool is_constant = true;
+			std::ptrdiff_t expected = 1;
+			for (std::size_t i = shape.size(); i-- > 0;) {
+				if (shape[i] == 1) continue;
+				is_row_major &= strides[k][i] == expected;
+				is_constant &= strides[k][i] == 0;
+				expected *= static_cast<std::ptrdiff_t>(shape[i]);
+			}
+			if (!is_row_major && !is_constant) return;
+			flat_strides[k] = strides_type { is_row_major ? 1 : 0 };
+		}
+
+		shape = shape_type { size };
+		strides = flat_strides;
+	}
+
+	template <typename F, typename Ptrs, std::size_t... I>
+	void call_at(const F& fn, const Ptrs& ptrs, const std::ptrdiff_t* offsets, std::index_sequence<I...>) {
+		fn(std::get<I>(ptrs)[offsets[I]]...);
+	}
+
+	// Calls fn(ptrs[k][offset_k]...) for the elements [begin, end) of shape, in row-major order.
+	// Walks like an odometer; the last axis is the inner loop.
+	template <std::size_t N, typename F, typename Ptrs>
+	void walk(const F& fn, const Ptrs& ptrs, const shape_type& shape, const std::array<strides_type, N>& strides, std::size_t begin, const std::size_t end) {
+		const std::size_t dimension = shape.size();
+		const std::size_t last = dimension - 1;
+
+		// Unravel begin.
+		shape_type index(dimension, 0);
+		std::array<std::ptrdiff_t, N> offsets {};
+		for (std::size_t i = dimension, rest = begin; i-- > 0;) {
+			index[i] = rest % shape[i];
+			rest /= shape[i];
+			for (std::size_t k = 0; k < N; ++k) offsets[k] += static_cast<std::ptrdiff_t>(index[i]) * strides[k][i];
+		}
+
+		std::array<std::ptrdiff_t, N> inner_strides;
+		for (std::size_t k = 0; k < N; ++k) inner_strides[k] = strides[k][last];
+
+		while (begin < end) {
+			const std::size_t inner = std::min(end - begin, shape[last] - index[last]);
+			std::array<std::ptrdiff_t, N> element_offsets = offsets;
+			for (std::size_t j = 0; j < inner; ++j) {
+				call_at(fn, ptrs, element_offsets.data(), std::make_index_sequence<N> {});
+				for (std::size_t k = 0; k < N; ++k) element_offsets[k] += inner_strides[k];
+			}
+			begin += inner;
+			if (begin == end) return;
+
+			// Carry to the next row.
+			for (std::size_t k = 0; k < N; ++k) offsets[k] -= static_cast<std::ptrdiff_t>(index[last]) * inner_strides[k];
+			index[last] = 0;
+			for (std::size_t i = last; i-- > 0;) {
+				if (++index[i] < shape[i]) {
+					for (std::size_t k = 0; k < N; ++k) offsets[k] += strides[k][i];
+					break;
+				}
+				for (std::size_t k = 0; k < N; ++k) offsets[k] -= static_cast<std::ptrdiff_t>(shape[i] - 1) * strides[k][i];
+				index[i] = 0;
+			}
+		}
+	}
+
+	// Calls fn(ret0[i], ret1[i], args[i]...) for all elements, so that both outputs are written in one pass.
+	// ret0 and ret1 must have the same shape. The args are broadcast to it.
+	template <typename R0, typename R1, typename F, typename... A>
+	void map2(R0& ret0, R1& ret1, const F& fn, const A&... args) {
+		constexpr std::size_t N = 2 + sizeof...(A);
+
+		shape_type shape(ret0.shape().begin(), ret0.shape().end());
+		if (!std::equal(shape.begin(), shape.end(), ret1.shape().begin(), ret1.shape().end())) {
+			throw std::runtime_error("internal error: outputs differ in shape");
+		}
+		const std::size_t size = ret0.size();
+		if (size == 0) return;
+
+		std::array<strides_type, N> strides { broadcast_strides(ret0, shape), broadcast_strides(ret1, shape), broadcast_strides(args, shape)... };
+		if (shape.empty()) {
+			shape = shape_type { 1 };
+			for (auto& operand_strides : strides) operand_strides = strides_type { 0 };
+		}
+		try_flatten(shape, strides);
+
+		const auto ptrs = std::make_tuple(ret0.data() + ret0.data_offset(), ret1.data() + ret1.data_offset(), (args.data() + args.data_offset())...);
+
+		const std::size_t chunks = parallel::num_chunks(size, size);
+		if (chunks <= 1) {
+			walk(fn, ptrs, shape, strides, 0, size);
+			return;
+		}
+		parallel::run(chunks, [&fn, &ptrs, &shape, &strides, chunks, size](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, size);
+			walk(fn, ptrs, shape, strides, begin, end);
+		});
+	}
+}
+
+#endif //VATENSOR_ELEMENTWISE_HPP
@@ -0,0 +1,330 @@
+#ifndef VATENSOR_GATHER_HPP
+#define VATENSOR_GATHER_HPP
+
+#include <algorithm>                       // for copy_n, fill_n
+#include <cstddef>                         // for size_t, ptrdiff_t
+#include <cstdint>                         // for uint64_t
+#include <cstring>                         // for memcpy
+#include <memory>                          // for unique_ptr
+#include <numeric>                         // for accumulate
+#include <stdexcept>                       // for runtime_error
+#include <vector>                          // for vector
+
+#include "dtype.hpp"
+#include "vparallel.hpp"
+
+// Gather / scatter on raw memory, by element offsets.
+// The loops are kept free of branches so that the compiler can use SIMD gathers where the ISA has them.
+namespace va::gather {
+	// Writes the indices as offsets in [0, size), wrapping negative indices once.
+	template <typename I>
+	void normalize_indices(std::ptrdiff_t* out, const I* indices, const std::size_t count, const std::ptrdiff_t stride, const std::size_t size) {
+		const auto size_ = static_cast<std::ptrdiff_t>(size);
+
+		bool is_out_of_bounds = false;
+		for (std::size_t i = 0; i < count; ++i) {
+			std::ptrdiff_t index = static_cast<std::ptrdiff_t>(indices[static_cast<std::ptrdiff_t>(i) * stride]);
+			index += (index < 0) * size_;
+			is_out_of_bounds |= (index < 0) | (index >= size_);
+			out[i] = index;
+		}
+		if (is_out_of_bounds) throw std::runtime_error("index out of bounds");
+	}
+
+	// Writes the element offset of each row of an index list (count x dimension) into an array of the given shape and strides.
+	template <typename I>
+	void index_list_offsets(std::ptrdiff_t* out, const I* indices, const std::size_t count, const std::ptrdiff_t row_stride, const std::ptrdiff_t col_stride, const shape_type& shape, const strides_type& strides) {
+		const std::size_t dimension = shape.size();
+
+		std::fill_n(out, count, 0);
+		bool is_out_of_bounds = false;
+		// Dimension by dimension, so that the inner loop runs over the whole list.
+		for (std::size_t d = 0; d < dimension; ++d) {
+			const auto size = static_cast<std::ptrdiff_t>(shape[d]);
+			const std::ptrdiff_t stride = strides[d];
+			const I* column = indices + static_cast<std::ptrdiff_t>(d) * col_stride;
+
+			for (std::size_t i = 0; i < count; ++i) {
+				std::ptrdiff_t index = static_cast<std::ptrdiff_t>(column[static_cast<std::ptrdiff_t>(i) * row_stride]);
+				index += (index < 0) * size;
+				is_out_of_bounds |= (index < 0) | (index >= size);
+				out[i] += index * stride;
+			}
+		}
+		if (is_out_of_bounds) throw std::runtime_error("index out of bounds");
+	}
+
+	// out[i] = base[offsets[i]]
+	template <typename T>
+	void gather(T* __restrict out, const T* base, const std::ptrdiff_t* __restrict offsets, const std::size_t count) {
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = base[offsets[i]];
+		}
+	}
+
+	// base[offsets[i]] = values[i * values_stride]
+	// With duplicate offsets, the last value wins.
+	template <typename T>
+	void scatter(T* base, const std::ptrdiff_t* offsets, const std::size_t count, const T* values, const std::ptrdiff_t values_stride) {
+		for (std::size_t i = 0; i < count; ++i) {
+			base[offsets[i]] = values[static_cast<std::ptrdiff_t>(i) * values_stride];
+		}
+	}
+
+	// For contiguous src of shape (outer, axis_size, inner), writes src[:, indices, :] to out, of shape (outer, count, inner).
+	template <typename T>
+	void take(T* __restrict out, const T* __restrict src, const std::ptrdiff_t* indices, const std::size_t count, const std::size_t outer, const std::size_t axis_size, const std::size_t inner) {
+		for (std::size_t o = 0; o < outer; ++o) {
+			const T* src_block = src + o * axis_size * inner;
+
+			if (inner == 1) {
+				gather(out, src_block, indices, count);
+				out += count;
+				continue;
+			}
+
+			for (std::size_t k = 0; k < count; ++k) {
+				std::copy_n(src_block + indices[k] * static_cast<std::ptrdiff_t>(inner), inner, out);
+				out += inner;
+			}
+		}
+	}
+
+	// The inverse of take: writes values, of shape (outer, count, inner), to dst[:, indices, :].
+	// If values_stride is 0, the first value is written everywhere.
+	template <typename T>
+	void put(T* dst, const std::ptrdiff_t* indices, const std::size_t count, const std::size_t outer, const std::size_t axis_size, const std::size_t inner, const T* values, const std::ptrdiff_t values_stride) {
+		for (std::size_t o = 0; o < outer; ++o) {
+			T* dst_block = dst + o * axis_size * inner;
+
+			for (std::size_t k = 0; k < count; ++k) {
+				T* dst_row = dst_block + indices[k] * static_cast<std::ptrdiff_t>(inner);
+				for (std::size_t j = 0; j < inner; ++j) {
+					dst_row[j] = *values;
+					values += values_stride;
+				}
+			}
+		}
+	}
+
+	// For each k in [0, count) and j in [0, inner): row = base + indices[k] * inner; row[j] = op(row[j], value).
+	// Values are read in order, values_stride apart. Unlike put, duplicate indices accumulate.
+	template <typename T, typename I, typename Op>
+	void scatter_reduce(T* base, const I* indices, const std::size_t count, const std::size_t inner, const T* values, const std::ptrdiff_t values_stride, const Op& op) {
+		for (std::size_t k = 0; k < count; ++k) {
+			T* row = base + static_cast<std::ptrdiff_t>(indices[k]) * static_cast<std::ptrdiff_t>(inner);
+			for (std::size_t j = 0; j < inner; ++j) {
+				row[j] = op(row[j], *values);
+				values += values_stride;
+			}
+		}
+	}
+
+	// scatter_reduce into a target of target_rows x inner elements.
+	// Large inputs are split across threads, each reducing into a private copy of the target filled with identity.
+	// The copies are then combined into base.
+	template <typename T, typename I, typename Op>
+	void parallel_scatter_reduce(T* base, const std::size_t target_rows, const I* indices, const std::size_t count, const std::size_t inner, const T* values, const std::ptrdiff_t values_stride, const T identity, const Op& op) {
+		const std::size_t target_size = target_rows * inner;
+		const std::size_t size = count * inner;
+		// Each private copy costs a pass over the target, so every thread needs at least as many inputs.
+		const std::size_t chunks = std::min(parallel::num_chunks(size, count), size / std::max<std::size_t>(target_size, 1));
+
+		if (chunks <= 1) {
+			scatter_reduce(base, indices, count, inner, values, values_stride, op);
+			return;
+		}
+
+		const std::unique_ptr<T[]> partials(new T[chunks * target_size]);
+		parallel::run(chunks, [&](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, count);
+			T* partial = partials.get() + chunk * target_size;
+
+			std::fill_n(partial, target_size, identity);
+			scatter_reduce(partial, indices + begin, end - begin, inner, values + static_cast<std::ptrdiff_t>(begin * inner) * values_stride, values_stride, op);
+		});
+
+		// Split over the target, so that no two threads write the same element.
+		const std::size_t combine_chunks = parallel::num_chunks(target_size * chunks, target_size);
+		parallel::run(combine_chunks, [&](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, combine_chunks, target_size);
+
+			for (std::size_t c = 0; c < chunks; ++c) {
+				const T* partial = partials.get() + c * target_size;
+				for (std::size_t i = begin; i < end; ++i) base[i] = op(base[i], partial[i]);
+			}
+		});
+	}
+
+	// scatter_reduce with contiguous values, for ids sorted in ascending order.
+	// Every run of equal ids is reduced by a single thread, so threads never write the same row.
+	template <typename T, typename I, typename Op>
+	void sorted_segment_reduce(T* base, const I* ids, const std::size_t count, const std::size_t inner, const T* values, const Op& op) {
+		const std::size_t chunks = parallel::num_chunks(count * inner, count);
+
+		parallel::run(chunks, [&](const std::size_t chunk) {
+			auto [begin, end] = parallel::chunk_range(chunk, chunks, count);
+			// Move both bounds past the run they split, so that every run falls into a single chunk.
+			while (begin > 0 && begin < count && ids[begin] == ids[begin - 1]) ++begin;
+			while (end > 0 && end < count && ids[end] == ids[end - 1]) ++end;
+			if (begin >= end) return;
+
+			scatter_reduce(base, ids + begin, end - begin, inner, values + begin * inner, 1, op);
+		});
+	}
+
+	// Masks are processed 8 bools at a time, read as one word.
+	// Words of all false or all true are skipped or copied as a block, which is the common case for masks with large regions.
+	static constexpr std::size_t mask_word_size = 8;
+	static constexpr std::uint64_t mask_word_true = 0x0101010101010101;
+
+	inline std::uint64_t mask_word(const bool* mask) {
+		std::uint64_t word;
+		std::memcpy(&word, mask, mask_word_size);
+		return word;
+	}
+
+	template <typename T>
+	std::size_t count_nonzero(const T* data, const std::size_t size) {
+		// Compares summed into bytes vectorize best; 255 elements at a time cannot overflow them.
+		std::size_t count = 0;
+		for (std::size_t begin = 0; begin < size; begin += 255) {
+			const std::size_t end = std::min<std::size_t>(size, begin + 255);
+			std::uint8_t partial = 0;
+			for (std::size_t i = begin; i < end; ++i) partial += data[i] != T(0);
+			count += partial;
+		}
+		return count;
+	}
+
+	inline std::size_t count_true(const bool* mask, const std::size_t size) {
+		return count_nonzero(mask, size);
+	}
+
+	template <typename T>
+	std::size_t parallel_count_nonzero(const T* data, const std::size_t size) {
+		const std::size_t chunks = parallel::num_chunks(size, size);
+		if (chunks <= 1) return count_nonzero(data, size);
+
+		std::vector<std::size_t> counts(chunks, 0);
+		parallel::run(chunks, [&counts, data, chunks, size](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, size);
+			counts[chunk] = count_nonzero(data + begin, end - begin);
+		});
+		return std::accumulate(counts.begin(), counts.end(), std::size_t(0));
+	}
+
+	// ret[j] = count_nonzero of the j-th run of inner elements.
+	template <typename R, typename T>
+	void parallel_count_nonzero_rows(R* ret, const T* data, const std::size_t outer, const std::size_t inner) {
+		const std::size_t chunks = parallel::num_chunks(outer * inner, outer);
+		parallel::run(chunks, [ret, data, chunks, outer, inner](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, outer);
+			for (std::size_t j = begin; j < end; ++j) {
+				ret[j] = static_cast<R>(count_nonzero(data + j * inner, inner));
+			}
+		});
+	}
+
+	// Writes the elements of src where mask is true to out, in order.
+	template <typename T>
+	void compress(T* __restrict out, const T* __restrict src, const bool* __restrict mask, const std::size_t size) {
+		std::size_t i = 0;
+		for (; i + mask_word_size <= size; i += mask_word_size) {
+			const std::uint64_t word = mask_word(mask + i);
+			if (word == 0) continue;
+			if (word == mask_word_true) {
+				std::copy_n(src + i, mask_word_size, out);
+				out += mask_word_size;
+				continue;
+			}
+
+			// Branch-free: every element is written to the block, but only the selected ones advance it.
+			T block[mask_word_size];
+			std::size_t count = 0;
+			for (std::size_t j = 0; j < mask_word_size; ++j) {
+				block[count] = src[i + j];
+				count += mask[i + j];
+			}
+			std::copy_n(block, count, out);
+			out += count;
+		}
+		for (; i < size; ++i) {
+			if (mask[i]) *out++ = src[i];
+		}
+	}
+
+	// The inverse of compress: writes values, in order, to the elements of dst where mask is true.
+	template <typename T>
+	void expand(T* __restrict dst, const T* __restrict values, const bool* __restrict mask, const std::size_t size) {
+		std::size_t i = 0;
+		for (; i + mask_word_size <= size; i += mask_word_size) {
+			const std::uint64_t word = mask_word(mask + i);
+			if (word == 0) continue;
+			if (word == mask_word_true) {
+				std::copy_n(values, mask_word_size, dst + i);
+				values += mask_word_size;
+				continue;
+			}
+
+			for (std::size_t j = 0; j < mask_word_size; ++j) {
+				if (mask[i + j]) dst[i + j] = *values++;
+			}
+		}
+		for (; i < size; ++i) {
+			if (mask[i]) dst[i] = *values++;
+		}
+	}
+
+	// dst[i] = mask[i] ? value : dst[i]
+	template <typename T>
+	void masked_fill(T* __restrict dst, const bool* __restrict mask, const std::size_t size, const T value) {
+		for (std::size_t i = 0; i < size; ++i) {
+			dst[i] = mask[i] ? value : dst[i];
+		}
+	}
+
+	// Splits a mask into chunks for parallel compress / expand.
+	// Returns the number of true values before each chunk, and the total at the end.
+	inline std::vector<std::size_t> mask_chunk_offsets(const bool* mask, const std::size_t size) {
+		const std::size_t chunks = parallel::num_chunks(size, size);
+
+		std::vector<std::size_t> offsets(chunks + 1, 0);
+		parallel::run(chunks, [&offsets, mask, chunks, size](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, size);
+			offsets[chunk + 1] = count_true(mask + begin, end - begin);
+		});
+		for (std::size_t chunk = 0; chunk < chunks; ++chunk) offsets[chunk + 1] += offsets[chunk];
+
+		return offsets;
+	}
+
+	template <typename T>
+	void parallel_compress(T* out, const T* src, const bool* mask, const std::size_t size, const std::vector<std::size_t>& offsets) {
+		const std::size_t chunks = offsets.size() - 1;
+		parallel::run(chunks, [&offsets, out, src, mask, chunks, size](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, size);
+			compress(out + offsets[chunk], src + begin, mask + begin, end - begin);
+		});
+	}
+
+	template <typename T>
+	void parallel_expand(T* dst, const T* values, const bool* mask, const std::size_t size, const std::vector<std::size_t>& offsets) {
+		const std::size_t chunks = offsets.size() - 1;
+		parallel::run(chunks, [&offsets, dst, values, mask, chunks, size](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, size);
+			expand(dst + begin, values + offsets[chunk], mask + begin, end - begin);
+		});
+	}
+
+	template <typename T>
+	void parallel_masked_fill(T* dst, const bool* mask, const std::size_t size, const T value) {
+		const std::size_t chunks = parallel::num_chunks(size, size);
+		parallel::run(chunks, [dst, mask, chunks, size, value](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, size);
+			masked_fill(dst + begin, mask + begin, end - begin, value);
+		});
+	}
+}
+
+#endif //VATENSOR_GATHER_HPP
@@ -0,0 +1,250 @@
+#ifndef VATENSOR_GEMM_HPP
+#define VATENSOR_GEMM_HPP
+
+#include <algorithm>                       // for min, fill_n
+#include <complex>                         // for complex
+#include <cstddef>                         // for size_t, ptrdiff_t
+#include <memory>                          // for unique_ptr
+
+#include "util.hpp"
+#include "vparallel.hpp"
+
+// Matrix products on raw strided memory, for float, double and their complex types.
+// The kernels are written in plain C++ so that the compiler can vectorize the micro-kernel's inner loop.
+namespace va::gemm {
+	// A strided 2-D view of memory. Strides are in elements, and may be 0 or negative.
+	template <typename T>
+	struct Matrix {
+		T* ptr;
+		std::ptrdiff_t row_stride;
+		std::ptrdiff_t col_stride;
+
+		T& operator()(const std::size_t row, const std::size_t col) const {
+			return ptr[static_cast<std::ptrdiff_t>(row) * row_stride + static_cast<std::ptrdiff_t>(col) * col_stride];
+		}
+	};
+
+	// acc += a * b. std::complex multiplication checks for inf / nan, which prevents vectorization.
+	template <typename T>
+	inline void multiply_add(T& acc, const T a, const T b) {
+		acc += a * b;
+	}
+
+	template <typename T>
+	inline void multiply_add(std::complex<T>& acc, const std::complex<T> a, const std::complex<T> b) {
+		acc += util::complex_multiply(a, b);
+	}
+
+	// Register tile: MR rows x NR columns of C are accumulated at once. NR fills a 64 byte cache line.
+	template <typename T>
+	struct Blocking {
+		static constexpr std::size_t MR = 4;
+		static constexpr std::size_t NR = std::max<std::size_t>(64 / sizeof(T), 2);
+		// A panels (MC x KC) stay in L2, B micro-panels (KC x NR) in L1.
+		static constexpr std::size_t KC = 256;
+		static constexpr std::size_t MC = 96;
+		static constexpr std::size_t NC = 2048;
+	};
+
+	// Below this many multiply-adds, packing costs more than it saves.
+	static constexpr std::size_t min_blocked_size = 32 * 32 * 32;
+
+	// Copies rows [row, row + mc) and cols [col, col + kc) of a into MR-row micro-panels, zero padded.
+	template <typename T>
+	void pack_a(T* dst, const Matrix<const T>& a, const std::size_t row, const std::size_t mc, const std::size_t col, const std::size_t kc) {
+		constexpr std::size_t MR = Blocking<T>::MR;
+
+		for (std::size_t ir = 0; ir < mc; ir += MR) {
+			const std::size_t mr = std::min(MR, mc - ir);
+			for (std::size_t p = 0; p < kc; ++p) {
+				for (std::size_t i = 0; i < mr; ++i) dst[i] = a(row + ir + i, col + p);
+				std::fill_n(dst + mr, MR - mr, T(0));
+				dst += MR;
+			}
+		}
+	}
+
+	// Copies rows [row, row + kc) and cols [col, col + nc) of b into NR-column micro-panels, zero padded.
+	template <typename T>
+	void pack_b(T* dst, const Matrix<const T>& b, const std::size_t row, const std::size_t kc, const std::size_t col, const std::size_t nc) {
+		constexpr std::size_t NR = Blocking<T>::NR;
+
+		for (std::size_t jr = 0; jr < nc; jr += NR) {
+			const std::size_t nr = std::min(NR, nc - jr);
+			for (std::size_t p = 0; p < kc; ++p) {
+				for (std::size_t j = 0; j < nr; ++j) dst[j] = b(row + p, col + jr + j);
+				std::fill_n(dst + nr, NR - nr, T(0));
+				dst += NR;
+			}
+		}
+	}
+
+	// Computes an MR x NR tile of a_panel * b_panel, and writes (or adds, if accumulate) its top left mr x nr corner to c.
+	template <typename T>
+	void micro_kernel(const std::size_t kc, const T* __restrict a_panel, const T* __restrict b_panel, T* c, const std::ptrdiff_t c_row_stride, const std::ptrdiff_t c_col_stride, const std::size_t mr, const std::size_t nr, const bool accumulate) {
+		constexpr std::size_t MR = Blocking<T>::MR;
+		constexpr std::size_t NR = Blocking<T>::NR;
+
+		T acc[MR][NR] = {};
+		for (std::size_t p = 0; p < kc; ++p) {
+			for (std::size_t i = 0; i < MR; ++i) {
+				const T a_ip = a_panel[i];
+				for (std::size_t j = 0; j < NR; ++j) {
+					multiply_add(acc[i][j], a_ip, b_panel[j]);
+				}
+			}
+			a_panel += MR;
+			b_panel += NR;
+		}
+
+		for (std::size_t i = 0; i < mr; ++i) {
+			T* c_row = c + static_cast<std::ptrdiff_t>(i) * c_row_stride;
+			for (std::size_t j = 0; j < nr; ++j) {
+				T& c_ij = c_row[static_cast<std::ptrdiff_t>(j) * c_col_stride];
+				c_ij = accumulate ? c_ij + acc[i][j] : acc[i][j];
+			}
+		}
+	}
+
+	// c = a * b for small matrices, without packing.
+	template <typename T>
+	void gemm_small(const std::size_t m, const std::size_t n, const std::size_t k, const Matrix<const T>& a, const Matrix<const T>& b, const Matrix<T>& c) {
+		for (std::size_t i = 0; i < m; ++i) {
+			for (std::size_t j = 0; j < n; ++j) c(i, j) = T(0);
+			for (std::size_t p = 0; p < k; ++p) {
+				const T a_ip = a(i, p);
+				for (std::size_t j = 0; j < n; ++j) multiply_add(c(i, j), a_ip, b(p, j));
+			}
+		}
+	}
+
+	// c = a * b, with a: m x k, b: k x n, c: m x n.
+	// c must not overlap a or b.
+	template <typename T>
+	void gemm(const std::size_t m, const std::size_t n, const std::size_t k, const Matrix<const T>& a, const Matrix<const T>& b, const Matrix<T>& c) {
+		using B = Blocking<T>;
+
+		if (m == 0 || n == 0) return;
+		if (k == 0) {
+			for (std::size_t i = 0; i < m; ++i) for (std::size_t j = 0; j < n; ++j) c(i, j) = T(0);
+			return;
+		}
+		if (m * n * k < min_blocked_size) {
+			gemm_small(m, n, k, a, b, c);
+			return;
+		}
+
+		const std::size_t row_blocks = (m + B::MC - 1) / B::MC;
+		const bool is_parallel = parallel::num_chunks(m * n * k, row_blocks) > 1;
+
+		const std::unique_ptr<T[]> b_pack(new T[B::KC * ((std::min(n, B::NC) + B::NR - 1) / B::NR * B::NR)]);
+		// Only used when not parallel; parallel row blocks pack into their own buffer.
+		const std::unique_ptr<T[]> a_pack(is_parallel ? nullptr : new T[B::MC * B::KC]);
+
+		for (std::size_t jc = 0; jc < n; jc += B::NC) {
+			const std::size_t nc = std::min(B::NC, n - jc);
+
+			for (std::size_t pc = 0; pc < k; pc += B::KC) {
+				const std::size_t kc = std::min(B::KC, k - pc);
+				pack_b(b_pack.get(), b, pc, kc, jc, nc);
+
+				const auto row_block = [&, jc, nc, pc, kc](const std::size_t block, T* a_pack_) {
+					const std::size_t ic = block * B::MC;
+					const std::size_t mc = std::min(B::MC, m - ic);
+					pack_a(a_pack_, a, ic, mc, pc, kc);
+
+					for (std::size_t jr = 0; jr < nc; jr += B::NR) {
+						for (std::size_t ir = 0; ir < mc; ir += B::MR) {
+							micro_kernel<T>(
+								kc,
+								a_pack_ + ir * kc,
+								b_pack.get() + jr * kc,
+								&c(ic + ir, jc + jr), c.row_stride, c.col_stride,
+								std::min(B::MR, mc - ir), std::min(B::NR, nc - jr),
+								pc > 0
+							);
+						}
+					}
+				};
+
+				if (is_parallel) {
+					parallel::run(row_blocks, [&row_block](const std::size_t block) {
+						const std::unique_ptr<T[]> a_pack_(new T[B::MC * B::KC]);
+						row_block(block, a_pack_.get());
+					});
+				}
+				else {
+					for (std::size_t block = 0; block < row_blocks; ++block) row_block(block, a_pack.get());
+				}
+			}
+		}
+	}
+
+	// c = a * x, with a: m x k, x: k elements, c: m elements.
+	template <typename T>
+	void gemv(const std::size_t m, const std::size_t k, const Matrix<const T>& a, const T* x, const std::ptrdiff_t x_stride, T* c, const std::ptrdiff_t c_stride) {
+		const auto row_dot = [&](const std::size_t i) {
+			T acc = T(0);
+			const T* a_row = &a(i, 0);
+			if (a.col_stride == 1 && x_stride == 1) {
+				for (std::size_t p = 0; p < k; ++p) multiply_add(acc, a_row[p], x[p]);
+			}
+			else {
+				for (std::size_t p = 0; p < k; ++p) {
+					multiply_add(acc, a_row[static_cast<std::ptrdiff_t>(p) * a.col_stride], x[static_cast<std::ptrdiff_t>(p) * x_stride]);
+				}
+			}
+			c[static_cast<std::ptrdiff_t>(i) * c_stride] = acc;
+		};
+
+		if (m == 0) return;
+		if (k == 0) {
+			for (std::size_t i = 0; i < m; ++i) c[static_cast<std::ptrdiff_t>(i) * c_stride] = T(0);
+			return;
+		}
+
+		// Rows are independent, so chunks never write to the same element.
+		const std::size_t chunks = parallel::num_chunks(m * k, m);
+		parallel::run(chunks, [&row_dot, chunks, m](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, m);
+			for (std::size_t i = begin; i < end; ++i) row_dot(i);
+		});
+	}
+
+	// c = x * b, with x: k elements, b: k x n, c: n elements.
+	// Accumulates rows of b, so that contiguous rows are read in order.
+	template <typename T>
+	void gevm(const std::size_t n, const std::size_t k, const T* x, const std::ptrdiff_t x_stride, const Matrix<const T>& b, T* c, const std::ptrdiff_t c_stride) {
+		if (b.col_stride != 1 && b.row_stride == 1) {
+			// Columns are contiguous; this is a gemv on b transposed.
+			gemv<T>(n, k, Matrix<const T> { b.ptr, b.col_stride, b.row_stride }, x, x_stride, c, c_stride);
+			return;
+		}
+
+		const auto columns = [&](const std::size_t begin, const std::size_t end) {
+			const std::size_t count = end - begin;
+			const std::unique_ptr<T[]> acc(new T[count]());
+			for (std::size_t p = 0; p < k; ++p) {
+				const T x_p = x[static_cast<std::ptrdiff_t>(p) * x_stride];
+				const T* b_row = &b(p, begin);
+				if (b.col_stride == 1) {
+					for (std::size_t j = 0; j < count; ++j) multiply_add(acc[j], x_p, b_row[j]);
+				}
+				else {
+					for (std::size_t j = 0; j < count; ++j) multiply_add(acc[j], x_p, b_row[static_cast<std::ptrdiff_t>(j) * b.col_stride]);
+				}
+			}
+			for (std::size_t j = 0; j < count; ++j) c[static_cast<std::ptrdiff_t>(begin + j) * c_stride] = acc[j];
+		};
+
+		if (n == 0) return;
+
+		const std::size_t chunks = parallel::num_chunks(n * k, n);
+		parallel::run(chunks, [&columns, chunks, n](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, n);
+			columns(begin, end);
+		});
+	}
+}
+
+#endif //VATENSOR_GEMM_HPP
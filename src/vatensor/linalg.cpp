@@ -1,17 +1,30 @@
 #include "linalg.hpp"
 
+#include <algorithm>              // for fill_n, min
+#include <array>                  // for array
 #include <cstddef>                // for ptrdiff_t
+#include <functional>             // for multiplies
+#include <numeric>                // for accumulate, iota
 #include <optional>               // for optional
 #include <stdexcept>              // for runtime_error
+#include <string>                 // for string
+#include <tuple>                  // for tuple
+#include <type_traits>            // for remove_pointer_t
+#include <utility>                // for pair, swap
 #include <vector>                 // for vector
-#include <godot_cpp/core/math.hpp>
 #include <xtensor/views/xview.hpp>
 #include "vfunc/entrypoints.hpp"
 #include "create.hpp"
+#include "decompose.hpp"
+#include "einsum.hpp"
+#include "elementwise.hpp"
+#include "gemm.hpp"
 #include "rearrange.hpp"
 #include "util.hpp"
 #include "varray.hpp"      // for VArray, VArrayTarget, VScalar, axes...
+#include "vcall.hpp"
 #include "vcompute.hpp"
+#include "vparallel.hpp"
 #include "xtensor_store.hpp"
 #include "xtensor/views/xslice.hpp"     // for all, ellipsis, newaxis, xall_tag
 
@@ -26,7 +39,158 @@ void va::dot(VStoreAllocator& allocator, const VArrayTarget& target, const VData
 		return;
 	}
 
-	throw std::runtime_error("tensordot is not yet implemented");
+	// Sum over the last axis of a and the second-to-last of b (or its only axis).
+	va::tensordot(allocator, target, a, b, { -1 }, { va::dimension(b) >= 2 ? -2 : 0 });
+}
+
+namespace {
+	// out = a x b, where a and b have A and B components (3, or 2 with z = 0), stride a_stride and b_stride apart.
+	// The 2-D cases skip the products with the missing z.
+	template <std::size_t A, std::size_t B, typename T>
+	void cross_at(const T* a, const std::ptrdiff_t a_stride, const T* b, const std::ptrdiff_t b_stride, T* out, const std::ptrdiff_t out_stride) {
+		const T ax = a[0];
+		const T ay = a[a_stride];
+		const T bx = b[0];
+		const T by = b[b_stride];
+
+		T x, y;
+		if constexpr (A == 3 && B == 3) {
+			const T az = a[2 * a_stride];
+			const T bz = b[2 * b_stride];
+			x = ay * bz - az * by;
+			y = az * bx - ax * bz;
+		}
+		else if constexpr (A == 2) {
+			const T bz = b[2 * b_stride];
+			x = ay * bz;
+			y = -(ax * bz);
+		}
+		else {
+			const T az = a[2 * a_stride];
+			x = -(az * by);
+			y = az * bx;
+		}
+
+		out[0] = x;
+		out[out_stride] = y;
+		out[2 * out_stride] = ax * by - ay * bx;
+	}
+
+	// Cross products of the vectors along the last axis of a and b, into out, which has 3 components along out_axis.
+	// Each vector is read once, and all 3 components are written in the same pass.
+	template <std::size_t A, std::size_t B, typename T>
+	void cross_vectors(const va::compute_case<T*>& a, const va::compute_case<T*>& b, va::compute_case<T*>& out, const std::size_t out_axis) {
+		va::shape_type shape;
+		std::array<va::strides_type, 3> strides;
+		for (std::size_t i = 0; i < out.dimension(); ++i) {
+			if (i == out_axis) continue;
+			shape.push_back(out.shape()[i]);
+			strides[0].push_back(out.strides()[i]);
+		}
+
+		// Strides of the vectors in a and b, broadcast to shape.
+		const auto batch_strides = [&shape](const auto& e) {
+			const std::size_t dimension = e.dimension() - 1;
+			const std::size_t offset = shape.size() - dimension;
+			va::strides_type result(shape.size(), 0);
+			for (std::size_t i = 0; i < dimension; ++i) {
+				if (e.shape()[i] != 1) result[offset + i] = e.strides()[i];
+			}
+			return result;
+		};
+		strides[1] = batch_strides(a);
+		strides[2] = batch_strides(b);
+
+		const std::size_t size = std::accumulate(shape.begin(), shape.end(), std::size_t { 1 }, std::multiplies<>());
+		if (size == 0) return;
+
+		T* out_ptr = out.data() + out.data_offset();
+		const T* a_ptr = a.data() + a.data_offset();
+		const T* b_ptr = b.data() + b.data_offset();
+		const std::ptrdiff_t out_stride = out.strides()[out_axis];
+		const std::ptrdiff_t a_stride = a.strides().back();
+		const std::ptrdiff_t b_stride = b.strides().back();
+
+		const auto run = [size](const auto& fn) {
+			const std::size_t chunks = va::parallel::num_chunks(size, size);
+			va::parallel::run(chunks, [&fn, chunks, size](const std::size_t chunk) {
+				const auto [begin, end] = va::parallel::chunk_range(chunk, chunks, size);
+				fn(begin, end);
+			});
+		};
+
+		// Whether the vectors are packed one after the other, like in [N, 3] arrays from PackedVector3Array.
+		const auto is_packed = [&shape](const va::strides_type& vector_strides, const std::ptrdiff_t component_stride, const std::size_t count) {
+			if (component_stride != 1) return false;
+			std::ptrdiff_t expected = static_cast<std::ptrdiff_t>(count);
+			for (std::size_t i = shape.size(); i-- > 0;) {
+				if (shape[i] == 1) continue;
+				if (vector_strides[i] != expected) return false;
+				expected *= static_cast<std::ptrdiff_t>(shape[i]);
+			}
+			return true;
+		};
+
+		if (is_packed(strides[0], out_stride, 3) && is_packed(strides[1], a_stride, A) && is_packed(strides[2], b_stride, B)) {
+			// Compile-time strides, so that the compiler can vectorize the loop.
+			run([out_ptr, a_ptr, b_ptr](const std::size_t begin, const std::size_t end) {
+				for (std::size_t i = begin; i < end; ++i) {
+					cross_at<A, B>(a_ptr + i * A, 1, b_ptr + i * B, 1, out_ptr + i * 3, 1);
+				}
+			});
+			return;
+		}
+
+		if (shape.empty()) {
+			shape = va::shape_type { 1 };
+			strides = { va::strides_type { 0 }, va::strides_type { 0 }, va::strides_type { 0 } };
+		}
+		va::elementwise::try_flatten(shape, strides);
+		const auto ptrs = std::make_tuple(out_ptr, a_ptr, b_ptr);
+		const auto cross = [a_stride, b_stride, out_stride](T& out_, const T& a_, const T& b_) {
+			cross_at<A, B>(&a_, a_stride, &b_, b_stride, &out_, out_stride);
+		};
+		run([&cross, &ptrs, &shape, &strides](const std::size_t begin, const std::size_t end) {
+			va::elementwise::walk(cross, ptrs, shape, strides, begin, end);
+		});
+	}
+
+	// Runs cross_vectors if a, b and target have the same non-bool dtype, and a and b are broadcast to target.
+	// Returns false otherwise, so that the caller can fall back to the generic functions.
+	bool assign_cross_vectors(va::VData& target, const va::VData& a, const va::VData& b, const std::size_t target_axis) {
+		const va::DType dtype = va::dtype(target);
+		if (va::dtype(a) != dtype || va::dtype(b) != dtype || dtype == va::Bool) return false;
+
+		const std::size_t a_size = va::shape(a).back();
+		const std::size_t b_size = va::shape(b).back();
+		if (a_size < 2 || a_size > 3 || b_size < 2 || b_size > 3 || a_size + b_size == 4) return false;
+
+		const auto& target_shape = va::shape(target);
+		if (target_shape[target_axis] != 3) return false;
+		for (const auto* operand : { &a, &b }) {
+			const auto& shape = va::shape(*operand);
+			if (shape.size() > target_shape.size()) return false;
+			// The batch axes of the operand, aligned to the right of the batch axes of target.
+			const std::size_t offset = target_shape.size() - shape.size();
+			for (std::size_t i = 0; i + 1 < shape.size(); ++i) {
+				const std::size_t target_i = offset + i + (offset + i >= target_axis ? 1 : 0);
+				if (shape[i] != 1 && shape[i] != target_shape[target_i]) return false;
+			}
+		}
+
+		std::visit([&](auto& target_array) {
+			using T = typename std::decay_t<decltype(target_array)>::value_type;
+
+			if constexpr (!std::is_same_v<T, bool>) {
+				const auto& a_array = std::get<va::compute_case<T*>>(a);
+				const auto& b_array = std::get<va::compute_case<T*>>(b);
+				if (a_size == 3 && b_size == 3) cross_vectors<3, 3>(a_array, b_array, target_array, target_axis);
+				else if (a_size == 2) cross_vectors<2, 3>(a_array, b_array, target_array, target_axis);
+				else cross_vectors<3, 2>(a_array, b_array, target_array, target_axis);
+			}
+		}, target);
+		return true;
+	}
 }
 
 void assign_cross(va::VData& target, const va::VData& a, const va::VData& b, const std::ptrdiff_t target_axis) {
@@ -36,6 +200,9 @@ void assign_cross(va::VData& target, const va::VData& a, const va::VData& b, con
 	auto dummy_allocator = va::store::default_allocator;  // Not needed
 
 	const auto target_axis_normal = va::util::normalize_axis(target_axis, va::dimension(target));
+	if (assign_cross_vectors(target, a, b, target_axis_normal)) {
+		return;
+	}
 
 	xt::xstrided_slice_vector slice(target_axis_normal + 1);
 	std::fill_n(slice.begin(), target_axis_normal, xt::all());
@@ -149,10 +316,152 @@ void va::cross(::va::VStoreAllocator& allocator, const VArrayTarget& target, con
 	}, target);
 }
 
+namespace {
+	bool is_gemm_dtype(const va::DType dtype) {
+		return dtype == va::Float32 || dtype == va::Float64 || dtype == va::Complex64 || dtype == va::Complex128;
+	}
+
+	// Moves a result that was computed into a new array to the target.
+	void assign_result(const va::VArrayTarget& target, const std::shared_ptr<va::VArray>& result) {
+		if (const auto target_data = std::get_if<va::VData*>(&target)) {
+			va::assign(**target_data, result->data);
+		}
+		else {
+			*std::get<std::shared_ptr<va::VArray>*>(target) = result;
+		}
+	}
+
+	// Offset of the batch element at index in a, where a's batch dimensions are broadcast to the right of index.
+	std::ptrdiff_t batch_offset(const va::shape_type& index, const va::shape_type& shape, const va::strides_type& strides, const std::size_t batch_dimension) {
+		std::ptrdiff_t offset = 0;
+		const std::size_t skip = index.size() - batch_dimension;
+		for (std::size_t i = 0; i < batch_dimension; ++i) {
+			if (shape[i] != 1) offset += static_cast<std::ptrdiff_t>(index[skip + i]) * strides[i];
+		}
+		return offset;
+	}
+
+	template <typename T>
+	void matmul_batch(
+		const va::compute_case<T*>& a, const va::compute_case<T*>& b, va::compute_case<T*>& out,
+		const bool a_is_vector, const bool b_is_vector, const std::size_t m, const std::size_t n, const std::size_t k,
+		const std::size_t a_batch_dimension, const std::size_t b_batch_dimension, const std::size_t batch_dimension
+	) {
+		const auto& out_shape = out.shape();
+		const auto& a_strides = a.strides();
+		const auto& b_strides = b.strides();
+		const auto& out_strides = out.strides();
+
+		// Strides of the matrix axes, where vectors are promoted to 1 x k or k x 1.
+		const std::ptrdiff_t a_col_stride = a_strides.back();
+		const std::ptrdiff_t a_row_stride = a_is_vector ? 0 : a_strides[a_strides.size() - 2];
+		const std::ptrdiff_t b_row_stride = b_is_vector ? b_strides.back() : b_strides[b_strides.size() - 2];
+		const std::ptrdiff_t b_col_stride = b_is_vector ? 0 : b_strides.back();
+		const std::ptrdiff_t c_row_stride = a_is_vector ? 0 : out_strides[batch_dimension];
+		const std::ptrdiff_t c_col_stride = b_is_vector ? 0 : out_strides.back();
+
+		const T* a_ptr = a.data() + a.data_offset();
+		const T* b_ptr = b.data() + b.data_offset();
+		T* out_ptr = out.data() + out.data_offset();
+
+		const auto multiply_batch = [&](const va::shape_type& index) {
+			const T* a_ = a_ptr + batch_offset(index, a.shape(), a_strides, a_batch_dimension);
+			const T* b_ = b_ptr + batch_offset(index, b.shape(), b_strides, b_batch_dimension);
+			T* c_ = out_ptr + batch_offset(index, out_shape, out_strides, batch_dimension);
+
+			const va::gemm::Matrix<const T> a_matrix { a_, a_row_stride, a_col_stride };
+			const va::gemm::Matrix<const T> b_matrix { b_, b_row_stride, b_col_stride };
+
+			if (n == 1) {
+				va::gemm::gemv<T>(m, k, a_matrix, b_, b_row_stride, c_, c_row_stride);
+			}
+			else if (m == 1) {
+				va::gemm::gevm<T>(n, k, a_, a_col_stride, b_matrix, c_, c_col_stride);
+			}
+			else {
+				va::gemm::gemm<T>(m, n, k, a_matrix, b_matrix, va::gemm::Matrix<T> { c_, c_row_stride, c_col_stride });
+			}
+		};
+
+		std::size_t batch_size = 1;
+		for (std::size_t i = 0; i < batch_dimension; ++i) batch_size *= out_shape[i];
+
+		const auto multiply_batches = [&](const std::size_t begin, const std::size_t end) {
+			va::shape_type index(batch_dimension);
+			for (std::size_t flat = begin; flat < end; ++flat) {
+				std::size_t rest = flat;
+				for (std::size_t i = batch_dimension; i-- > 0;) {
+					index[i] = rest % out_shape[i];
+					rest /= out_shape[i];
+				}
+				multiply_batch(index);
+			}
+		};
+
+		// Many small products are split by batch. Otherwise, the kernels split each product.
+		const std::size_t chunks = batch_size > 1 && m * n * k < va::parallel::get_min_size()
+			? va::parallel::num_chunks(batch_size * m * n * k, batch_size)
+			: 1;
+		if (chunks <= 1) {
+			multiply_batches(0, batch_size);
+			return;
+		}
+
+		va::parallel::run(chunks, [&multiply_batches, chunks, batch_size](const std::size_t chunk) {
+			const auto [begin, end] = va::parallel::chunk_range(chunk, chunks, batch_size);
+			multiply_batches(begin, end);
+		});
+	}
+
+	// Runs matmul on the native gemm kernels. Returns false if the inputs are not supported by them.
+	bool matmul_gemm(va::VStoreAllocator& allocator, const va::VArrayTarget& target, const va::VData& a, const va::VData& b) {
+		const va::DType dtype = va::dtype(a);
+		if (dtype != va::dtype(b) || !is_gemm_dtype(dtype)) return false;
+
+		const auto& a_shape = va::shape(a);
+		const auto& b_shape = va::shape(b);
+		const bool a_is_vector = a_shape.size() == 1;
+		const bool b_is_vector = b_shape.size() == 1;
+
+		const std::size_t m = a_is_vector ? 1 : a_shape[a_shape.size() - 2];
+		const std::size_t k = a_shape.back();
+		const std::size_t n = b_is_vector ? 1 : b_shape.back();
+		if (k != (b_is_vector ? b_shape[0] : b_shape[b_shape.size() - 2])) return false;
+
+		const va::shape_type a_batch(a_shape.begin(), a_shape.end() - (a_is_vector ? 1 : 2));
+		const va::shape_type b_batch(b_shape.begin(), b_shape.end() - (b_is_vector ? 1 : 2));
+		va::shape_type result_shape = va::combined_shape(a_batch, b_batch);
+		const std::size_t batch_dimension = result_shape.size();
+		if (!a_is_vector) result_shape.push_back(m);
+		if (!b_is_vector) result_shape.push_back(n);
+
+		// The kernels write while reading a and b, so the result cannot go to the target directly, in case they overlap.
+		const auto result = va::empty(allocator, dtype, result_shape);
+
+		std::visit([&](auto& out) {
+			using T = typename std::decay_t<decltype(out)>::value_type;
+
+			if constexpr (std::is_floating_point_v<T> || xtl::is_complex<T>::value) {
+				matmul_batch<T>(
+					std::get<va::compute_case<T*>>(a), std::get<va::compute_case<T*>>(b), out,
+					a_is_vector, b_is_vector, m, n, k,
+					a_batch.size(), b_batch.size(), batch_dimension
+				);
+			}
+		}, result->data);
+
+		assign_result(target, result);
+		return true;
+	}
+}
+
 void va::matmul(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b) {
 	if (va::dimension(a) == 0 || va::dimension(b) == 0) {
 		throw std::runtime_error("matmul does not accept scalars");
 	}
+	if (matmul_gemm(allocator, target, a, b)) {
+		return;
+	}
 	if (va::dimension(b) == 1) {
 		auto axes = axes_type {-1};
 		va::sum_product(allocator, target, a, b, &axes);
@@ -182,7 +491,15 @@ void va::outer(VStoreAllocator& allocator, const VArrayTarget& target, const std
 }
 
 void va::inner(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b) {
-	const size_t n_axes = godot::Math::min(va::dimension(a), va::dimension(b));
+	// With a vector on either side, inner is a matrix-vector product.
+	if (va::dimension(b) == 1 && va::dimension(a) >= 1 && va::shape(a).back() == va::shape(b)[0] && matmul_gemm(allocator, target, a, b)) {
+		return;
+	}
+	if (va::dimension(a) == 1 && va::dimension(b) >= 1 && va::shape(b).back() == va::shape(a)[0] && matmul_gemm(allocator, target, b, a)) {
+		return;
+	}
+
+	const size_t n_axes = std::min(va::dimension(a), va::dimension(b));
 
 	va::axes_type axes;
 	axes.resize(n_axes);
@@ -192,3 +509,402 @@ void va::inner(VStoreAllocator& allocator, const VArrayTarget& target, const VDa
 
 	sum_product(allocator, target, a, b, &axes);
 }
+
+namespace {
+	// The dtype that decompositions of a are computed in.
+	va::DType decomposition_dtype(const va::DType dtype) {
+		return is_gemm_dtype(dtype) ? dtype : va::Float64;
+	}
+
+	// n, for a stack of square matrices [..., n, n].
+	std::size_t square_size(const va::VData& a) {
+		const auto& shape = va::shape(a);
+		if (shape.size() < 2 || shape[shape.size() - 1] != shape[shape.size() - 2]) {
+			throw std::runtime_error("last 2 dimensions of the array must be square");
+		}
+		return shape.back();
+	}
+
+	std::size_t batch_size(const va::shape_type& batch_shape) {
+		return std::accumulate(batch_shape.begin(), batch_shape.end(), std::size_t { 1 }, std::multiplies<>());
+	}
+
+	// Flat index into a stack with batch_shape, of the matrix that is broadcast to flat in broadcast_shape.
+	std::size_t broadcast_index(std::size_t flat, const va::shape_type& broadcast_shape, const va::shape_type& batch_shape) {
+		const std::size_t skip = broadcast_shape.size() - batch_shape.size();
+		std::size_t index = 0;
+		std::size_t stride = 1;
+		for (std::size_t i = broadcast_shape.size(); i-- > skip;) {
+			const std::size_t position = flat % broadcast_shape[i];
+			flat /= broadcast_shape[i];
+
+			const std::size_t size = batch_shape[i - skip];
+			if (size != 1) index += position * stride;
+			stride *= size;
+		}
+		return index;
+	}
+
+	// Calls fn(begin, end) for chunks of count matrices, in parallel. work is the number of operations per matrix.
+	template <typename F>
+	void run_matrices(const std::size_t count, const std::size_t work, F&& fn) {
+		const std::size_t chunks = va::parallel::num_chunks(count * work, count);
+		va::parallel::run(chunks, [&fn, chunks, count](const std::size_t chunk) {
+			const auto [begin, end] = va::parallel::chunk_range(chunk, chunks, count);
+			fn(begin, end);
+		});
+	}
+
+	// Calls fn(ptr) with the data of an array that has a decomposition_dtype.
+	template <typename F>
+	void visit_decomposable(va::VData& data, F&& fn) {
+		std::visit([&fn](auto& array) {
+			using T = typename std::decay_t<decltype(array)>::value_type;
+
+			if constexpr (std::is_floating_point_v<T> || xtl::is_complex<T>::value) {
+				fn(array.data() + array.data_offset());
+			}
+			else {
+				throw std::runtime_error("internal error: dtype cannot be decomposed");
+			}
+		}, data);
+	}
+
+	// Like visit_decomposable, but also passes the Square kernels for n x n matrices, which are unrolled for small n.
+	template <typename F>
+	void visit_square(va::VData& data, const std::size_t n, F&& fn) {
+		visit_decomposable(data, [n, &fn](auto* ptr) {
+			using T = std::remove_pointer_t<decltype(ptr)>;
+
+			switch (n) {
+				case 2: fn(ptr, va::decompose::Square<2, T> {}); return;
+				case 3: fn(ptr, va::decompose::Square<3, T> {}); return;
+				case 4: fn(ptr, va::decompose::Square<4, T> {}); return;
+				default: fn(ptr, va::decompose::Square<0, T> {}); return;
+			}
+		});
+	}
+
+	// Like visit_decomposable, for functions that are only implemented for real matrices.
+	template <typename F>
+	void visit_real(va::VData& data, const char* name, F&& fn) {
+		visit_decomposable(data, [name, &fn](auto* ptr) {
+			using T = std::remove_pointer_t<decltype(ptr)>;
+
+			if constexpr (xtl::is_complex<T>::value) {
+				throw std::runtime_error(std::string(name) + " does not support complex matrices");
+			}
+			else {
+				fn(ptr);
+			}
+		});
+	}
+
+	// Up to this size, eigh uses Jacobi rotations. Above, tridiagonalization takes fewer operations.
+	constexpr std::size_t jacobi_max_size = 8;
+
+	// Like visit_real, but also passes the Symmetric kernels for n x n matrices, which are unrolled for small n.
+	template <typename F>
+	void visit_symmetric(va::VData& data, const std::size_t n, F&& fn) {
+		visit_real(data, "eigh", [n, &fn](auto* ptr) {
+			using T = std::remove_pointer_t<decltype(ptr)>;
+
+			switch (n) {
+				case 2: fn(ptr, va::decompose::Symmetric<2, T> {}); return;
+				case 3: fn(ptr, va::decompose::Symmetric<3, T> {}); return;
+				case 4: fn(ptr, va::decompose::Symmetric<4, T> {}); return;
+				default: fn(ptr, va::decompose::Symmetric<0, T> {}); return;
+			}
+		});
+	}
+
+	template <typename T>
+	T* data_of(const std::shared_ptr<va::VArray>& array) {
+		return std::get<va::compute_case<T*>>(array->data).data();
+	}
+}
+
+void va::solve(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b) {
+	const std::size_t n = square_size(a);
+	const auto& a_shape = va::shape(a);
+	const auto& b_shape = va::shape(b);
+
+	const bool b_is_vector = b_shape.size() == 1;
+	if (b_shape.empty() || b_shape[b_shape.size() - (b_is_vector ? 1 : 2)] != n) {
+		throw std::runtime_error("b must have as many rows as a");
+	}
+	const std::size_t k = b_is_vector ? 1 : b_shape.back();
+
+	const shape_type a_batch(a_shape.begin(), a_shape.end() - 2);
+	const shape_type b_batch(b_shape.begin(), b_shape.end() - (b_is_vector ? 1 : 2));
+	const shape_type batch_shape = va::combined_shape(a_batch, b_batch);
+	shape_type result_shape = batch_shape;
+	result_shape.push_back(n);
+	if (!b_is_vector) result_shape.push_back(k);
+
+	const DType dtype = decomposition_dtype(va::dtype_common_type(va::dtype(a), va::dtype(b)));
+	const auto lu = va::copy_as_dtype(allocator, a, dtype);
+	const auto result = va::empty(allocator, dtype, result_shape);
+	// Broadcasts b, so that each matrix of the result can be solved in place.
+	va::assign(result->data, b);
+
+	const std::size_t a_count = batch_size(a_batch);
+	const std::size_t count = batch_size(batch_shape);
+	std::vector<std::size_t> pivots(a_count * n);
+
+	visit_square(lu->data, n, [&](auto* lu_ptr, auto kernels) {
+		using T = std::remove_pointer_t<decltype(lu_ptr)>;
+		using K = decltype(kernels);
+		T* result_ptr = data_of<T>(result);
+
+		// a may be broadcast, so every matrix of a is decomposed once, before the matrices of b are solved.
+		run_matrices(a_count, n * n * n, [&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) K::lu(lu_ptr + i * n * n, n, pivots.data() + i * n);
+		});
+
+		run_matrices(count, n * n * k, [&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				const std::size_t a_index = broadcast_index(i, batch_shape, a_batch);
+				if (!K::lu_solve(lu_ptr + a_index * n * n, pivots.data() + a_index * n, n, result_ptr + i * n * k, k)) {
+					throw std::runtime_error("singular matrix");
+				}
+			}
+		});
+	});
+
+	assign_result(target, result);
+}
+
+void va::inv(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a) {
+	const std::size_t n = square_size(a);
+	const DType dtype = decomposition_dtype(va::dtype(a));
+	const auto lu = va::copy_as_dtype(allocator, a, dtype);
+	const auto result = va::empty(allocator, dtype, va::shape(a));
+	const std::size_t count = batch_size(shape_type(va::shape(a).begin(), va::shape(a).end() - 2));
+
+	visit_square(lu->data, n, [&](auto* lu_ptr, auto kernels) {
+		using T = std::remove_pointer_t<decltype(lu_ptr)>;
+		using K = decltype(kernels);
+		T* result_ptr = data_of<T>(result);
+
+		run_matrices(count, n * n * n, [&](const std::size_t begin, const std::size_t end) {
+			std::vector<std::size_t> pivots(n);
+			for (std::size_t i = begin; i < end; ++i) {
+				T* matrix = lu_ptr + i * n * n;
+				T* inverse = result_ptr + i * n * n;
+				K::lu(matrix, n, pivots.data());
+
+				std::fill_n(inverse, n * n, T(0));
+				for (std::size_t j = 0; j < n; ++j) inverse[j * n + j] = T(1);
+				if (!K::lu_solve(matrix, pivots.data(), n, inverse, n)) throw std::runtime_error("singular matrix");
+			}
+		});
+	});
+
+	assign_result(target, result);
+}
+
+void va::det(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a) {
+	const std::size_t n = square_size(a);
+	const DType dtype = decomposition_dtype(va::dtype(a));
+	const auto lu = va::copy_as_dtype(allocator, a, dtype);
+	const shape_type batch_shape(va::shape(a).begin(), va::shape(a).end() - 2);
+	const auto result = va::empty(allocator, dtype, batch_shape);
+	const std::size_t count = batch_size(batch_shape);
+
+	visit_square(lu->data, n, [&](auto* lu_ptr, auto kernels) {
+		using T = std::remove_pointer_t<decltype(lu_ptr)>;
+		using K = decltype(kernels);
+		T* result_ptr = data_of<T>(result);
+
+		run_matrices(count, n * n * n, [&](const std::size_t begin, const std::size_t end) {
+			std::vector<std::size_t> pivots(n);
+			for (std::size_t i = begin; i < end; ++i) {
+				T* matrix = lu_ptr + i * n * n;
+				const std::size_t swaps = K::lu(matrix, n, pivots.data());
+				result_ptr[i] = K::lu_det(matrix, n, swaps);
+			}
+		});
+	});
+
+	assign_result(target, result);
+}
+
+void va::cholesky(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a) {
+	const std::size_t n = square_size(a);
+	const auto result = va::copy_as_dtype(allocator, a, decomposition_dtype(va::dtype(a)));
+	const std::size_t count = batch_size(shape_type(va::shape(a).begin(), va::shape(a).end() - 2));
+
+	visit_square(result->data, n, [&](auto* ptr, auto kernels) {
+		using K = decltype(kernels);
+
+		run_matrices(count, n * n * n, [&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				if (!K::cholesky(ptr + i * n * n, n)) throw std::runtime_error("matrix is not positive definite");
+			}
+		});
+	});
+
+	assign_result(target, result);
+}
+
+std::tuple<std::shared_ptr<va::VArray>, std::shared_ptr<va::VArray>, std::shared_ptr<va::VArray>> va::lu(VStoreAllocator& allocator, const VData& a) {
+	const std::size_t n = square_size(a);
+	const DType dtype = decomposition_dtype(va::dtype(a));
+	const auto lu = va::copy_as_dtype(allocator, a, dtype);
+	const auto p = va::empty(allocator, dtype, va::shape(a));
+	const auto l = va::empty(allocator, dtype, va::shape(a));
+	const auto u = va::empty(allocator, dtype, va::shape(a));
+	const std::size_t count = batch_size(shape_type(va::shape(a).begin(), va::shape(a).end() - 2));
+
+	visit_square(lu->data, n, [&](auto* lu_ptr, auto kernels) {
+		using T = std::remove_pointer_t<decltype(lu_ptr)>;
+		using K = decltype(kernels);
+		T* p_ptr = data_of<T>(p);
+		T* l_ptr = data_of<T>(l);
+		T* u_ptr = data_of<T>(u);
+
+		run_matrices(count, n * n * n, [&](const std::size_t begin, const std::size_t end) {
+			std::vector<std::size_t> pivots(n);
+			std::vector<std::size_t> rows(n);
+			for (std::size_t i = begin; i < end; ++i) {
+				const std::size_t offset = i * n * n;
+				const T* matrix = lu_ptr + offset;
+				K::lu(lu_ptr + offset, n, pivots.data());
+
+				// Row j of L U is row rows[j] of a.
+				std::iota(rows.begin(), rows.end(), std::size_t { 0 });
+				for (std::size_t j = 0; j < n; ++j) std::swap(rows[j], rows[pivots[j]]);
+
+				std::fill_n(p_ptr + offset, n * n, T(0));
+				for (std::size_t j = 0; j < n; ++j) p_ptr[offset + rows[j] * n + j] = T(1);
+
+				for (std::size_t row = 0; row < n; ++row) {
+					for (std::size_t col = 0; col < n; ++col) {
+						const T value = matrix[row * n + col];
+						l_ptr[offset + row * n + col] = row > col ? value : row == col ? T(1) : T(0);
+						u_ptr[offset + row * n + col] = row <= col ? value : T(0);
+					}
+				}
+			}
+		});
+	});
+
+	return { p, l, u };
+}
+
+std::pair<std::shared_ptr<va::VArray>, std::shared_ptr<va::VArray>> va::qr(VStoreAllocator& allocator, const VData& a) {
+	const auto& shape = va::shape(a);
+	if (shape.size() < 2) throw std::runtime_error("qr needs an array with at least 2 dimensions");
+
+	const std::size_t m = shape[shape.size() - 2];
+	const std::size_t n = shape.back();
+	const std::size_t k = std::min(m, n);
+	const shape_type batch_shape(shape.begin(), shape.end() - 2);
+	const std::size_t count = batch_size(batch_shape);
+
+	shape_type q_shape = batch_shape;
+	q_shape.push_back(m);
+	q_shape.push_back(k);
+	shape_type r_shape = batch_shape;
+	r_shape.push_back(k);
+	r_shape.push_back(n);
+
+	const DType dtype = decomposition_dtype(va::dtype(a));
+	const auto work = va::copy_as_dtype(allocator, a, dtype);
+	const auto q = va::empty(allocator, dtype, q_shape);
+	const auto r = va::empty(allocator, dtype, r_shape);
+
+	visit_decomposable(work->data, [&](auto* work_ptr) {
+		using T = std::remove_pointer_t<decltype(work_ptr)>;
+		T* q_ptr = data_of<T>(q);
+		T* r_ptr = data_of<T>(r);
+
+		run_matrices(count, m * n * k, [&](const std::size_t begin, const std::size_t end) {
+			std::vector<T> scratch(k + n);
+			for (std::size_t i = begin; i < end; ++i) {
+				va::decompose::qr(work_ptr + i * m * n, m, n, q_ptr + i * m * k, r_ptr + i * k * n, scratch.data());
+			}
+		});
+	});
+
+	return { q, r };
+}
+
+std::pair<std::shared_ptr<va::VArray>, std::shared_ptr<va::VArray>> va::eigh(VStoreAllocator& allocator, const VData& a) {
+	const std::size_t n = square_size(a);
+	const shape_type batch_shape(va::shape(a).begin(), va::shape(a).end() - 2);
+	const std::size_t count = batch_size(batch_shape);
+
+	shape_type w_shape = batch_shape;
+	w_shape.push_back(n);
+
+	const DType dtype = decomposition_dtype(va::dtype(a));
+	const auto work = va::copy_as_dtype(allocator, a, dtype);
+	const auto w = va::empty(allocator, dtype, w_shape);
+	const auto v = va::empty(allocator, dtype, va::shape(a));
+
+	visit_symmetric(work->data, n, [&](auto* work_ptr, auto kernels) {
+		using T = std::remove_pointer_t<decltype(work_ptr)>;
+		using K = decltype(kernels);
+		T* w_ptr = data_of<T>(w);
+		T* v_ptr = data_of<T>(v);
+
+		run_matrices(count, n * n * n, [&](const std::size_t begin, const std::size_t end) {
+			std::vector<T> scratch(2 * n);
+			for (std::size_t i = begin; i < end; ++i) {
+				T* matrix = work_ptr + i * n * n;
+				if (n <= jacobi_max_size) {
+					K::jacobi(matrix, n, w_ptr + i * n, v_ptr + i * n * n);
+				}
+				else if (!va::decompose::eigh_tridiagonal(matrix, n, w_ptr + i * n, v_ptr + i * n * n, scratch.data())) {
+					throw std::runtime_error("eigh did not converge");
+				}
+			}
+		});
+	});
+
+	return { w, v };
+}
+
+std::tuple<std::shared_ptr<va::VArray>, std::shared_ptr<va::VArray>, std::shared_ptr<va::VArray>> va::svd(VStoreAllocator& allocator, const VData& a) {
+	const auto& shape = va::shape(a);
+	if (shape.size() < 2) throw std::runtime_error("svd needs an array with at least 2 dimensions");
+
+	const std::size_t m = shape[shape.size() - 2];
+	const std::size_t n = shape.back();
+	const std::size_t k = std::min(m, n);
+	const shape_type batch_shape(shape.begin(), shape.end() - 2);
+	const std::size_t count = batch_size(batch_shape);
+
+	shape_type u_shape = batch_shape;
+	u_shape.push_back(m);
+	u_shape.push_back(k);
+	shape_type s_shape = batch_shape;
+	s_shape.push_back(k);
+	shape_type vt_shape = batch_shape;
+	vt_shape.push_back(k);
+	vt_shape.push_back(n);
+
+	const DType dtype = decomposition_dtype(va::dtype(a));
+	const auto matrices = va::copy_as_dtype(allocator, a, dtype);
+	const auto u = va::empty(allocator, dtype, u_shape);
+	const auto s = va::empty(allocator, dtype, s_shape);
+	const auto vt = va::empty(allocator, dtype, vt_shape);
+
+	visit_real(matrices->data, "svd", [&](auto* matrices_ptr) {
+		using T = std::remove_pointer_t<decltype(matrices_ptr)>;
+		T* u_ptr = data_of<T>(u);
+		T* s_ptr = data_of<T>(s);
+		T* vt_ptr = data_of<T>(vt);
+
+		run_matrices(count, m * n * k, [&](const std::size_t begin, const std::size_t end) {
+			std::vector<T> scratch(k * k + m * n);
+			for (std::size_t i = begin; i < end; ++i) {
+				va::decompose::svd(matrices_ptr + i * m * n, m, n, u_ptr + i * m * k, s_ptr + i * k, vt_ptr + i * k * n, scratch.data());
+			}
+		});
+	});
+
+	return { u, s, vt };
+}
@@ -1,6 +1,9 @@
 #ifndef LINALG_H
 #define LINALG_H
 
+#include <memory>                 // for shared_ptr
+#include <tuple>                  // for tuple
+#include <utility>                // for pair
 #include "varray.hpp"
 
 namespace va {
@@ -10,6 +13,22 @@ namespace va {
 
 	void outer(VStoreAllocator& allocator, const VArrayTarget& target, const std::shared_ptr<VArray>& a, const std::shared_ptr<VArray>& b);
 	void inner(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b);
+
+	// Decompositions of stacks of matrices [..., n, n]. Integer and bool inputs are computed as float64.
+	// b is a single vector if it is 1-D; otherwise, it is a stack of matrices [..., n, k].
+	void solve(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b);
+	void inv(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a);
+	void det(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a);
+	// Lower triangular L, with a = L L^H.
+	void cholesky(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a);
+	// P, L, U, with a = P L U.
+	std::tuple<std::shared_ptr<VArray>, std::shared_ptr<VArray>, std::shared_ptr<VArray>> lu(VStoreAllocator& allocator, const VData& a);
+	// Reduced Q, R of a stack of matrices [..., m, n].
+	std::pair<std::shared_ptr<VArray>, std::shared_ptr<VArray>> qr(VStoreAllocator& allocator, const VData& a);
+	// Ascending eigenvalues [..., n] and eigenvectors (as columns) of real symmetric matrices. Only the lower triangle is read.
+	std::pair<std::shared_ptr<VArray>, std::shared_ptr<VArray>> eigh(VStoreAllocator& allocator, const VData& a);
+	// Reduced U, S, V^T of a stack of real matrices [..., m, n], with descending singular values S.
+	std::tuple<std::shared_ptr<VArray>, std::shared_ptr<VArray>, std::shared_ptr<VArray>> svd(VStoreAllocator& allocator, const VData& a);
 }
 
 #endif //LINALG_H
@@ -0,0 +1,148 @@
+#include "mmap_store.hpp"
+
+#include <cstring>                         // for memcpy
+#include <stdexcept>                       // for runtime_error
+#include <string>                          // for string
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>                         // for open
+#include <sys/mman.h>                      // for mmap, munmap
+#include <sys/stat.h>                      // for fstat
+#include <unistd.h>                        // for close
+#endif
+
+using namespace va;
+
+#ifdef _WIN32
+
+store::MappedFile::MappedFile(const char* path) {
+	const int wide_length = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+	std::wstring wide_path(wide_length, L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path.data(), wide_length);
+
+	file_handle = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE) {
+		file_handle = nullptr;
+		throw std::runtime_error("Could not open file for mapping");
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file_handle);
+		throw std::runtime_error("Could not map empty file");
+	}
+	n_bytes = static_cast<std::size_t>(file_size.QuadPart);
+
+	// Copy-on-write, so that a write that misses prepare_write() copies the page instead of faulting.
+	mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if (mapping_handle == nullptr) {
+		CloseHandle(file_handle);
+		throw std::runtime_error("Could not map file");
+	}
+
+	ptr = MapViewOfFile(mapping_handle, FILE_MAP_COPY, 0, 0, 0);
+	if (ptr == nullptr) {
+		CloseHandle(mapping_handle);
+		CloseHandle(file_handle);
+		throw std::runtime_error("Could not map file");
+	}
+}
+
+store::MappedFile::~MappedFile() {
+	UnmapViewOfFile(ptr);
+	CloseHandle(mapping_handle);
+	CloseHandle(file_handle);
+}
+
+#else
+
+store::MappedFile::MappedFile(const char* path) {
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error("Could not open file for mapping");
+	}
+
+	struct stat file_stat {};
+	if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+		close(fd);
+		throw std::runtime_error("Could not map empty file");
+	}
+	n_bytes = static_cast<std::size_t>(file_stat.st_size);
+
+	// Copy-on-write, so that a write that misses prepare_write() copies the page instead of faulting.
+	// Changes are never written back to the file.
+	ptr = mmap(nullptr, n_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+	if (ptr == MAP_FAILED) {
+		ptr = nullptr;
+		throw std::runtime_error("Could not map file");
+	}
+}
+
+store::MappedFile::~MappedFile() {
+	munmap(ptr, n_bytes);
+}
+
+#endif
+
+store::MappedFileStore::~MappedFileStore() {
+	delete[] copy;
+}
+
+void* store::MappedFileStore::data() {
+	if (copy != nullptr) return copy;
+	return const_cast<char*>(file->data() + payload_offset);
+}
+
+DType store::MappedFileStore::dtype() {
+	return ptr_dtype;
+}
+
+std::size_t store::MappedFileStore::size() {
+	return count;
+}
+
+void store::MappedFileStore::prepare_write(VData& data, const std::ptrdiff_t data_offset) {
+	if (copy == nullptr) {
+		const std::size_t n_bytes = count * size_of_dtype_in_bytes(ptr_dtype);
+		copy = new char[n_bytes];
+		std::memcpy(copy, file->data() + payload_offset, n_bytes);
+	}
+
+	// Other views of this store keep reading from the mapping until they are written to.
+	std::visit([this, data_offset](auto& carray) {
+		using V = typename std::decay_t<decltype(carray)>::value_type;
+		carray.reset_buffer(reinterpret_cast<V*>(copy) + data_offset, carray.storage().size());
+	}, data);
+}
+
+std::shared_ptr<VArray> store::from_mapped_file(const std::shared_ptr<MappedFile>& file, const std::size_t payload_offset, const DType dtype, const shape_type& shape, const xt::layout_type layout) {
+	std::size_t count = 1;
+	for (const auto dim : shape) count *= dim;
+
+	if (payload_offset + count * size_of_dtype_in_bytes(dtype) > file->size()) {
+		throw std::runtime_error("Npy file is truncated");
+	}
+
+	auto store = std::make_shared<MappedFileStore>(file, payload_offset, count, dtype);
+
+	auto compute = std::visit([&store, &shape, layout](auto t) -> VData {
+		using T = decltype(t);
+		return make_compute<T*>(
+			static_cast<T*>(store->data()),
+			shape,
+			strides_type {}, // ignored
+			layout
+		);
+	}, dtype_to_variant_unchecked(dtype));
+
+	return std::make_shared<VArray>(VArray {
+		std::shared_ptr<VStore>(store),
+		compute,
+		0
+	});
+}
@@ -0,0 +1,53 @@
+#ifndef VA_MMAP_STORE_HPP
+#define VA_MMAP_STORE_HPP
+
+#include <cstddef>                         // for size_t
+#include <memory>                          // for shared_ptr
+
+#include "varray.hpp"
+
+namespace va::store {
+	// A read-only memory mapping of a whole file.
+	class MappedFile {
+		void* ptr = nullptr;
+		std::size_t n_bytes = 0;
+#ifdef _WIN32
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+#endif
+
+	public:
+		// Throws if the file cannot be opened or mapped.
+		explicit MappedFile(const char* path);
+		MappedFile(const MappedFile&) = delete;
+		~MappedFile();
+
+		[[nodiscard]] const char* data() const { return static_cast<const char*>(ptr); }
+		[[nodiscard]] std::size_t size() const { return n_bytes; }
+	};
+
+	// Points into a mapped file, without copying it.
+	// The mapping is read-only; on the first write, the payload is copied to the heap and views are moved over to the copy.
+	class MappedFileStore : public VStore {
+	public:
+		std::shared_ptr<MappedFile> file;
+		std::size_t payload_offset;
+		std::size_t count;
+		DType ptr_dtype;
+		char* copy = nullptr;
+
+		MappedFileStore(std::shared_ptr<MappedFile> file, std::size_t payload_offset, std::size_t count, DType dtype)
+			: file(std::move(file)), payload_offset(payload_offset), count(count), ptr_dtype(dtype) {}
+		MappedFileStore(const MappedFileStore&) = delete;
+		~MappedFileStore() override;
+
+		void* data() override;
+		DType dtype() override;
+		std::size_t size() override;
+		void prepare_write(VData& data, std::ptrdiff_t data_offset) override;
+	};
+
+	std::shared_ptr<VArray> from_mapped_file(const std::shared_ptr<MappedFile>& file, std::size_t payload_offset, DType dtype, const shape_type& shape, xt::layout_type layout);
+}
+
+#endif //VA_MMAP_STORE_HPP
@@ -0,0 +1,109 @@
+#include "pool_store.hpp"
+
+#include <bit>                             // for bit_width
+#include <new>                             // for align_val_t
+
+using namespace va;
+
+// Enough for any SIMD register.
+static constexpr std::align_val_t buffer_alignment { 64 };
+
+store::StorePool::~StorePool() {
+	clear();
+}
+
+std::size_t store::StorePool::capacity_for(const std::size_t n_bytes) {
+	if (n_bytes <= 64) return 64;
+
+	// 4 steps between each power of two, e.g. 1024, 1280, 1536, 1792, 2048.
+	const std::size_t step = std::size_t { 1 } << (std::bit_width(n_bytes - 1) - 3);
+	return (n_bytes + step - 1) / step * step;
+}
+
+void* store::StorePool::acquire(const std::size_t capacity) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	{
+		std::unique_lock lock(mutex);
+		if (const auto it = buffers.find(capacity); it != buffers.end() && !it->second.empty()) {
+			void* ptr = it->second.back();
+			it->second.pop_back();
+			cached_buffers -= 1;
+			cached_bytes -= capacity;
+			hits.fetch_add(1, std::memory_order_relaxed);
+			return ptr;
+		}
+	}
+
+	misses.fetch_add(1, std::memory_order_relaxed);
+	return ::operator new(capacity, buffer_alignment);
+}
+
+void store::StorePool::release(void* ptr, const std::size_t capacity) {
+	{
+		std::unique_lock lock(mutex);
+		if (cached_bytes + capacity <= max_cached_bytes) {
+			buffers[capacity].push_back(ptr);
+			cached_buffers += 1;
+			cached_bytes += capacity;
+			return;
+		}
+	}
+
+	evictions.fetch_add(1, std::memory_order_relaxed);
+	::operator delete(ptr, buffer_alignment);
+}
+
+void store::StorePool::clear() {
+	std::unique_lock lock(mutex);
+	for (auto& [capacity, ptrs] : buffers) {
+		for (void* ptr : ptrs) {
+			::operator delete(ptr, buffer_alignment);
+		}
+	}
+	buffers.clear();
+	cached_buffers = 0;
+	cached_bytes = 0;
+}
+
+store::StorePoolStats store::StorePool::stats() {
+	std::unique_lock lock(mutex);
+	return StorePoolStats {
+		allocations.load(),
+		hits.load(),
+		misses.load(),
+		evictions.load(),
+		cached_buffers,
+		cached_bytes
+	};
+}
+
+void store::StorePool::reset_stats() {
+	allocations = 0;
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
+
+store::PooledStore::~PooledStore() {
+	pool->release(ptr, capacity);
+}
+
+void* store::PooledStore::data() {
+	return ptr;
+}
+
+DType store::PooledStore::dtype() {
+	return ptr_dtype;
+}
+
+std::size_t store::PooledStore::size() {
+	return count;
+}
+
+std::shared_ptr<VStore> store::PooledStoreAllocator::allocate(const DType dtype, const std::size_t count) {
+	const std::size_t capacity = StorePool::capacity_for(count * size_of_dtype_in_bytes(dtype));
+	void* ptr = pool->acquire(capacity);
+
+	return std::make_shared<PooledStore>(pool, ptr, capacity, count, dtype);
+}
@@ -0,0 +1,81 @@
+#ifndef VA_POOL_STORE_HPP
+#define VA_POOL_STORE_HPP
+
+#include <atomic>                          // for atomic
+#include <cstddef>                         // for size_t
+#include <memory>                          // for shared_ptr
+#include <mutex>                           // for mutex
+#include <unordered_map>                   // for unordered_map
+#include <vector>                          // for vector
+
+#include "varray.hpp"
+
+namespace va::store {
+	struct StorePoolStats {
+		std::size_t allocations;
+		// Allocations served from a previously released buffer.
+		std::size_t hits;
+		// Allocations that needed a new buffer.
+		std::size_t misses;
+		// Released buffers that were freed instead of cached, because the cache was full.
+		std::size_t evictions;
+		std::size_t cached_buffers;
+		std::size_t cached_bytes;
+	};
+
+	// Caches released buffers by size class, to hand them out again for later allocations.
+	// Buffers are raw memory, so a buffer can be reused by any dtype.
+	class StorePool {
+		std::mutex mutex;
+		std::unordered_map<std::size_t, std::vector<void*>> buffers;
+		std::size_t cached_buffers = 0;
+		std::size_t cached_bytes = 0;
+
+		std::atomic<std::size_t> allocations = 0;
+		std::atomic<std::size_t> hits = 0;
+		std::atomic<std::size_t> misses = 0;
+		std::atomic<std::size_t> evictions = 0;
+
+	public:
+		std::atomic<std::size_t> max_cached_bytes = 256 * 1024 * 1024;
+
+		~StorePool();
+
+		// Rounds up to one of 4 size classes per power of two, so that similar sizes share buffers.
+		static std::size_t capacity_for(std::size_t n_bytes);
+
+		void* acquire(std::size_t capacity);
+		void release(void* ptr, std::size_t capacity);
+		void clear();
+
+		StorePoolStats stats();
+		void reset_stats();
+	};
+
+	class PooledStore : public VStore {
+	public:
+		std::shared_ptr<StorePool> pool;
+		void* ptr;
+		std::size_t capacity;
+		std::size_t count;
+		DType ptr_dtype;
+
+		PooledStore(std::shared_ptr<StorePool> pool, void* ptr, std::size_t capacity, std::size_t count, DType dtype)
+			: pool(std::move(pool)), ptr(ptr), capacity(capacity), count(count), ptr_dtype(dtype) {}
+		PooledStore(const PooledStore&) = delete;
+		~PooledStore() override;
+
+		void* data() override;
+		DType dtype() override;
+		std::size_t size() override;
+	};
+
+	class PooledStoreAllocator : public VStoreAllocator {
+	public:
+		std::shared_ptr<StorePool> pool = std::make_shared<StorePool>();
+
+		std::shared_ptr<VStore> allocate(DType dtype, std::size_t count) override;
+	};
+}
+
+#endif //VA_POOL_STORE_HPP
@@ -0,0 +1,126 @@
+#ifndef VATENSOR_RADIX_HPP
+#define VATENSOR_RADIX_HPP
+
+#include <algorithm>                       // for copy
+#include <array>                           // for array
+#include <bit>                             // for bit_cast
+#include <cstddef>                         // for size_t
+#include <cstdint>                         // for uint8_t, uint16_t, uint32_t, uint64_t
+#include <limits>                          // for numeric_limits
+#include <type_traits>                     // for conditional_t, is_floating_point_v, is_integral_v, is_signed_v
+#include <utility>                         // for swap
+
+// LSD radix sort on raw memory, one byte per pass.
+// Values are sorted through unsigned keys that order like the values, so that integers and floats share the sort.
+namespace va::radix {
+	template <std::size_t Size>
+	struct unsigned_of_size;
+	template <>
+	struct unsigned_of_size<1> { using type = uint8_t; };
+	template <>
+	struct unsigned_of_size<2> { using type = uint16_t; };
+	template <>
+	struct unsigned_of_size<4> { using type = uint32_t; };
+	template <>
+	struct unsigned_of_size<8> { using type = uint64_t; };
+
+	template <typename T>
+	constexpr bool is_supported = std::is_integral_v<T> || std::is_floating_point_v<T>;
+
+	// Unsupported types get a placeholder, so that buffers of keys can be declared for them.
+	template <typename T>
+	using key_t = typename std::conditional_t<is_supported<T>, unsigned_of_size<sizeof(T)>, unsigned_of_size<1>>::type;
+
+	// The key of a value. For floats, negative values have their bits flipped, and positive ones their sign bit.
+	// All NaN map to the largest key, so that they are sorted last.
+	template <typename T>
+	key_t<T> to_key(const T value) {
+		using U = key_t<T>;
+		constexpr U sign = static_cast<U>(U { 1 } << (sizeof(U) * 8 - 1));
+
+		if constexpr (std::is_floating_point_v<T>) {
+			if (value != value) return std::numeric_limits<U>::max();
+			const U bits = std::bit_cast<U>(value);
+			return static_cast<U>(bits & sign ? ~bits : bits | sign);
+		}
+		else if constexpr (std::is_signed_v<T>) {
+			return static_cast<U>(static_cast<U>(value) ^ sign);
+		}
+		else {
+			return static_cast<U>(value);
+		}
+	}
+
+	template <typename T>
+	T from_key(const key_t<T> key) {
+		using U = key_t<T>;
+		constexpr U sign = static_cast<U>(U { 1 } << (sizeof(U) * 8 - 1));
+
+		if constexpr (std::is_floating_point_v<T>) {
+			if (key == std::numeric_limits<U>::max()) return std::numeric_limits<T>::quiet_NaN();
+			return std::bit_cast<T>(static_cast<U>(key & sign ? key ^ sign : ~key));
+		}
+		else if constexpr (std::is_signed_v<T>) {
+			return static_cast<T>(static_cast<U>(key ^ sign));
+		}
+		else {
+			return static_cast<T>(key);
+		}
+	}
+
+	// Sorts keys, and moves the payload (e.g. indices) along, if it's not nullptr. The sort is stable.
+	// The tmp buffers must hold size elements. Passes are skipped where all keys have the same byte.
+	template <typename U, typename P>
+	void sort(U* keys, P* payload, const std::size_t size, U* keys_tmp, P* payload_tmp) {
+		constexpr std::size_t passes = sizeof(U);
+		if (size == 0) return;
+
+		// Histograms for all passes, from one read of the keys.
+		std::array<std::array<std::size_t, 256>, passes> counts {};
+		for (std::size_t i = 0; i < size; ++i) {
+			for (std::size_t pass = 0; pass < passes; ++pass) {
+				++counts[pass][(keys[i] >> (pass * 8)) & 0xFF];
+			}
+		}
+
+		U* src = keys;
+		U* dst = keys_tmp;
+		P* payload_src = payload;
+		P* payload_dst = payload_tmp;
+		for (std::size_t pass = 0; pass < passes; ++pass) {
+			const std::size_t shift = pass * 8;
+			auto& offsets = counts[pass];
+			if (offsets[(src[0] >> shift) & 0xFF] == size) continue;
+
+			std::size_t offset = 0;
+			for (auto& count : offsets) {
+				const std::size_t bucket_size = count;
+				count = offset;
+				offset += bucket_size;
+			}
+
+			if (payload) {
+				for (std::size_t i = 0; i < size; ++i) {
+					const std::size_t position = offsets[(src[i] >> shift) & 0xFF]++;
+					dst[position] = src[i];
+					payload_dst[position] = payload_src[i];
+				}
+			}
+			else {
+				for (std::size_t i = 0; i < size; ++i) {
+					dst[offsets[(src[i] >> shift) & 0xFF]++] = src[i];
+				}
+			}
+
+			std::swap(src, dst);
+			std::swap(payload_src, payload_dst);
+		}
+
+		if (src != keys) {
+			std::copy(src, src + size, keys);
+			if (payload) std::copy(payload_src, payload_src + size, payload);
+		}
+	}
+}
+
+#endif //VATENSOR_RADIX_HPP
@@ -0,0 +1,374 @@
+#include "scan.hpp"
+
+#include <algorithm>                       // for copy_n, min
+#include <cmath>                           // for isfinite
+#include <cstdint>                         // for int64_t
+#include <limits>                          // for numeric_limits
+#include <memory>                          // for unique_ptr
+#include <stdexcept>                       // for runtime_error
+#include <type_traits>                     // for conditional_t, decay_t, is_floating_point_v, is_same_v
+#include <variant>                         // for visit
+#include <vector>                          // for vector
+#include "create.hpp"
+#include "util.hpp"
+#include "vparallel.hpp"
+#include "xtl/xcomplex.hpp"                // for is_complex
+
+using namespace va;
+
+struct Add {
+	static constexpr bool supports_complex = true;
+
+	template <typename T>
+	T operator()(const T a, const T b) const { return a + b; }
+};
+
+struct Multiply {
+	static constexpr bool supports_complex = true;
+
+	template <typename T>
+	T operator()(const T a, const T b) const { return a * b; }
+};
+
+struct Max {
+	static constexpr bool supports_complex = false;
+
+	// Propagates NaN, like maximum.
+	template <typename T>
+	T operator()(const T a, const T b) const { return b > a || b != b ? b : a; }
+};
+
+static DType accumulation_dtype(const DType dtype) {
+	if (dtype == DType::Bool || (dtype >= DType::Int8 && dtype <= DType::Int64)) return DType::Int64;
+	if (dtype >= DType::UInt8 && dtype <= DType::UInt64) return DType::UInt64;
+	return dtype;
+}
+
+static DType mean_dtype(const DType dtype) {
+	return dtype == DType::Bool || va::is_integer_dtype(dtype) ? DType::Float64 : dtype;
+}
+
+// Calls fn(base, k_begin, k_end) for blocks of lanes, in parallel.
+// The elements of lane k of a block are data[base + i * lanes.stride + k]. For the same i, they are neighbours in memory,
+// so that loops across the lanes can be vectorized.
+template <typename F>
+static void run_lane_blocks(const util::Lanes& lanes, F&& fn) {
+	const std::size_t inner = lanes.stride;
+	parallel::run_lanes(lanes, [&fn, &lanes, inner](const std::size_t begin, const std::size_t end) {
+		for (std::size_t j = begin; j < end;) {
+			const std::size_t k_begin = j % inner;
+			const std::size_t k_end = std::min(inner, k_begin + (end - j));
+			fn(j / inner * lanes.size * inner, k_begin, k_end);
+			j += k_end - k_begin;
+		}
+	});
+}
+
+template <typename T, typename Op>
+static void scan_contiguous(T* data, const std::size_t size, const Op& op) {
+	for (std::size_t i = 1; i < size; ++i) {
+		data[i] = op(data[i - 1], data[i]);
+	}
+}
+
+// Blocked scan of one long lane: Chunks are scanned on their own, then offset by the scanned totals of the chunks before.
+template <typename T, typename Op>
+static void scan_split(T* data, const std::size_t size, const Op& op) {
+	const std::size_t chunks = parallel::num_chunks(size, size);
+	if (chunks <= 1) {
+		scan_contiguous(data, size, op);
+		return;
+	}
+
+	// Not a vector, because std::vector<bool> cannot be written to concurrently.
+	const std::unique_ptr<T[]> totals(new T[chunks]);
+	parallel::run(chunks, [data, &totals, &op, chunks, size](const std::size_t chunk) {
+		const auto [begin, end] = parallel::chunk_range(chunk, chunks, size);
+		scan_contiguous(data + begin, end - begin, op);
+		totals[chunk] = data[end - 1];
+	});
+
+	// totals[c] is now the carry into chunk c + 1.
+	scan_contiguous(totals.get(), chunks, op);
+
+	parallel::run(chunks - 1, [data, &totals, &op, chunks, size](const std::size_t chunk) {
+		const auto [begin, end] = parallel::chunk_range(chunk + 1, chunks, size);
+		const T carry = totals[chunk];
+		for (std::size_t i = begin; i < end; ++i) {
+			data[i] = op(carry, data[i]);
+		}
+	});
+}
+
+template <typename T, typename Op>
+static void scan_lanes(T* data, const util::Lanes& lanes, const Op& op) {
+	if (lanes.stride == 1 && lanes.count < parallel::get_num_threads()) {
+		// Too few lanes to keep all threads busy: split each lane instead.
+		for (std::size_t j = 0; j < lanes.count; ++j) {
+			scan_split(data + j * lanes.size, lanes.size, op);
+		}
+		return;
+	}
+
+	run_lane_blocks(lanes, [data, &lanes, &op](const std::size_t base, const std::size_t k_begin, const std::size_t k_end) {
+		const std::size_t inner = lanes.stride;
+		for (std::size_t i = 1; i < lanes.size; ++i) {
+			T* row = data + base + i * inner;
+			const T* previous = row - inner;
+			for (std::size_t k = k_begin; k < k_end; ++k) {
+				row[k] = op(previous[k], row[k]);
+			}
+		}
+	});
+}
+
+template <typename Op>
+static std::shared_ptr<VArray> scan(VStoreAllocator& allocator, const VData& a, const std::optional<std::ptrdiff_t> axis, const DType dtype, const Op& op) {
+	const std::size_t size = va::size(a);
+	const util::Lanes lanes = axis
+		? util::lanes_along(va::shape(a), util::normalize_axis(*axis, va::dimension(a)))
+		: util::Lanes { size == 0 ? 0 : 1, size, 1 };
+
+	auto result = va::copy_as_dtype(allocator, a, dtype);
+
+	std::visit([&lanes, &op](auto& array) {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+
+		if constexpr (xtl::is_complex<T>::value && !Op::supports_complex) {
+			throw std::runtime_error("unsupported dtype for scan");
+		}
+		else {
+			scan_lanes(array.data() + array.data_offset(), lanes, op);
+		}
+	}, result->data);
+
+	if (!axis) return va::reshape(allocator, result, strides_type { static_cast<std::ptrdiff_t>(size) });
+	return result;
+}
+
+std::shared_ptr<VArray> va::cumsum(VStoreAllocator& allocator, const VData& a, const std::optional<std::ptrdiff_t> axis) {
+	return scan(allocator, a, axis, accumulation_dtype(va::dtype(a)), Add {});
+}
+
+std::shared_ptr<VArray> va::cumprod(VStoreAllocator& allocator, const VData& a, const std::optional<std::ptrdiff_t> axis) {
+	return scan(allocator, a, axis, accumulation_dtype(va::dtype(a)), Multiply {});
+}
+
+std::shared_ptr<VArray> va::cummax(VStoreAllocator& allocator, const VData& a, const std::optional<std::ptrdiff_t> axis) {
+	return scan(allocator, a, axis, va::dtype(a), Max {});
+}
+
+// Copies the first size elements of each lane of a contiguous array into a new one, with the axis shrunk to size.
+template <typename T>
+static void copy_lane_heads(const T* data, const util::Lanes& lanes, const std::size_t size, T* out) {
+	if (lanes.stride == 0) return;
+
+	const std::size_t outer = lanes.count / lanes.stride;
+	const std::size_t row = size * lanes.stride;
+	for (std::size_t i = 0; i < outer; ++i) {
+		std::copy_n(data + i * lanes.size * lanes.stride, row, out + i * row);
+	}
+}
+
+std::shared_ptr<VArray> va::diff(VStoreAllocator& allocator, const VData& a, const std::size_t n, const std::ptrdiff_t axis) {
+	if (va::dimension(a) == 0) throw std::runtime_error("diff requires at least 1 dimension");
+
+	const std::size_t axis_ = util::normalize_axis(axis, va::dimension(a));
+	const util::Lanes lanes = util::lanes_along(va::shape(a), axis_);
+	const std::size_t passes = std::min(n, lanes.size);
+
+	shape_type result_shape = va::shape(a);
+	result_shape[axis_] = lanes.size - passes;
+
+	auto work = va::copy(allocator, a);
+	auto result = va::empty(allocator, va::dtype(a), result_shape);
+
+	std::visit([&lanes, &result, passes](auto& array) {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+		T* data = array.data() + array.data_offset();
+
+		run_lane_blocks(lanes, [data, &lanes, passes](const std::size_t base, const std::size_t k_begin, const std::size_t k_end) {
+			const std::size_t inner = lanes.stride;
+			for (std::size_t pass = 0; pass < passes; ++pass) {
+				// Each pass shortens the lanes by one. Writing forwards reads every element before it's overwritten.
+				for (std::size_t i = 0; i + pass + 1 < lanes.size; ++i) {
+					T* row = data + base + i * inner;
+					const T* next = row + inner;
+					for (std::size_t k = k_begin; k < k_end; ++k) {
+						if constexpr (std::is_same_v<T, bool>) row[k] = next[k] != row[k];
+						else row[k] = next[k] - row[k];
+					}
+				}
+			}
+		});
+
+		copy_lane_heads(data, lanes, lanes.size - passes, std::get<compute_case<T*>>(result->data).data());
+	}, work->data);
+
+	return result;
+}
+
+static util::Lanes rolling_lanes(const VData& a, const std::size_t window, const std::ptrdiff_t axis, shape_type& result_shape) {
+	if (va::dimension(a) == 0) throw std::runtime_error("rolling reductions require at least 1 dimension");
+
+	const std::size_t axis_ = util::normalize_axis(axis, va::dimension(a));
+	const util::Lanes lanes = util::lanes_along(va::shape(a), axis_);
+	if (window == 0 || window > lanes.size) throw std::runtime_error("window must be in [1, size of the axis]");
+
+	result_shape = va::shape(a);
+	result_shape[axis_] = lanes.size - window + 1;
+	return lanes;
+}
+
+// Sum of a window, updated as elements enter and leave it.
+// For floats, non-finite values are counted instead, so that they can't spoil the sum once they have left.
+template <typename T>
+struct RunningSum {
+	// float32 sums accumulate in float64, to limit the error that builds up from adding and removing.
+	using Accumulator = std::conditional_t<std::is_same_v<T, float>, double, T>;
+
+	Accumulator sum {};
+	std::size_t nan = 0;
+	std::size_t pos_inf = 0;
+	std::size_t neg_inf = 0;
+
+	void update(const T value, const bool add) {
+		if constexpr (std::is_floating_point_v<T>) {
+			if (!std::isfinite(value)) {
+				std::size_t& count = value != value ? nan : value > 0 ? pos_inf : neg_inf;
+				count = add ? count + 1 : count - 1;
+				return;
+			}
+		}
+		if (add) sum += value;
+		else sum -= value;
+	}
+
+	T get(const std::size_t window, const bool mean) const {
+		if constexpr (std::is_floating_point_v<T>) {
+			if (nan > 0 || (pos_inf > 0 && neg_inf > 0)) return std::numeric_limits<T>::quiet_NaN();
+			if (pos_inf > 0) return std::numeric_limits<T>::infinity();
+			if (neg_inf > 0) return -std::numeric_limits<T>::infinity();
+		}
+		if (mean) return static_cast<T>(sum / static_cast<Accumulator>(window));
+		return static_cast<T>(sum);
+	}
+};
+
+static std::shared_ptr<VArray> rolling_sum_(VStoreAllocator& allocator, const VData& a, const std::size_t window, const std::ptrdiff_t axis, const DType dtype, const bool mean) {
+	shape_type result_shape;
+	const util::Lanes lanes = rolling_lanes(a, window, axis, result_shape);
+	const std::size_t result_size = lanes.size - window + 1;
+
+	std::shared_ptr<VArray> work;
+	const VData* a_ = &a;
+	if (va::dtype(a) != dtype || !va::is_contiguous(a)) {
+		work = va::copy_as_dtype(allocator, a, dtype);
+		a_ = &work->data;
+	}
+	auto result = va::empty(allocator, dtype, result_shape);
+
+	std::visit([&lanes, &result, window, mean, result_size](const auto& array) {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+		const T* data = array.data() + array.data_offset();
+		T* out = std::get<compute_case<T*>>(result->data).data();
+
+		run_lane_blocks(lanes, [data, out, &lanes, window, mean, result_size](const std::size_t base, const std::size_t k_begin, const std::size_t k_end) {
+			const std::size_t inner = lanes.stride;
+			T* out_block = out + base / lanes.size * result_size;
+			std::vector<RunningSum<T>> sums(k_end - k_begin);
+
+			for (std::size_t i = 0; i < lanes.size; ++i) {
+				const T* row = data + base + i * inner;
+				for (std::size_t k = k_begin; k < k_end; ++k) sums[k - k_begin].update(row[k], true);
+
+				if (i >= window) {
+					const T* old_row = row - window * inner;
+					for (std::size_t k = k_begin; k < k_end; ++k) sums[k - k_begin].update(old_row[k], false);
+				}
+				if (i + 1 >= window) {
+					T* out_row = out_block + (i + 1 - window) * inner;
+					for (std::size_t k = k_begin; k < k_end; ++k) out_row[k] = sums[k - k_begin].get(window, mean);
+				}
+			}
+		});
+	}, *a_);
+
+	return result;
+}
+
+std::shared_ptr<VArray> va::rolling_sum(VStoreAllocator& allocator, const VData& a, const std::size_t window, const std::ptrdiff_t axis) {
+	return rolling_sum_(allocator, a, window, axis, accumulation_dtype(va::dtype(a)), false);
+}
+
+std::shared_ptr<VArray> va::rolling_mean(VStoreAllocator& allocator, const VData& a, const std::size_t window, const std::ptrdiff_t axis) {
+	return rolling_sum_(allocator, a, window, axis, mean_dtype(va::dtype(a)), true);
+}
+
+// Maximum of each window of a lane, from a monotonic deque: the indices of the window's elements that are larger than
+// all elements after them, in decreasing order of value. Each index is pushed and popped at most once.
+template <typename T>
+static void rolling_max_lane(const T* lane, const std::size_t stride, const std::size_t size, const std::size_t window, T* out, const std::size_t out_stride, std::vector<std::size_t>& deque) {
+	// A ring buffer, since the deque never holds more than window indices.
+	std::size_t head = 0;
+	std::size_t count = 0;
+	// Windows starting before this contain NaN.
+	std::size_t nan_end = 0;
+
+	for (std::size_t i = 0; i < size; ++i) {
+		if (count > 0 && deque[head] + window <= i) {
+			head = (head + 1) % window;
+			--count;
+		}
+
+		const T value = lane[i * stride];
+		if (value != value) {
+			nan_end = i + 1;
+		}
+		else {
+			while (count > 0 && !(lane[deque[(head + count - 1) % window] * stride] > value)) --count;
+			deque[(head + count) % window] = i;
+			++count;
+		}
+
+		if (i + 1 >= window) {
+			const std::size_t start = i + 1 - window;
+			out[start * out_stride] = start < nan_end ? std::numeric_limits<T>::quiet_NaN() : lane[deque[head] * stride];
+		}
+	}
+}
+
+std::shared_ptr<VArray> va::rolling_max(VStoreAllocator& allocator, const VData& a, const std::size_t window, const std::ptrdiff_t axis) {
+	shape_type result_shape;
+	const util::Lanes lanes = rolling_lanes(a, window, axis, result_shape);
+	const util::Lanes result_lanes { lanes.count, lanes.size - window + 1, lanes.stride };
+
+	std::shared_ptr<VArray> work;
+	const VData* a_ = &a;
+	if (!va::is_contiguous(a)) {
+		work = va::copy(allocator, a);
+		a_ = &work->data;
+	}
+	auto result = va::empty(allocator, va::dtype(a), result_shape);
+
+	std::visit([&lanes, &result_lanes, &result, window](const auto& array) {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+
+		if constexpr (xtl::is_complex<T>::value) {
+			throw std::runtime_error("unsupported dtype for rolling_max");
+		}
+		else {
+			const T* data = array.data() + array.data_offset();
+			T* out = std::get<compute_case<T*>>(result->data).data();
+
+			parallel::run_lanes(lanes, [data, out, &lanes, &result_lanes, window](const std::size_t begin, const std::size_t end) {
+				std::vector<std::size_t> deque(window);
+				for (std::size_t j = begin; j < end; ++j) {
+					rolling_max_lane(data + lanes.offset(j), lanes.stride, lanes.size, window, out + result_lanes.offset(j), result_lanes.stride, deque);
+				}
+			});
+		}
+	}, *a_);
+
+	return result;
+}
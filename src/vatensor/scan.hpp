@@ -0,0 +1,27 @@
+#ifndef VATENSOR_SCAN_HPP
+#define VATENSOR_SCAN_HPP
+
+#include <cstddef>                         // for ptrdiff_t, size_t
+#include <optional>                        // for optional
+
+#include "varray.hpp"
+
+namespace va {
+	// Inclusive scans along an axis, or over the flattened array if axis is nullopt.
+	// Like sum, booleans and integers accumulate in 64 bits.
+	std::shared_ptr<VArray> cumsum(VStoreAllocator& allocator, const VData& a, std::optional<std::ptrdiff_t> axis);
+	std::shared_ptr<VArray> cumprod(VStoreAllocator& allocator, const VData& a, std::optional<std::ptrdiff_t> axis);
+	// Running maximum, which stays NaN after the first NaN, like maximum.
+	std::shared_ptr<VArray> cummax(VStoreAllocator& allocator, const VData& a, std::optional<std::ptrdiff_t> axis);
+
+	// The n-th discrete difference along an axis, which shrinks by n.
+	std::shared_ptr<VArray> diff(VStoreAllocator& allocator, const VData& a, std::size_t n, std::ptrdiff_t axis);
+
+	// Reductions of each window of consecutive elements along an axis, which shrinks to size - window + 1.
+	// Each takes O(1) per element, regardless of the window size. Windows containing NaN reduce to NaN.
+	std::shared_ptr<VArray> rolling_sum(VStoreAllocator& allocator, const VData& a, std::size_t window, std::ptrdiff_t axis);
+	std::shared_ptr<VArray> rolling_mean(VStoreAllocator& allocator, const VData& a, std::size_t window, std::ptrdiff_t axis);
+	std::shared_ptr<VArray> rolling_max(VStoreAllocator& allocator, const VData& a, std::size_t window, std::ptrdiff_t axis);
+}
+
+#endif //VATENSOR_SCAN_HPP
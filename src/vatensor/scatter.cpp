@@ -0,0 +1,162 @@
+#include "scatter.hpp"
+
+#include <algorithm>                       // for fill_n, is_sorted, minmax_element
+#include <cstdint>                         // for int64_t
+#include <functional>                      // for multiplies, plus
+#include <limits>                          // for numeric_limits
+#include <numeric>                         // for accumulate
+#include <stdexcept>                       // for runtime_error
+#include <type_traits>                     // for decay_t
+#include <variant>                         // for visit
+#include "create.hpp"
+#include "gather.hpp"
+
+using namespace va;
+
+// Ids as a contiguous int64 buffer.
+struct IdBuffer {
+	std::shared_ptr<VArray> temp;
+	const int64_t* ptr;
+	std::size_t size;
+	int64_t min;
+	int64_t max;
+};
+
+static IdBuffer id_buffer(VStoreAllocator& allocator, const VData& ids) {
+	if (!va::is_integer_dtype(va::dtype(ids))) throw std::runtime_error("ids must be integer dtype");
+	if (va::dimension(ids) != 1) throw std::runtime_error("ids must be 1d");
+
+	IdBuffer buffer { nullptr, nullptr, va::size(ids), 0, -1 };
+	const VData* ids_ = &ids;
+	if (va::dtype(ids) != DType::Int64 || !va::is_contiguous(ids)) {
+		buffer.temp = va::copy_as_dtype(allocator, ids, DType::Int64);
+		ids_ = &buffer.temp->data;
+	}
+
+	const auto& ids_int64 = std::get<compute_case<int64_t*>>(*ids_);
+	buffer.ptr = ids_int64.data() + ids_int64.data_offset();
+
+	if (buffer.size > 0) {
+		const auto [min, max] = std::minmax_element(buffer.ptr, buffer.ptr + buffer.size);
+		buffer.min = *min;
+		buffer.max = *max;
+	}
+	return buffer;
+}
+
+// data cast to dtype, and contiguous.
+static const VData& contiguous_as_dtype(VStoreAllocator& allocator, const VData& data, const DType dtype, std::shared_ptr<VArray>& temp) {
+	if (va::dtype(data) == dtype && va::is_contiguous(data)) return data;
+
+	temp = va::copy_as_dtype(allocator, data, dtype);
+	return temp->data;
+}
+
+static std::shared_ptr<VArray> bincount_(VStoreAllocator& allocator, const VData& x, const VData* weights, const std::size_t minlength) {
+	const auto ids = id_buffer(allocator, x);
+	if (ids.min < 0) throw std::runtime_error("bincount values must be non-negative");
+
+	const std::size_t num_bins = std::max(minlength, static_cast<std::size_t>(ids.max + 1));
+
+	if (weights == nullptr) {
+		auto result = va::empty(allocator, DType::Int64, shape_type { num_bins });
+		int64_t* result_ptr = std::get<compute_case<int64_t*>>(result->data).data();
+		std::fill_n(result_ptr, num_bins, 0);
+
+		// Every id adds the same value.
+		constexpr int64_t one = 1;
+		gather::parallel_scatter_reduce(result_ptr, num_bins, ids.ptr, ids.size, 1, &one, 0, int64_t { 0 }, std::plus<int64_t>());
+		return result;
+	}
+
+	if (va::shape(*weights) != va::shape(x)) throw std::runtime_error("weights must have the same shape as x");
+
+	std::shared_ptr<VArray> weights_temp;
+	const auto& weights_ = std::get<compute_case<double_t*>>(contiguous_as_dtype(allocator, *weights, DType::Float64, weights_temp));
+
+	auto result = va::empty(allocator, DType::Float64, shape_type { num_bins });
+	double_t* result_ptr = std::get<compute_case<double_t*>>(result->data).data();
+	std::fill_n(result_ptr, num_bins, double_t { 0 });
+
+	gather::parallel_scatter_reduce(result_ptr, num_bins, ids.ptr, ids.size, 1, weights_.data() + weights_.data_offset(), 1, double_t { 0 }, std::plus<double_t>());
+	return result;
+}
+
+std::shared_ptr<VArray> va::bincount(VStoreAllocator& allocator, const VData& x, const std::size_t minlength) {
+	return bincount_(allocator, x, nullptr, minlength);
+}
+
+std::shared_ptr<VArray> va::bincount(VStoreAllocator& allocator, const VData& x, const VData& weights, const std::size_t minlength) {
+	return bincount_(allocator, x, &weights, minlength);
+}
+
+template <typename T>
+struct SumOp {
+	static constexpr bool is_supported = true;
+
+	static T identity() { return T(0); }
+	T operator()(const T a, const T b) const { return a + b; }
+};
+
+template <typename T>
+struct MaxOp {
+	static constexpr bool is_supported = !xtl::is_complex<T>::value;
+
+	static T identity() {
+		if constexpr (std::numeric_limits<T>::has_infinity) return -std::numeric_limits<T>::infinity();
+		else return std::numeric_limits<T>::lowest();
+	}
+	// Propagates NaN, like maximum.
+	T operator()(const T a, const T b) const { return b > a || b != b ? b : a; }
+};
+
+template <template <typename> typename Op>
+static std::shared_ptr<VArray> segment_reduce(VStoreAllocator& allocator, const VData& data, const VData& segment_ids, const std::optional<std::size_t> num_segments, const bool sorted, const DType dtype) {
+	const auto ids = id_buffer(allocator, segment_ids);
+	const auto& shape = va::shape(data);
+
+	if (shape.empty() || shape[0] != ids.size) throw std::runtime_error("segment ids must match the first dimension of data");
+
+	const std::size_t num_segments_ = num_segments.value_or(static_cast<std::size_t>(ids.max + 1));
+	if (ids.min < 0 || (ids.size > 0 && static_cast<std::size_t>(ids.max) >= num_segments_)) {
+		throw std::runtime_error("segment ids must be in [0, num_segments)");
+	}
+	if (sorted && !std::is_sorted(ids.ptr, ids.ptr + ids.size)) throw std::runtime_error("segment ids must be sorted");
+
+	shape_type result_shape = shape;
+	result_shape[0] = num_segments_;
+	const std::size_t inner = std::accumulate(shape.begin() + 1, shape.end(), std::size_t { 1 }, std::multiplies<>());
+
+	std::shared_ptr<VArray> data_temp;
+	const VData& data_ = contiguous_as_dtype(allocator, data, dtype, data_temp);
+	auto result = va::empty(allocator, dtype, result_shape);
+
+	std::visit([&ids, &result, num_segments_, inner, sorted](const auto& array) {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+		using O = Op<T>;
+
+		if constexpr (!O::is_supported) {
+			throw std::runtime_error("unsupported dtype for segment reduction");
+		}
+		else {
+			T* result_ptr = std::get<compute_case<T*>>(result->data).data();
+			const T* values = array.data() + array.data_offset();
+			std::fill_n(result_ptr, num_segments_ * inner, O::identity());
+
+			if (sorted) gather::sorted_segment_reduce(result_ptr, ids.ptr, ids.size, inner, values, O());
+			else gather::parallel_scatter_reduce(result_ptr, num_segments_, ids.ptr, ids.size, inner, values, 1, O::identity(), O());
+		}
+	}, data_);
+
+	return result;
+}
+
+std::shared_ptr<VArray> va::segment_sum(VStoreAllocator& allocator, const VData& data, const VData& segment_ids, const std::optional<std::size_t> num_segments, const bool sorted) {
+	// Like sum, booleans are counted.
+	const DType dtype = va::dtype(data) == DType::Bool ? DType::Int64 : va::dtype(data);
+	return segment_reduce<SumOp>(allocator, data, segment_ids, num_segments, sorted, dtype);
+}
+
+std::shared_ptr<VArray> va::segment_max(VStoreAllocator& allocator, const VData& data, const VData& segment_ids, const std::optional<std::size_t> num_segments, const bool sorted) {
+	return segment_reduce<MaxOp>(allocator, data, segment_ids, num_segments, sorted, va::dtype(data));
+}
@@ -0,0 +1,20 @@
+#ifndef VATENSOR_SCATTER_HPP
+#define VATENSOR_SCATTER_HPP
+
+#include <cstddef>                         // for size_t
+#include <optional>                        // for optional
+
+#include "varray.hpp"
+
+namespace va {
+	// Counts occurrences of each non-negative value in x, or sums their weights.
+	std::shared_ptr<VArray> bincount(VStoreAllocator& allocator, const VData& x, std::size_t minlength);
+	std::shared_ptr<VArray> bincount(VStoreAllocator& allocator, const VData& x, const VData& weights, std::size_t minlength);
+
+	// Reduces rows of data with the same segment id. The result has num_segments rows (by default, the largest id + 1).
+	// If sorted, segment ids must be ascending, which allows a faster, conflict-free reduction.
+	std::shared_ptr<VArray> segment_sum(VStoreAllocator& allocator, const VData& data, const VData& segment_ids, std::optional<std::size_t> num_segments, bool sorted);
+	std::shared_ptr<VArray> segment_max(VStoreAllocator& allocator, const VData& data, const VData& segment_ids, std::optional<std::size_t> num_segments, bool sorted);
+}
+
+#endif //VATENSOR_SCATTER_HPP
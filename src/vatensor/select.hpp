@@ -0,0 +1,184 @@
+#ifndef VATENSOR_SELECT_HPP
+#define VATENSOR_SELECT_HPP
+
+#include <algorithm>                       // for nth_element, min_element
+#include <cstddef>                         // for size_t, ptrdiff_t
+#include <limits>                          // for numeric_limits
+#include <memory>                          // for unique_ptr
+#include <stdexcept>                       // for runtime_error
+#include <type_traits>                     // for decay_t, is_floating_point_v
+#include <vector>                          // for vector
+
+#include "dtype.hpp"
+#include "util.hpp"
+#include "vparallel.hpp"
+
+// Order statistics by selection (std::nth_element, an introselect), on raw memory.
+// Reductions work on lanes: the reduced axes span each lane, and the remaining axes enumerate the lanes.
+// Each lane is gathered into a scratch buffer, which is reused for all lanes of a thread.
+namespace va::select {
+	struct LaneAxes {
+		std::vector<std::size_t> outer;
+		std::vector<std::size_t> inner;
+	};
+
+	// Splits the axes of an array into those enumerating lanes (outer) and those spanning them (inner).
+	// If axes is nullptr, all axes are inner.
+	inline LaneAxes lane_axes(const std::size_t dimension, const axes_type* axes) {
+		std::vector<bool> is_inner(dimension, axes == nullptr);
+		if (axes) {
+			for (const auto axis : *axes) {
+				const std::size_t axis_ = util::normalize_axis(axis, dimension);
+				if (is_inner[axis_]) throw std::runtime_error("duplicate axis");
+				is_inner[axis_] = true;
+			}
+		}
+
+		LaneAxes lanes;
+		for (std::size_t axis = 0; axis < dimension; ++axis) {
+			(is_inner[axis] ? lanes.inner : lanes.outer).push_back(axis);
+		}
+		return lanes;
+	}
+
+	// Element offsets of all positions across the given axes, in row-major order.
+	template <typename Shape, typename Strides>
+	std::vector<std::ptrdiff_t> offsets(const Shape& shape, const Strides& strides, const std::vector<std::size_t>& axes) {
+		std::size_t size = 1;
+		for (const auto axis : axes) size *= shape[axis];
+
+		std::vector<std::ptrdiff_t> result(size);
+		std::vector<std::size_t> index(axes.size(), 0);
+		std::ptrdiff_t offset = 0;
+		for (std::size_t i = 0; i < size; ++i) {
+			result[i] = offset;
+			// Increment like an odometer, the last axis first.
+			for (std::size_t k = axes.size(); k-- > 0;) {
+				const std::size_t axis = axes[k];
+				if (++index[k] < shape[axis]) {
+					offset += strides[axis];
+					break;
+				}
+				offset -= strides[axis] * static_cast<std::ptrdiff_t>(shape[axis] - 1);
+				index[k] = 0;
+			}
+		}
+		return result;
+	}
+
+	template <typename E>
+	std::vector<std::ptrdiff_t> offsets(const E& e) {
+		std::vector<std::size_t> axes(e.dimension());
+		for (std::size_t i = 0; i < axes.size(); ++i) axes[i] = i;
+		return offsets(e.shape(), e.strides(), axes);
+	}
+
+	// The q-th quantile of the values, interpolated linearly between the closest ranks, like numpy's default method.
+	// Reorders the values.
+	template <typename T>
+	T quantile(T* values, const std::size_t size, const double q) {
+		if (size == 0) return std::numeric_limits<T>::quiet_NaN();
+
+		const double position = q * static_cast<double>(size - 1);
+		const std::size_t lo = std::min(static_cast<std::size_t>(position), size - 1);
+		const T t = static_cast<T>(position - static_cast<double>(lo));
+
+		std::nth_element(values, values + lo, values + size);
+		const T a = values[lo];
+		if (t == T(0) || lo + 1 >= size) return a;
+
+		// nth_element leaves all larger values behind lo, so the next rank is their minimum.
+		const T b = *std::min_element(values + lo + 1, values + size);
+		const T diff = b - a;
+		return t < T(0.5) ? a + diff * t : b - diff * (T(1) - t);
+	}
+
+	// ret = the q-th quantile of the lanes of a. NaN if a lane contains NaN.
+	template <typename R, typename A>
+	void quantile(R& ret, const A& a, const axes_type* axes, const double q) {
+		using T = typename A::value_type;
+
+		if (!(q >= 0 && q <= 1)) throw std::runtime_error("quantile must be in [0, 1]");
+
+		const LaneAxes lanes = lane_axes(a.dimension(), axes);
+		const auto outer_offsets = offsets(a.shape(), a.strides(), lanes.outer);
+		const auto inner_offsets = offsets(a.shape(), a.strides(), lanes.inner);
+		const auto ret_offsets = offsets(ret);
+		if (ret_offsets.size() != outer_offsets.size()) throw std::runtime_error("internal error: unexpected result size");
+
+		const T* data = a.data() + a.data_offset();
+		auto* out = ret.data() + ret.data_offset();
+		const std::size_t outer = outer_offsets.size();
+		const std::size_t inner = inner_offsets.size();
+
+		const std::size_t chunks = parallel::num_chunks(outer * inner, outer);
+		parallel::run(chunks, [&outer_offsets, &inner_offsets, &ret_offsets, data, out, chunks, outer, inner, q](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, outer);
+			std::vector<T> buffer(inner);
+
+			for (std::size_t j = begin; j < end; ++j) {
+				const T* lane = data + outer_offsets[j];
+				bool has_nan = false;
+				for (std::size_t k = 0; k < inner; ++k) {
+					const T value = lane[inner_offsets[k]];
+					buffer[k] = value;
+					has_nan |= value != value;
+				}
+
+				out[ret_offsets[j]] = static_cast<std::decay_t<decltype(*out)>>(
+					has_nan ? std::numeric_limits<T>::quiet_NaN() : quantile(buffer.data(), inner, q)
+				);
+			}
+		});
+	}
+
+	// Ascending order, with NaN after all other values, like numpy.
+	struct less {
+		template <typename T>
+		bool operator()(const T& a, const T& b) const {
+			if constexpr (std::is_floating_point_v<T>) {
+				return a < b || (b != b && a == a);
+			}
+			else {
+				return a < b;
+			}
+		}
+	};
+
+	// Partitions each lane along one axis in place, so that its kth element is the one it would be after sorting,
+	// with no larger elements before it and no smaller ones after it, as ordered by Less.
+	template <typename Less = less, typename T, typename Shape, typename Strides>
+	void partition(T* data, const Shape& shape, const Strides& strides, const std::size_t axis, const std::size_t kth) {
+		const axes_type axes { static_cast<std::ptrdiff_t>(axis) };
+		const LaneAxes lanes = lane_axes(shape.size(), &axes);
+		const auto outer_offsets = offsets(shape, strides, lanes.outer);
+		const std::size_t inner = shape[axis];
+		const std::ptrdiff_t stride = strides[axis];
+		if (kth >= inner) throw std::runtime_error("kth out of bounds");
+
+		const std::size_t outer = outer_offsets.size();
+		const std::size_t chunks = parallel::num_chunks(outer * inner, outer);
+		parallel::run(chunks, [&outer_offsets, data, chunks, outer, inner, stride, kth](const std::size_t chunk) {
+			const auto [begin, end] = parallel::chunk_range(chunk, chunks, outer);
+
+			if (stride == 1) {
+				for (std::size_t j = begin; j < end; ++j) {
+					T* lane = data + outer_offsets[j];
+					std::nth_element(lane, lane + kth, lane + inner, Less {});
+				}
+				return;
+			}
+
+			// Not a vector, because std::vector<bool> has no contiguous storage.
+			const std::unique_ptr<T[]> buffer(new T[inner]);
+			for (std::size_t j = begin; j < end; ++j) {
+				T* lane = data + outer_offsets[j];
+				for (std::size_t k = 0; k < inner; ++k) buffer[k] = lane[static_cast<std::ptrdiff_t>(k) * stride];
+				std::nth_element(buffer.get(), buffer.get() + kth, buffer.get() + inner, Less {});
+				for (std::size_t k = 0; k < inner; ++k) lane[static_cast<std::ptrdiff_t>(k) * stride] = buffer[k];
+			}
+		});
+	}
+}
+
+#endif //VATENSOR_SELECT_HPP
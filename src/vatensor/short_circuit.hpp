@@ -0,0 +1,136 @@
+#ifndef VATENSOR_SHORT_CIRCUIT_HPP
+#define VATENSOR_SHORT_CIRCUIT_HPP
+
+#include <algorithm>                      // for min
+#include <atomic>                         // for atomic
+#include <cstddef>                        // for size_t
+
+#include "dtype.hpp"
+#include "util.hpp"
+#include "vparallel.hpp"
+#include "xtensor/core/xstrides.hpp"     // for compute_strides
+
+// Searches for an element that decides a reduction (e.g. a false value for all), without evaluating the rest.
+// Elements are tested in blocks without branches, so that the compiler can vectorize each block.
+// The decision is checked between blocks.
+namespace va::short_circuit {
+	constexpr std::size_t block_size = 256;
+
+	// True if pred(i) holds for any i in [begin, end).
+	// Also gives up between blocks once stop is set, e.g. because another thread found a hit.
+	template<typename P>
+	bool any_index(std::size_t begin, const std::size_t end, P&& pred, const std::atomic<bool>* stop = nullptr) {
+		for (; begin < end; begin += block_size) {
+			const std::size_t block_end = std::min(begin + block_size, end);
+
+			bool hit = false;
+			for (std::size_t i = begin; i < block_end; ++i) {
+				hit |= static_cast<bool>(pred(i));
+			}
+			if (hit) return true;
+			if (stop && stop->load(std::memory_order_relaxed)) return false;
+		}
+		return false;
+	}
+
+	// True if pred holds for any of the next size elements of the iterator.
+	template<typename It, typename P>
+	bool any_iter(It it, const std::size_t size, P&& pred) {
+		for (std::size_t begin = 0; begin < size; begin += block_size) {
+			const std::size_t block_end = std::min(begin + block_size, size);
+
+			bool hit = false;
+			for (std::size_t i = begin; i < block_end; ++i, ++it) {
+				hit |= static_cast<bool>(pred(*it));
+			}
+			if (hit) return true;
+		}
+		return false;
+	}
+
+	// True if all of e can be read through e.data_element(i), in row-major order.
+	// This holds for contiguous arrays, and for element-wise functions of them that need no broadcasting.
+	template<typename E>
+	bool is_linear(const E& e) {
+		strides_type strides(e.dimension());
+		xt::compute_strides(e.shape(), xt::layout_type::row_major, strides);
+		return e.has_linear_assign(strides);
+	}
+
+	template<typename A, typename B>
+	bool is_broadcastable(const A& a, const B& b) {
+		if constexpr (!xt::is_xexpression<B>::value) {
+			return true;
+		}
+		else {
+			const auto& a_shape = a.shape();
+			const auto& b_shape = b.shape();
+			for (std::size_t i = 1; i <= std::min(a_shape.size(), b_shape.size()); ++i) {
+				const std::size_t a_dim = a_shape[a_shape.size() - i];
+				const std::size_t b_dim = b_shape[b_shape.size() - i];
+				if (a_dim != b_dim && a_dim != 1 && b_dim != 1) return false;
+			}
+			return true;
+		}
+	}
+
+	// True if pred holds for any element of e.
+	// Linear expressions are split across threads, which all stop once any of them finds a hit.
+	template<typename E, typename P>
+	bool any(const E& e, P&& pred) {
+		const std::size_t size = e.size();
+		if (!is_linear(e)) {
+			return any_iter(e.cbegin(), size, pred);
+		}
+
+		const auto pred_at = [&e, &pred](const std::size_t i) { return pred(e.data_element(i)); };
+
+		const std::size_t chunks = parallel::num_chunks(size, size);
+		if (chunks <= 1) {
+			return any_index(0, size, pred_at);
+		}
+
+		std::atomic<bool> found(false);
+		parallel::run(chunks, [&pred_at, &found, chunks, size](const std::size_t i) {
+			const auto [begin, end] = parallel::chunk_range(i, chunks, size);
+			if (any_index(begin, end, pred_at, &found)) {
+				found.store(true, std::memory_order_relaxed);
+			}
+		});
+		return found.load();
+	}
+
+	// Reduction over axes: ret[j] = invert != any(pred), over the j-th run of reduced elements.
+	// Handles only reductions over the innermost axes of linear inputs, where each run is contiguous.
+	// Returns false if the inputs are not eligible.
+	template<typename R, typename A, typename P>
+	bool try_any_inner_axes(R& ret, const A& a, const axes_type& axes, const bool invert, P&& pred) {
+		const auto inner_size = util::innermost_axes_size(a.shape(), axes);
+		if (!inner_size || !is_linear(a) || !is_linear(ret)) return false;
+
+		const std::size_t inner = *inner_size;
+		const std::size_t outer = ret.size();
+		if (outer * inner != a.size()) return false;
+
+		const auto reduce_rows = [&ret, &a, &pred, inner, invert](const std::size_t begin, const std::size_t end) {
+			for (std::size_t j = begin; j < end; ++j) {
+				const bool found = any_index(j * inner, (j + 1) * inner, [&a, &pred](const std::size_t i) { return pred(a.data_element(i)); });
+				ret.data_element(j) = static_cast<typename R::value_type>(invert != found);
+			}
+		};
+
+		const std::size_t chunks = parallel::num_chunks(a.size(), outer);
+		if (chunks <= 1) {
+			reduce_rows(0, outer);
+			return true;
+		}
+
+		parallel::run(chunks, [&reduce_rows, chunks, outer](const std::size_t i) {
+			const auto [begin, end] = parallel::chunk_range(i, chunks, outer);
+			reduce_rows(begin, end);
+		});
+		return true;
+	}
+}
+
+#endif //VATENSOR_SHORT_CIRCUIT_HPP
@@ -0,0 +1,266 @@
+#include "sort.hpp"
+
+#include <algorithm>                       // for copy, nth_element, partition, sort, stable_sort, unique
+#include <cstdint>                         // for int64_t
+#include <memory>                          // for unique_ptr
+#include <numeric>                         // for iota
+#include <stdexcept>                       // for runtime_error
+#include <type_traits>                     // for decay_t, is_floating_point_v
+#include <variant>                         // for visit
+#include <vector>                          // for vector
+#include "create.hpp"
+#include "radix.hpp"
+#include "select.hpp"
+#include "util.hpp"
+#include "vparallel.hpp"
+#include "xtl/xcomplex.hpp"                // for is_complex
+
+using namespace va;
+
+// Below this size, comparison sorts are faster than the fixed cost of radix passes.
+constexpr std::size_t radix_sort_min_size = 256;
+
+// Ascending order, with NaN last. Complex numbers are ordered by their real part first, like numpy.
+struct SortLess {
+	template <typename T>
+	bool operator()(const T& a, const T& b) const {
+		constexpr select::less less;
+		if constexpr (xtl::is_complex<T>::value) {
+			return less(a.real(), b.real()) || (!less(b.real(), a.real()) && less(a.imag(), b.imag()));
+		}
+		else {
+			return less(a, b);
+		}
+	}
+};
+
+static std::size_t normalize_sort_axis(const VData& a, const std::ptrdiff_t axis) {
+	if (va::dimension(a) == 0) throw std::runtime_error("cannot sort a 0-d array");
+	return util::normalize_axis(axis, va::dimension(a));
+}
+
+// a, or a contiguous copy of it.
+static const VData& contiguous(VStoreAllocator& allocator, const VData& a, std::shared_ptr<VArray>& temp) {
+	if (va::is_contiguous(a)) return a;
+
+	temp = va::copy(allocator, a);
+	return temp->data;
+}
+
+// Scratch memory to sort lanes of T, reused across the lanes of a thread.
+template <typename T>
+struct LaneSorter {
+	std::size_t size;
+	// Not a vector, because std::vector<bool> has no contiguous storage. Allocated when first needed.
+	std::unique_ptr<T[]> values;
+	std::vector<int64_t> indices;
+	std::vector<int64_t> indices_tmp;
+	std::vector<radix::key_t<T>> keys;
+	std::vector<radix::key_t<T>> keys_tmp;
+
+	explicit LaneSorter(const std::size_t size) : size(size) {}
+
+	T* buffer() {
+		if (!values) values.reset(new T[size]);
+		return values.get();
+	}
+
+	static constexpr bool use_radix(const std::size_t size) {
+		return radix::is_supported<T> && size >= radix_sort_min_size;
+	}
+
+	// Sorts a lane in place.
+	void sort(T* lane, const std::size_t stride) {
+		T* data = lane;
+		if (stride != 1) {
+			data = buffer();
+			for (std::size_t i = 0; i < size; ++i) data[i] = lane[i * stride];
+		}
+
+		if constexpr (radix::is_supported<T>) {
+			if (use_radix(size)) {
+				keys.resize(size);
+				keys_tmp.resize(size);
+				for (std::size_t i = 0; i < size; ++i) keys[i] = radix::to_key(data[i]);
+				radix::sort(keys.data(), static_cast<int64_t*>(nullptr), size, keys_tmp.data(), static_cast<int64_t*>(nullptr));
+				for (std::size_t i = 0; i < size; ++i) data[i] = radix::from_key<T>(keys[i]);
+			}
+			else if constexpr (std::is_floating_point_v<T>) {
+				// With NaN moved to the back, the rest can be sorted without NaN checks.
+				T* end = std::partition(data, data + size, [](const T value) { return value == value; });
+				std::sort(data, end);
+			}
+			else {
+				std::sort(data, data + size);
+			}
+		}
+		else {
+			std::sort(data, data + size, SortLess {});
+		}
+
+		if (stride != 1) {
+			for (std::size_t i = 0; i < size; ++i) lane[i * stride] = data[i];
+		}
+	}
+
+	// Writes the indices that would sort a lane to out, which has the same stride.
+	void argsort(const T* lane, int64_t* out, const std::size_t stride) {
+		indices.resize(size);
+		std::iota(indices.begin(), indices.end(), int64_t { 0 });
+
+		if constexpr (radix::is_supported<T>) {
+			if (use_radix(size)) {
+				keys.resize(size);
+				keys_tmp.resize(size);
+				indices_tmp.resize(size);
+				for (std::size_t i = 0; i < size; ++i) keys[i] = radix::to_key(lane[i * stride]);
+				radix::sort(keys.data(), indices.data(), size, keys_tmp.data(), indices_tmp.data());
+			}
+		}
+		if (!use_radix(size)) {
+			T* data = buffer();
+			for (std::size_t i = 0; i < size; ++i) data[i] = lane[i * stride];
+			std::stable_sort(indices.begin(), indices.end(), [data](const int64_t i, const int64_t j) {
+				return SortLess {}(data[i], data[j]);
+			});
+		}
+
+		for (std::size_t i = 0; i < size; ++i) out[i * stride] = indices[i];
+	}
+
+	// Writes the k first elements of a lane to values_out, and their indices to indices_out, which have the given stride.
+	// The order is descending if largest, else ascending. Ties are broken by index.
+	void top_k(const T* lane, const std::size_t stride, const std::size_t k, const bool largest, T* values_out, int64_t* indices_out, const std::size_t out_stride) {
+		T* data = buffer();
+		for (std::size_t i = 0; i < size; ++i) data[i] = lane[i * stride];
+		indices.resize(size);
+		std::iota(indices.begin(), indices.end(), int64_t { 0 });
+
+		const auto first = [data, largest](const int64_t i, const int64_t j) {
+			constexpr SortLess less;
+			const T& a = largest ? data[j] : data[i];
+			const T& b = largest ? data[i] : data[j];
+			return less(a, b) || (!less(b, a) && i < j);
+		};
+		if (k < size) std::nth_element(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(k), indices.end(), first);
+		std::sort(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(k), first);
+
+		for (std::size_t i = 0; i < k; ++i) {
+			values_out[i * out_stride] = data[indices[i]];
+			indices_out[i * out_stride] = indices[i];
+		}
+	}
+};
+
+std::shared_ptr<VArray> va::sort(VStoreAllocator& allocator, const VData& a, const std::ptrdiff_t axis) {
+	const util::Lanes lanes = util::lanes_along(va::shape(a), normalize_sort_axis(a, axis));
+	auto result = va::copy(allocator, a);
+
+	std::visit([&lanes](auto& array) {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+		T* data = array.data() + array.data_offset();
+
+		parallel::run_lanes(lanes, [&lanes, data](const std::size_t begin, const std::size_t end) {
+			LaneSorter<T> sorter(lanes.size);
+			for (std::size_t j = begin; j < end; ++j) sorter.sort(data + lanes.offset(j), lanes.stride);
+		});
+	}, result->data);
+
+	return result;
+}
+
+std::shared_ptr<VArray> va::argsort(VStoreAllocator& allocator, const VData& a, const std::ptrdiff_t axis) {
+	const util::Lanes lanes = util::lanes_along(va::shape(a), normalize_sort_axis(a, axis));
+
+	std::shared_ptr<VArray> a_temp;
+	const VData& a_ = contiguous(allocator, a, a_temp);
+	auto result = va::empty(allocator, DType::Int64, va::shape(a));
+	int64_t* result_ptr = std::get<compute_case<int64_t*>>(result->data).data();
+
+	std::visit([&lanes, result_ptr](const auto& array) {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+		const T* data = array.data() + array.data_offset();
+
+		parallel::run_lanes(lanes, [&lanes, data, result_ptr](const std::size_t begin, const std::size_t end) {
+			LaneSorter<T> sorter(lanes.size);
+			for (std::size_t j = begin; j < end; ++j) {
+				const std::size_t offset = lanes.offset(j);
+				sorter.argsort(data + offset, result_ptr + offset, lanes.stride);
+			}
+		});
+	}, a_);
+
+	return result;
+}
+
+std::shared_ptr<VArray> va::partition(VStoreAllocator& allocator, const VData& a, const std::ptrdiff_t kth, const std::ptrdiff_t axis) {
+	const std::size_t axis_ = normalize_sort_axis(a, axis);
+	const std::ptrdiff_t size = static_cast<std::ptrdiff_t>(va::shape(a)[axis_]);
+	const std::ptrdiff_t kth_ = kth < 0 ? kth + size : kth;
+	if (kth_ < 0 || kth_ >= size) throw std::runtime_error("kth out of bounds");
+
+	auto result = va::copy(allocator, a);
+
+	std::visit([axis_, kth_](auto& array) {
+		select::partition<SortLess>(array.data() + array.data_offset(), array.shape(), array.strides(), axis_, static_cast<std::size_t>(kth_));
+	}, result->data);
+
+	return result;
+}
+
+std::pair<std::shared_ptr<VArray>, std::shared_ptr<VArray>> va::top_k(VStoreAllocator& allocator, const VData& a, const std::size_t k, const std::ptrdiff_t axis, const bool largest) {
+	const std::size_t axis_ = normalize_sort_axis(a, axis);
+	const util::Lanes lanes = util::lanes_along(va::shape(a), axis_);
+	if (k > lanes.size) throw std::runtime_error("k must not exceed the size of the axis");
+
+	shape_type result_shape = va::shape(a);
+	result_shape[axis_] = k;
+	const util::Lanes result_lanes = util::lanes_along(result_shape, axis_);
+
+	std::shared_ptr<VArray> a_temp;
+	const VData& a_ = contiguous(allocator, a, a_temp);
+	auto values = va::empty(allocator, va::dtype(a), result_shape);
+	auto indices = va::empty(allocator, DType::Int64, result_shape);
+	int64_t* indices_ptr = std::get<compute_case<int64_t*>>(indices->data).data();
+
+	// k may be 0, in which case there are no lanes to fill.
+	if (result_lanes.count == 0) return { values, indices };
+
+	std::visit([&lanes, &result_lanes, &values, indices_ptr, k, largest](const auto& array) {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+		const T* data = array.data() + array.data_offset();
+		T* values_ptr = std::get<compute_case<T*>>(values->data).data();
+
+		parallel::run_lanes(lanes, [&lanes, &result_lanes, data, values_ptr, indices_ptr, k, largest](const std::size_t begin, const std::size_t end) {
+			LaneSorter<T> sorter(lanes.size);
+			for (std::size_t j = begin; j < end; ++j) {
+				const std::size_t offset = result_lanes.offset(j);
+				sorter.top_k(data + lanes.offset(j), lanes.stride, k, largest, values_ptr + offset, indices_ptr + offset, result_lanes.stride);
+			}
+		});
+	}, a_);
+
+	return { values, indices };
+}
+
+std::shared_ptr<VArray> va::unique(VStoreAllocator& allocator, const VData& a) {
+	auto sorted = va::copy(allocator, a);
+
+	return std::visit([&allocator, dtype = va::dtype(a)](auto& array) -> std::shared_ptr<VArray> {
+		using T = typename std::decay_t<decltype(array)>::value_type;
+		T* data = array.data() + array.data_offset();
+		const std::size_t size = array.size();
+
+		LaneSorter<T>(size).sort(data, 1);
+		// Equivalent elements are equal, except that NaN are equivalent to each other.
+		T* end = std::unique(data, data + size, [](const T& x, const T& y) {
+			constexpr SortLess less;
+			return !less(x, y) && !less(y, x);
+		});
+
+		const std::size_t count = static_cast<std::size_t>(end - data);
+		auto result = va::empty(allocator, dtype, shape_type { count });
+		std::copy(data, end, std::get<compute_case<T*>>(result->data).data());
+		return result;
+	}, sorted->data);
+}
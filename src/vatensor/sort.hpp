@@ -0,0 +1,24 @@
+#ifndef VATENSOR_SORT_HPP
+#define VATENSOR_SORT_HPP
+
+#include <cstddef>                         // for ptrdiff_t, size_t
+#include <utility>                         // for pair
+
+#include "varray.hpp"
+
+namespace va {
+	// Sorted copies of a, along an axis. NaN are sorted last, complex numbers by their real part first.
+	std::shared_ptr<VArray> sort(VStoreAllocator& allocator, const VData& a, std::ptrdiff_t axis);
+	// Int64 indices that would sort a along an axis. Equal elements keep their order.
+	std::shared_ptr<VArray> argsort(VStoreAllocator& allocator, const VData& a, std::ptrdiff_t axis);
+
+	// A copy of a, with each lane along axis partitioned around its kth element, like numpy.partition.
+	std::shared_ptr<VArray> partition(VStoreAllocator& allocator, const VData& a, std::ptrdiff_t kth, std::ptrdiff_t axis);
+	// The k largest (or smallest) elements along an axis, in order, and their int64 indices.
+	std::pair<std::shared_ptr<VArray>, std::shared_ptr<VArray>> top_k(VStoreAllocator& allocator, const VData& a, std::size_t k, std::ptrdiff_t axis, bool largest);
+
+	// The sorted, distinct elements of a, flattened. All NaN count as one element.
+	std::shared_ptr<VArray> unique(VStoreAllocator& allocator, const VData& a);
+}
+
+#endif //VATENSOR_SORT_HPP
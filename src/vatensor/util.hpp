@@ -1,7 +1,21 @@
 #ifndef VATENSOR_UTIL_HPP
 #define VATENSOR_UTIL_HPP
 
+#include <complex>                         // for complex
+#include <cstddef>                         // for size_t, ptrdiff_t
+#include <functional>                      // for multiplies
+#include <numeric>                         // for accumulate
+#include <optional>                        // for optional, nullopt
+#include <stdexcept>                       // for runtime_error
+#include <vector>                          // for vector
+
 namespace va::util {
+	// a * b. std::complex multiplication checks for inf / nan, which prevents vectorization.
+	template<typename T>
+	std::complex<T> complex_multiply(const std::complex<T> a, const std::complex<T> b) {
+		return { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+	}
+
 	inline std::size_t normalize_axis(const std::ptrdiff_t axis, const std::size_t dimension) {
 		if (axis >= 0 && axis >= dimension) {
 			throw std::runtime_error("axis out of range");
@@ -10,7 +24,7 @@ namespace va::util {
 			throw std::runtime_error("axis out of range");
 		}
 
-		return xt::normalize_axis(dimension, axis);
+		return axis < 0 ? static_cast<std::size_t>(axis + static_cast<std::ptrdiff_t>(dimension)) : static_cast<std::size_t>(axis);
     };
 
 	inline std::size_t normalize_index(const std::ptrdiff_t index, const std::size_t size) {
@@ -21,8 +35,49 @@ namespace va::util {
 			throw std::runtime_error("index out of range");
 		}
 
-		return xt::normalize_axis(size, index);
+		return index < 0 ? static_cast<std::size_t>(index + static_cast<std::ptrdiff_t>(size)) : static_cast<std::size_t>(index);
     };
+
+	// If the axes are exactly the innermost axes of the shape, in any order, returns the number of elements they span.
+	template<typename S, typename Axes>
+	std::optional<std::size_t> innermost_axes_size(const S& shape, const Axes& axes) {
+		const std::size_t dimension = shape.size();
+		if (axes.size() > dimension) return std::nullopt;
+
+		const std::size_t first = dimension - axes.size();
+		std::vector<bool> is_seen(axes.size(), false);
+		for (const auto axis : axes) {
+			const std::size_t axis_ = normalize_axis(axis, dimension);
+			if (axis_ < first || is_seen[axis_ - first]) return std::nullopt;
+			is_seen[axis_ - first] = true;
+		}
+
+		std::size_t size = 1;
+		for (std::size_t i = first; i < dimension; ++i) {
+			size *= shape[i];
+		}
+		return size;
+	}
+
+	// Lanes along one axis of a contiguous row-major array.
+	struct Lanes {
+		std::size_t count;
+		std::size_t size;
+		// Elements between neighbours of a lane.
+		std::size_t stride;
+
+		std::size_t offset(const std::size_t lane) const {
+			return lane / stride * size * stride + lane % stride;
+		}
+	};
+
+	template<typename S>
+	Lanes lanes_along(const S& shape, const std::size_t axis) {
+		const std::size_t total = std::accumulate(shape.begin(), shape.end(), std::size_t { 1 }, std::multiplies<>());
+		const std::size_t stride = std::accumulate(shape.begin() + axis + 1, shape.end(), std::size_t { 1 }, std::multiplies<>());
+		const std::size_t size = shape[axis];
+		return { size == 0 ? 0 : total / size, size, stride };
+	}
 }
 
 #endif //VATENSOR_UTIL_HPP
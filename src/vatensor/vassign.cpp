@@ -1,11 +1,16 @@
 #include "vassign.hpp"
 
+#include <functional>                                   // for multiplies
+#include <numeric>                                      // for accumulate
+#include <optional>                                     // for optional
 #include <type_traits>                                  // for decay_t
 #include <variant>                                      // for visit
+#include <vector>                                       // for vector
 #include "varray.hpp"                            // for VData, VScalar
 #include "create.hpp"
-#include <xtensor/views/xmasked_view.hpp>
-#include <xtensor/views/xindex_view.hpp>
+#include <xtensor/core/xoperation.hpp>
+#include "gather.hpp"
+#include "util.hpp"
 #include "vcarray.hpp"
 #include "vcompute.hpp"
 #include "vpromote.hpp"
@@ -65,189 +70,322 @@ void va::assign(const VArrayTarget& target, VScalar value) {
 	}
 }
 
+static const VData& contiguous(VStoreAllocator& allocator, const VData& data, std::shared_ptr<VArray>& temp) {
+	if (va::is_contiguous(data)) return data;
+
+	temp = va::copy(allocator, data);
+	return temp->data;
+}
+
+// values cast to dtype, and contiguous unless it is a single value.
+static const VData& values_buffer(VStoreAllocator& allocator, const VData& values, const DType dtype, std::shared_ptr<VArray>& temp) {
+	if (va::dtype(values) == dtype && (va::size(values) == 1 || va::is_contiguous(values))) return values;
+
+	temp = va::copy_as_dtype(allocator, values, dtype);
+	return temp->data;
+}
+
 std::shared_ptr<VArray> va::get_at_mask(VStoreAllocator& allocator, const VData& data, const VData& mask) {
 	if (va::dtype(mask) != va::DType::Bool) throw std::runtime_error("mask must be boolean dtype");
+	if (va::shape(data) != va::shape(mask)) throw std::runtime_error("mask must be same shape as array");
 
-	auto& mask_ = std::get<compute_case<bool*>>(mask);
-	const size_t array_size = xt::sum(mask_, xt::evaluation_strategy::immediate)();
+	std::shared_ptr<VArray> data_temp;
+	std::shared_ptr<VArray> mask_temp;
+	const VData& data_ = contiguous(allocator, data, data_temp);
+	const auto& mask_ = std::get<compute_case<bool*>>(contiguous(allocator, mask, mask_temp));
+	const bool* mask_ptr = mask_.data() + mask_.data_offset();
 
-	auto result_varray = va::empty(allocator, va::dtype(data), shape_type { array_size });
-	auto& result_data = result_varray->data;
+	// Chunks count their true values first, so that they know where to write their results.
+	const auto offsets = gather::mask_chunk_offsets(mask_ptr, mask_.size());
+	auto result = va::empty(allocator, va::dtype(data), shape_type { offsets.back() });
 
-	std::visit([&mask_, &result_data](const auto& array) {
+	std::visit([&result, &offsets, mask_ptr](const auto& array) {
 		using VTArray = typename std::decay_t<decltype(array)>::value_type;
 
-		auto result_compute = std::get<compute_case<VTArray*>>(result_data);
+		auto& result_data = std::get<compute_case<VTArray*>>(result->data);
+		gather::parallel_compress(result_data.data(), array.data() + array.data_offset(), mask_ptr, array.size(), offsets);
+	}, data_);
 
-		// Masked views don't offer this functionality automatically.
-		const auto masked_view = xt::masked_view(array, mask_);
-
-		auto iter_result = result_compute.begin();
-		for (auto masked_value : masked_view) {
-			if (masked_value.visible()) {
-				*iter_result = masked_value.value();
-				++iter_result;
-			}
-		}
-	}, data);
-
-	return result_varray;
+	return result;
 }
 
-void va::set_at_mask(VData& varray, VData& mask, VData& value) {
-	// This case is not handled again later, so we actually need this 'performance' check.
-    if (va::dimension(value) == 0) {
-	    return set_at_mask(varray, mask, va::to_single_value(value));
-    }
+void va::set_at_mask(VStoreAllocator& allocator, VData& varray, const VData& mask, const VData& value) {
+	// Handled as a fill, which needs no mask sum.
+	if (va::size(value) == 1) {
+		return set_at_mask(varray, mask, va::to_single_value(value));
+	}
 
 	if (va::dtype(mask) != va::DType::Bool) throw std::runtime_error("mask must be boolean dtype");
+	if (va::shape(varray) != va::shape(mask)) throw std::runtime_error("mask must be same shape as array");
 
-	auto& mask_ = std::get<compute_case<bool*>>(mask);
-	const size_t array_size = xt::sum(mask_, xt::evaluation_strategy::immediate)();
-	const auto& array_shape = va::shape(varray);
-
-	if (array_shape != mask_.shape()) {
-		throw std::runtime_error("mask must be same shape as array");
+	if (!va::is_contiguous(varray)) {
+		const auto varray_copy = va::copy(allocator, varray);
+		va::set_at_mask(allocator, varray_copy->data, mask, value);
+		va::assign(varray, varray_copy->data);
+		return;
 	}
 
-	// Masked views don't offer array fill functionality automatically.
-	if (va::shape(value) != shape_type { array_size }) {
-		throw std::runtime_error("mask must be single value or match the mask sum");
+	std::shared_ptr<VArray> mask_temp;
+	const auto& mask_ = std::get<compute_case<bool*>>(contiguous(allocator, mask, mask_temp));
+	const bool* mask_ptr = mask_.data() + mask_.data_offset();
+
+	const auto offsets = gather::mask_chunk_offsets(mask_ptr, mask_.size());
+	if (va::shape(value) != shape_type { offsets.back() }) {
+		throw std::runtime_error("value must be single value or match the mask sum");
 	}
 
-	std::visit(
-		// Mask can't be const because of masked_view iterator.
-		[&mask_](auto& array, const auto& value) {
-			using VTArray = typename std::decay_t<decltype(array)>::value_type;
-			using VTValue = typename std::decay_t<decltype(value)>::value_type;
-
-			if constexpr (!std::is_convertible_v<VTValue, VTArray>) {
-				throw std::runtime_error("Cannot promote this way.");
-			}
-			else {
-				auto masked_view = xt::masked_view(array, mask_);
-
-				const auto stride = value.strides()[0];
-				auto iter_value = value.begin();
-				for (auto masked_value : masked_view) {
-					if (masked_value.visible()) {
-						masked_value.value() = static_cast<VTArray>(*iter_value);
-						iter_value += stride;
-					}
-				}
-			}
-		}, varray, value
-	);
+	std::shared_ptr<VArray> value_temp;
+	const VData& value_ = values_buffer(allocator, value, va::dtype(varray), value_temp);
+
+	std::visit([&value_, &offsets, mask_ptr](auto& array) {
+		using VTArray = typename std::decay_t<decltype(array)>::value_type;
+
+		const auto& value_data = std::get<compute_case<VTArray*>>(value_);
+		gather::parallel_expand(array.data() + array.data_offset(), value_data.data() + value_data.data_offset(), mask_ptr, array.size(), offsets);
+	}, varray);
 }
 
-void va::set_at_mask(VData& varray, VData& mask, VScalar value) {
+void va::set_at_mask(VData& varray, const VData& mask, const VScalar value) {
 	if (va::dtype(mask) != va::DType::Bool) throw std::runtime_error("mask must be boolean dtype");
+	if (va::shape(varray) != va::shape(mask)) throw std::runtime_error("mask must be same shape as array");
 
-	auto& mask_ = std::get<compute_case<bool*>>(mask);
-	const auto& array_shape = va::shape(varray);
+	const auto& mask_ = std::get<compute_case<bool*>>(mask);
+	const bool is_contiguous = va::is_contiguous(varray) && va::is_contiguous(mask);
 
-	if (array_shape != mask_.shape()) {
-		throw std::runtime_error("mask must be same shape as array");
-	}
+	std::visit([&mask_, value, is_contiguous](auto& array) {
+		using VTArray = typename std::decay_t<decltype(array)>::value_type;
 
-	std::visit(
-		// Mask can't be const because of masked_view iterator.
-		[&mask_](auto& array, const auto value) {
-			using VTArray = typename std::decay_t<decltype(array)>::value_type;
-			using VTValue = std::decay_t<decltype(value)>;
-
-			if constexpr (!std::is_convertible_v<VTValue, VTArray>) {
-				throw std::runtime_error("Cannot promote this way.");
-			}
-			else {
-				auto masked_view = xt::masked_view(array, mask_);
-				masked_view = value;
-			}
-		}, varray, value
-	);
+		const auto value_ = static_cast_scalar<VTArray>(value);
+		if (is_contiguous) {
+			gather::parallel_masked_fill(array.data() + array.data_offset(), mask_.data() + mask_.data_offset(), array.size(), value_);
+		}
+		else {
+			// Reads and writes each element once, so it's safe to select from the array itself.
+			va::parallel_assign_typesafe(array, xt::where(mask_, value_, array));
+		}
+	}, varray);
 }
 
-template<typename A>
-xt::svector<xt::svector<size_type>> array_to_indices(const A& indices) {
-	// TODO we could optimize 1d indices, xtensor supports this.
-	if (indices.dimension() != 1 && indices.dimension() != 2) throw std::runtime_error("index list must be 1d or 2d");
+// Calls f with the index buffer as int32 or int64, so the kernels can read it directly.
+// Other integer dtypes are converted to int64 first.
+template <typename F>
+static void visit_index_buffer(VStoreAllocator& allocator, const VData& indices, F&& f) {
+	if (!va::is_integer_dtype(va::dtype(indices))) throw std::runtime_error("index list must be integer dtype");
+
+	switch (va::dtype(indices)) {
+		case DType::Int32:
+			f(std::get<compute_case<int32_t*>>(indices));
+			return;
+		case DType::Int64:
+			f(std::get<compute_case<int64_t*>>(indices));
+			return;
+		default: {
+			const auto indices_int64 = va::copy_as_dtype(allocator, indices, DType::Int64);
+			f(std::get<compute_case<int64_t*>>(indices_int64->data));
+			return;
+		}
+	}
+}
 
-	const auto num_indices = indices.shape()[0];
-	const auto num_dimensions = indices.dimension() == 2 ? indices.shape()[1] : 1;
-	const auto stride = indices.strides()[0];
+// Element offsets into data for an index list of shape (N, dimension), or (N) for 1D arrays.
+static std::vector<std::ptrdiff_t> index_list_offsets(VStoreAllocator& allocator, const VData& data, const VData& indices) {
+	const auto array_dimension = va::dimension(data);
+	const auto& indices_shape = va::shape(indices);
 
-	// TODO This should be possible without allocating separately for each xidx, no?
-	xt::svector<xt::svector<size_type>> xindices(num_indices);
-	for (int i = 0; i < num_indices; ++i) {
-		xt::svector<size_type> xidx(num_dimensions);
-		std::copy_n(indices.begin() + i * stride, num_dimensions, xidx.begin());
-		xindices[i] = std::move(xidx);
+	if (indices_shape.size() != 1 && indices_shape.size() != 2) throw std::runtime_error("index list must be 1d or 2d");
+	if (indices_shape.size() == 1 && array_dimension != 1) throw std::runtime_error("cannot use 1D index list for nd tensor");
+	if (indices_shape.size() == 2 && indices_shape[1] != array_dimension) throw std::runtime_error("index list dimension 2 must match array dimension");
+
+	std::vector<std::ptrdiff_t> offsets(indices_shape[0]);
+	visit_index_buffer(allocator, indices, [&offsets, &data](const auto& indices_) {
+		const auto& strides = indices_.strides();
+		gather::index_list_offsets(
+			offsets.data(),
+			indices_.data() + indices_.data_offset(),
+			offsets.size(),
+			strides[0],
+			indices_.dimension() == 2 ? strides[1] : 0,
+			va::shape(data),
+			va::strides(data)
+		);
+	});
+	return offsets;
+}
+
+// Indices along an axis of the given size, in row-major order of the index array.
+static std::vector<std::ptrdiff_t> axis_indices(VStoreAllocator& allocator, const VData& indices, const std::size_t size) {
+	if (va::dimension(indices) > 1 && !va::is_contiguous(indices)) {
+		if (!va::is_integer_dtype(va::dtype(indices))) throw std::runtime_error("index list must be integer dtype");
+		return axis_indices(allocator, va::copy_as_dtype(allocator, indices, DType::Int64)->data, size);
 	}
-	return xindices;
+
+	std::vector<std::ptrdiff_t> result(va::size(indices));
+	visit_index_buffer(allocator, indices, [&result, size](const auto& indices_) {
+		const std::ptrdiff_t stride = indices_.dimension() == 1 ? indices_.strides()[0] : 1;
+		gather::normalize_indices(result.data(), indices_.data() + indices_.data_offset(), result.size(), stride, size);
+	});
+	return result;
 }
 
-xt::svector<xt::svector<size_type>> get_as_indices(const VData& indices) {
-	return std::visit(
-		[](const auto& indices) -> xt::svector<xt::svector<size_type>> {
-			using VTIndices = typename std::decay_t<decltype(indices)>::value_type;
-
-			if constexpr (!std::is_integral_v<VTIndices> || std::is_same_v<VTIndices, bool>) {
-				throw std::runtime_error("mask must be integer dtype");
-			}
-			else {
-				// Index views need to be vectors of xindex.
-				return array_to_indices(indices);
-			}
-		}, indices
-	);
+// A contiguous array viewed as (outer, axis_size, inner) around an axis.
+struct AxisSplit {
+	std::size_t outer;
+	std::size_t axis_size;
+	std::size_t inner;
+};
+
+// Without an axis, the array is viewed flat.
+static AxisSplit split_at_axis(const shape_type& shape, const std::optional<std::size_t> axis) {
+	const auto product = [&shape](const std::size_t begin, const std::size_t end) {
+		return std::accumulate(shape.begin() + begin, shape.begin() + end, std::size_t { 1 }, std::multiplies<>());
+	};
+
+	if (!axis.has_value()) return { 1, product(0, shape.size()), 1 };
+	return { product(0, *axis), shape[*axis], product(*axis + 1, shape.size()) };
 }
 
 std::shared_ptr<VArray> va::get_at_indices(VStoreAllocator& allocator, const VData& data, const VData& indices) {
-	const auto indices_norm = get_as_indices(indices);
-	const auto array_dimension = va::dimension(data);
-	const auto& indices_shape = va::shape(indices);
+	const auto offsets = index_list_offsets(allocator, data, indices);
+	auto result = va::empty(allocator, va::dtype(data), shape_type { offsets.size() });
 
-	if (indices_shape.size() == 1 && array_dimension != 1) throw std::runtime_error("cannot use 1D index list for nd tensor");
-	if (va::shape(indices)[1] != array_dimension) throw std::runtime_error("index list dimension 2 must match array dimension");
+	std::visit([&offsets, &result](const auto& array) {
+		using VTArray = typename std::decay_t<decltype(array)>::value_type;
+
+		auto& result_data = std::get<compute_case<VTArray*>>(result->data);
+		gather::gather(result_data.data(), array.data() + array.data_offset(), offsets.data(), offsets.size());
+	}, data);
+
+	return result;
+}
 
-	return std::visit([&indices_norm, &allocator](const auto& array) -> std::shared_ptr<VArray> {
+void va::set_at_indices(VStoreAllocator& allocator, VData& data, const VData& indices, const VData& value) {
+	const auto offsets = index_list_offsets(allocator, data, indices);
+
+	if (va::size(value) != 1 && va::shape(value) != shape_type { offsets.size() }) {
+		throw std::runtime_error("value must be single value or match the index list length");
+	}
+
+	// Cast once up front, so the scatter runs on a single type.
+	std::shared_ptr<VArray> value_cast;
+	const VData* value_ = &value;
+	if (va::dtype(value) != va::dtype(data)) {
+		value_cast = va::copy_as_dtype(allocator, value, va::dtype(data));
+		value_ = &value_cast->data;
+	}
+	const std::ptrdiff_t value_stride = va::size(*value_) == 1 ? 0 : va::strides(*value_)[0];
+
+	std::visit([&offsets, value_, value_stride](auto& array) {
 		using VTArray = typename std::decay_t<decltype(array)>::value_type;
-		return va::create_varray<VTArray>(allocator, xt::index_view(array, indices_norm));
+
+		const auto& value_data = std::get<compute_case<VTArray*>>(*value_);
+		gather::scatter(array.data() + array.data_offset(), offsets.data(), offsets.size(), value_data.data() + value_data.data_offset(), value_stride);
 	}, data);
 }
 
-void va::set_at_indices(VData& data, VData& indices, VData& value) {
-	const auto indices_norm = get_as_indices(indices);
-	const auto array_dimension = va::dimension(data);
+std::shared_ptr<VArray> va::take(VStoreAllocator& allocator, const VData& data, const VData& indices, const std::optional<std::ptrdiff_t> axis) {
+	const auto& shape = va::shape(data);
+	const auto axis_ = axis.has_value() ? std::optional { util::normalize_axis(*axis, shape.size()) } : std::nullopt;
+	const auto split = split_at_axis(shape, axis_);
+	const auto offsets = axis_indices(allocator, indices, split.axis_size);
+
+	shape_type result_shape;
 	const auto& indices_shape = va::shape(indices);
+	if (axis_.has_value()) {
+		result_shape.insert(result_shape.end(), shape.begin(), shape.begin() + *axis_);
+		result_shape.insert(result_shape.end(), indices_shape.begin(), indices_shape.end());
+		result_shape.insert(result_shape.end(), shape.begin() + *axis_ + 1, shape.end());
+	}
+	else {
+		result_shape = indices_shape;
+	}
 
-	if (indices_shape.size() == 1 && array_dimension != 1) throw std::runtime_error("cannot use 1D index list for nd tensor");
-	if (indices_shape[1] != array_dimension) throw std::runtime_error("index list dimension 2 must match array dimension");
+	// The kernel reads blocks of the source as raw memory.
+	std::shared_ptr<VArray> data_copy;
+	const VData* data_ = &data;
+	if (!va::is_contiguous(data)) {
+		data_copy = va::copy(allocator, data);
+		data_ = &data_copy->data;
+	}
 
-	std::visit(
-		[&indices_norm](auto& array, const auto& value) {
-			using VTArray = typename std::decay_t<decltype(array)>::value_type;
-			using VTValue = typename std::decay_t<decltype(value)>::value_type;
-
-			if constexpr (!std::is_convertible_v<VTValue, VTArray>) {
-				throw std::runtime_error("Cannot promote this way.");
-			}
-			else {
-
-				// Index views need to be vectors of xindex.
-				auto index_view = xt::index_view(array, indices_norm);
-
-#ifdef XTENSOR_USE_XSIMD
-				if constexpr (xtl::is_complex<VTArray>::value) {
-					// See above; xsimd cannot auto-convert to complex types
-					index_view = xt::cast<VTArray>(value);
-				}
-				else
-#endif
-				{
-					index_view = value;
-				}
-			}
-		}, data, value
-	);
+	auto result = va::empty(allocator, va::dtype(data), result_shape);
+
+	std::visit([&offsets, &result, &split](const auto& array) {
+		using VTArray = typename std::decay_t<decltype(array)>::value_type;
+
+		auto& result_data = std::get<compute_case<VTArray*>>(result->data);
+		gather::take(result_data.data(), array.data() + array.data_offset(), offsets.data(), offsets.size(), split.outer, split.axis_size, split.inner);
+	}, *data_);
+
+	return result;
+}
+
+void va::put(VStoreAllocator& allocator, VData& data, const VData& indices, const VData& values, const std::optional<std::ptrdiff_t> axis) {
+	if (!va::is_contiguous(data)) {
+		// The kernel writes blocks of the target as raw memory.
+		const auto data_copy = va::copy(allocator, data);
+		va::put(allocator, data_copy->data, indices, values, axis);
+		va::assign(data, data_copy->data);
+		return;
+	}
+
+	const auto& shape = va::shape(data);
+	const auto axis_ = axis.has_value() ? std::optional { util::normalize_axis(*axis, shape.size()) } : std::nullopt;
+	const auto split = split_at_axis(shape, axis_);
+	const auto offsets = axis_indices(allocator, indices, split.axis_size);
+
+	if (va::size(values) != 1 && va::size(values) != split.outer * offsets.size() * split.inner) {
+		throw std::runtime_error("values must be single value or match the number of indexed elements");
+	}
+
+	std::shared_ptr<VArray> values_temp;
+	const VData& values_ = values_buffer(allocator, values, va::dtype(data), values_temp);
+	const std::ptrdiff_t values_stride = va::size(values_) == 1 ? 0 : 1;
+
+	std::visit([&offsets, &split, &values_, values_stride](auto& array) {
+		using VTArray = typename std::decay_t<decltype(array)>::value_type;
+
+		const auto& values_data = std::get<compute_case<VTArray*>>(values_);
+		gather::put(array.data() + array.data_offset(), offsets.data(), offsets.size(), split.outer, split.axis_size, split.inner, values_data.data() + values_data.data_offset(), values_stride);
+	}, data);
+}
+
+void va::add_at(VStoreAllocator& allocator, VData& data, const VData& indices, const VData& values) {
+	if (!va::is_contiguous(data)) {
+		const auto data_copy = va::copy(allocator, data);
+		va::add_at(allocator, data_copy->data, indices, values);
+		va::assign(data, data_copy->data);
+		return;
+	}
+
+	const auto& shape = va::shape(data);
+	if (shape.empty()) throw std::runtime_error("cannot index a 0d array");
+
+	// Indices select rows along the first axis.
+	const auto split = split_at_axis(shape, 0);
+	const auto offsets = axis_indices(allocator, indices, split.axis_size);
+
+	if (va::size(values) != 1 && va::size(values) != offsets.size() * split.inner) {
+		throw std::runtime_error("values must be single value or match the number of indexed elements");
+	}
+
+	std::shared_ptr<VArray> values_temp;
+	const VData& values_ = values_buffer(allocator, values, va::dtype(data), values_temp);
+	const std::ptrdiff_t values_stride = va::size(values_) == 1 ? 0 : 1;
+
+	std::visit([&offsets, &split, &values_, values_stride](auto& array) {
+		using VTArray = typename std::decay_t<decltype(array)>::value_type;
+
+		const auto& values_data = std::get<compute_case<VTArray*>>(values_);
+		gather::parallel_scatter_reduce(
+			array.data() + array.data_offset(),
+			split.axis_size,
+			offsets.data(),
+			offsets.size(),
+			split.inner,
+			values_data.data() + values_data.data_offset(),
+			values_stride,
+			VTArray(0),
+			[](const VTArray a, const VTArray b) -> VTArray { return a + b; }
+		);
+	}, data);
 }
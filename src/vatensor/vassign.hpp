@@ -1,7 +1,9 @@
 #ifndef NUMDOT_VASSIGN_H
 #define NUMDOT_VASSIGN_H
 
+#include <optional>                 // for optional
 #include "varray.hpp"               // for VData, VScalar, ArrayVariant, VArr...
+#include "vparallel.hpp"            // for num_chunks, run
 #include "xtensor/core/xassign.hpp"    // for assert_compatible_shape, assign_data
 #include "xtensor/core/xsemantic.hpp"  // for get_rhs_triviality
 
@@ -29,6 +31,38 @@ namespace va {
 		else va::broadcasting_assign(t, e);
 	}
 
+	// Like broadcasting_assign_typesafe, but large assignments are split along the first axis and run on the thread pool.
+	// The expression must be safe to evaluate concurrently (i.e. not draw from a random engine).
+	template<typename R, typename E>
+	inline void parallel_assign_typesafe(R& t, const E& e) {
+		// Also initializes cached shapes, which are otherwise lazily computed (racing between the threads).
+		const auto& e_shape = e.shape();
+
+		const std::size_t chunks = t.dimension() == 0 ? 1 : parallel::num_chunks(t.size(), t.shape()[0]);
+		if (chunks <= 1) {
+			va::broadcasting_assign_typesafe(t, e);
+			return;
+		}
+
+		xt::assert_compatible_shape(t, e);
+		const std::size_t rows = t.shape()[0];
+		// Otherwise, e is broadcast along the first axis and every chunk can read all of it.
+		const bool is_e_split = e_shape.size() == t.dimension() && e_shape[0] != 1;
+
+		parallel::run(chunks, [&t, &e, chunks, rows, is_e_split](const std::size_t i) {
+			const auto [begin, end] = parallel::chunk_range(i, chunks, rows);
+
+			auto t_chunk = xt::view(t, xt::range(begin, end));
+			if (is_e_split) {
+				const auto e_chunk = xt::view(e, xt::range(begin, end));
+				va::broadcasting_assign_typesafe(t_chunk, e_chunk);
+			}
+			else {
+				va::broadcasting_assign_typesafe(t_chunk, e);
+			}
+		});
+	}
+
 	void set_single_value(VData& array, axes_type& index, const VScalar& value);
 	VScalar get_single_value(const VData& array, axes_type& index);
 
@@ -36,11 +70,17 @@ namespace va {
 	void assign(const VArrayTarget& target, VScalar value);
 
 	std::shared_ptr<VArray> get_at_mask(VStoreAllocator& allocator, const VData& varray, const VData& mask);
-	void set_at_mask(VData& varray, VData& mask, VData& value);
-	void set_at_mask(VData& varray, VData& mask, VScalar value);
+	void set_at_mask(VStoreAllocator& allocator, VData& varray, const VData& mask, const VData& value);
+	void set_at_mask(VData& varray, const VData& mask, VScalar value);
 
 	std::shared_ptr<VArray> get_at_indices(VStoreAllocator& allocator, const VData& varray, const VData& indices);
-	void set_at_indices(VData& varray, VData& indices, VData& value);
+	void set_at_indices(VStoreAllocator& allocator, VData& varray, const VData& indices, const VData& value);
+
+	// Without an axis, the array is indexed as if flattened.
+	std::shared_ptr<VArray> take(VStoreAllocator& allocator, const VData& varray, const VData& indices, std::optional<std::ptrdiff_t> axis);
+	void put(VStoreAllocator& allocator, VData& varray, const VData& indices, const VData& values, std::optional<std::ptrdiff_t> axis);
+	// Adds values to the rows of varray selected by indices, in-place. Unlike put, duplicate indices accumulate.
+	void add_at(VStoreAllocator& allocator, VData& varray, const VData& indices, const VData& values);
 }
 
 #endif //NUMDOT_VASSIGN_H
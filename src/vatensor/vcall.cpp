@@ -41,6 +41,23 @@ VData& va::evaluate_target(VStoreAllocator& allocator, const VArrayTarget& targe
 	}
 }
 
+VData& va::evaluate_exact_target(VStoreAllocator& allocator, const VArrayTarget& target, DType dtype, const shape_type& result_shape, std::shared_ptr<VArray>& temp) {
+	if (const auto target_data = std::get_if<VData*>(&target)) {
+		VData& data = **target_data;
+		if (va::dtype(data) == dtype && va::shape(data) == result_shape) {
+			return data;
+		}
+		if (!xt::broadcastable(result_shape, va::shape(data))) {
+			throw std::runtime_error("Incompatible shape of tensor destination");
+		}
+
+		temp = va::empty(allocator, dtype, result_shape);
+		return temp->data;
+	}
+
+	return evaluate_target(allocator, target, dtype, result_shape, temp);
+}
+
 void va::shape_reduce_axes(va::shape_type& shape, const va::axes_type& axes) {
 	// Assumes shape.size() is available and is of a reasonable size
 	auto mask = static_cast<bool*>(alloca(shape.size() * sizeof(bool)));
@@ -1,9 +1,12 @@
 #ifndef VCALL_HPP
 #define VCALL_HPP
 
+#include <optional>                        // for optional
+
 #include "create.hpp"
 #include "varray.hpp"
 #include "vassign.hpp"
+#include "vcarray.hpp"
 #include "vfunc/tables.hpp"
 
 namespace va {
@@ -14,6 +17,13 @@ namespace va {
 		using UnaryDummyFunction = void (*)(void* a, const void* b, Args... args);
 		template<typename... Args>
 		using BinaryDummyFunction = void (*)(void* a, const void* b, const void* c, Args... args);
+		template<typename... Args>
+		using TernaryDummyFunction = void (*)(void* a, const void* b, const void* c, const void* d, Args... args);
+		using UnaryFlatFunction = void (*)(void* ret, std::size_t size, const void* a);
+		using BinaryFlatFunction = void (*)(void* ret, std::size_t size, const void* a, const void* b);
+		using TernaryFlatFunction = void (*)(void* ret, std::size_t size, const void* a, const void* b, const void* c);
+		using Unary2DummyFunction = void (*)(void* ret0, void* ret1, const void* a);
+		using Binary2DummyFunction = void (*)(void* ret0, void* ret1, const void* a, const void* b);
 
 		inline std::shared_ptr<VArray> _copy_as_dtype(VStoreAllocator& allocator, const VData& a, DType dtype) {
 			return va::copy_as_dtype(allocator, a, dtype);
@@ -40,12 +50,93 @@ namespace va {
 		const void* get_value_ptr(const std::variant<Args...>& variant) {
 			return std::visit([](auto& arg) -> const void* { return &arg; }, variant);
 		}
+
+		inline void* data_ptr(VData& a) {
+			return std::visit([](auto& carray) -> void* { return carray.data() + carray.data_offset(); }, a);
+		}
+
+		inline const void* data_ptr(const VData& a) {
+			return std::visit([](const auto& carray) -> const void* { return carray.data() + carray.data_offset(); }, a);
+		}
+
+		inline const void* data_ptr(const VScalar& a) {
+			return get_value_ptr(a);
+		}
+
+		// 0-d view onto a scalar's storage, so full reductions can write straight to the stack.
+		inline VData adapt_scalar(VScalar& a) {
+			return std::visit([](auto& value) -> VData { return va::util::adapt_scalar(&value); }, a);
+		}
+
+		inline bool is_flat_compatible(const VData& a, const shape_type& shape) {
+			return va::shape(a) == shape && va::is_contiguous(a);
+		}
+
+		inline bool is_flat_compatible(const VScalar& a, const shape_type& shape) {
+			return true;
+		}
+
+		// Returns the target if the flat function can write to it directly, allocating it if needed.
+		// Otherwise, returns nullptr.
+		inline VData* flat_target(VStoreAllocator& allocator, const VArrayTarget& target, const DType dtype, const shape_type& shape) {
+			if (const auto target_data = std::get_if<VData*>(&target)) {
+				VData& data = **target_data;
+				if (va::dtype(data) != dtype || va::shape(data) != shape || !va::is_contiguous(data)) return nullptr;
+				return &data;
+			}
+
+			auto& target_varray = *std::get<std::shared_ptr<VArray>*>(target);
+			target_varray = va::empty(allocator, dtype, shape);
+			return &target_varray->data;
+		}
+
+		// Fast path for the common case of contiguous inputs of the same shape that need no casts.
+		// Skips broadcasting, and runs the function as a 1-D loop over raw memory.
+		// Returns false if the inputs are not eligible.
+		template<typename A, typename B>
+		bool try_call_vfunc_flat(VStoreAllocator& allocator, const vfunc::VFunc<2>& ufunc, const VArrayTarget& target, const shape_type& result_shape, const A& a, const B& b) {
+			if (ufunc.flat_function_ptr == nullptr) return false;
+			if (va::dtype(a) != ufunc.input_types[0] || va::dtype(b) != ufunc.input_types[1]) return false;
+			if (!is_flat_compatible(a, result_shape) || !is_flat_compatible(b, result_shape)) return false;
+
+			VData* target_ = flat_target(allocator, target, ufunc.output_dtype, result_shape);
+			if (target_ == nullptr) return false;
+
+			reinterpret_cast<BinaryFlatFunction>(ufunc.flat_function_ptr)(data_ptr(*target_), va::size(*target_), data_ptr(a), data_ptr(b));
+			return true;
+		}
+
+		template<typename A, typename B, typename C>
+		bool try_call_vfunc_flat(VStoreAllocator& allocator, const vfunc::VFunc<3>& ufunc, const VArrayTarget& target, const shape_type& result_shape, const A& a, const B& b, const C& c) {
+			if (ufunc.flat_function_ptr == nullptr) return false;
+			if (va::dtype(a) != ufunc.input_types[0] || va::dtype(b) != ufunc.input_types[1] || va::dtype(c) != ufunc.input_types[2]) return false;
+			if (!is_flat_compatible(a, result_shape) || !is_flat_compatible(b, result_shape) || !is_flat_compatible(c, result_shape)) return false;
+
+			VData* target_ = flat_target(allocator, target, ufunc.output_dtype, result_shape);
+			if (target_ == nullptr) return false;
+
+			reinterpret_cast<TernaryFlatFunction>(ufunc.flat_function_ptr)(data_ptr(*target_), va::size(*target_), data_ptr(a), data_ptr(b), data_ptr(c));
+			return true;
+		}
+
+		inline bool try_call_vfunc_flat(VStoreAllocator& allocator, const vfunc::VFunc<1>& ufunc, const VArrayTarget& target, const shape_type& result_shape, const VData& a) {
+			if (ufunc.flat_function_ptr == nullptr) return false;
+			if (va::dtype(a) != ufunc.input_types[0] || !is_flat_compatible(a, result_shape)) return false;
+
+			VData* target_ = flat_target(allocator, target, ufunc.output_dtype, result_shape);
+			if (target_ == nullptr) return false;
+
+			reinterpret_cast<UnaryFlatFunction>(ufunc.flat_function_ptr)(data_ptr(*target_), va::size(*target_), data_ptr(a));
+			return true;
+		}
 	}
 
 	void fill(VData& a, const VScalar& fill_value);
 	void assign(VData& a, const VData& b);
 
 	VData& evaluate_target(VStoreAllocator& allocator, const VArrayTarget& target, DType dtype, const shape_type& result_shape, std::shared_ptr<VArray>& temp);
+	// Like evaluate_target, but the result has exactly result_shape, so that all outputs of a function have the same shape.
+	VData& evaluate_exact_target(VStoreAllocator& allocator, const VArrayTarget& target, DType dtype, const shape_type& result_shape, std::shared_ptr<VArray>& temp);
 
 	template<typename... Args>
 	void _call_vfunc_inplace(const vfunc::tables::UFuncTableInplace& table, VData& a, Args&&... args) {
@@ -82,6 +173,10 @@ namespace va {
 		const auto& ufunc = table[a_type];
 		if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
 
+		if constexpr (sizeof...(Args) == 0) {
+			if (_call::try_call_vfunc_flat(allocator, ufunc, target, result_shape, a)) return;
+		}
+
 		std::shared_ptr<VArray> temp(nullptr);
 		auto& target_ = evaluate_target(allocator, target, ufunc.output_dtype, result_shape, temp);
 
@@ -128,6 +223,36 @@ namespace va {
 		}
 	}
 
+	// Full reduction into a stack scalar of the table's output dtype.
+	// Unlike call_rfunc_unary, no target is evaluated and nothing is allocated unless the input needs a cast.
+	inline VScalar call_rfunc_unary_scalar(VStoreAllocator& allocator, const vfunc::tables::UFuncTableUnary& table, const VData& a) {
+		const DType a_type = va::dtype(a);
+
+		const auto& ufunc = table[a_type];
+		if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
+
+		VScalar result = dtype_to_variant_unchecked(ufunc.output_dtype);
+		VData target = _call::adapt_scalar(result);
+
+		if (a_type == ufunc.input_types[0]) {
+			reinterpret_cast<_call::UnaryDummyFunction<const axes_type*>>(ufunc.function_ptr)(
+				_call::get_value_ptr(target),
+				_call::get_value_ptr(a),
+				nullptr
+			);
+		}
+		else {
+			const auto a_ = _call::_copy_as_dtype(allocator, a, ufunc.input_types[0]);
+			reinterpret_cast<_call::UnaryDummyFunction<const axes_type*>>(ufunc.function_ptr)(
+				_call::get_value_ptr(target),
+				_call::get_value_ptr(a_->data),
+				nullptr
+			);
+		}
+
+		return result;
+	}
+
 	template<typename A, typename B, typename... Args>
 	void _call_vfunc_binary(VStoreAllocator& allocator, const vfunc::tables::UFuncTableBinary& table, const VArrayTarget& target, const shape_type& result_shape, const A& a, const B& b, Args&&... args) {
 		const DType a_type = va::dtype(a);
@@ -136,6 +261,10 @@ namespace va {
 		const auto& ufunc = table[a_type][b_type];
 		if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
 
+		if constexpr (sizeof...(Args) == 0) {
+			if (_call::try_call_vfunc_flat(allocator, ufunc, target, result_shape, a, b)) return;
+		}
+
 		std::shared_ptr<VArray> temp(nullptr);
 		auto& target_ = evaluate_target(allocator, target, ufunc.output_dtype, result_shape, temp);
 
@@ -206,6 +335,11 @@ namespace va {
 
 	template <typename... Args>
 	inline void call_vfunc_binary(va::VStoreAllocator& allocator, const va::vfunc::tables::UFuncTablesBinaryCommutative& table, const va::VArrayTarget& target, const va::VData& a, const va::VData& b, Args... args) {
+		if constexpr (sizeof...(Args) == 0) {
+			// Checked before combined_shape, which is a measurable part of small calls.
+			if (va::dimension(a) > 0 && va::shape(a) == va::shape(b) && _call::try_call_vfunc_flat(allocator, table.tensors[va::dtype(a)][va::dtype(b)], target, va::shape(a), a, b)) return;
+		}
+
 		const shape_type result_shape = combined_shape(va::shape(a), va::shape(b));
 
 		if (va::dimension(a) == 0) return _call_vfunc_binary(allocator, table.scalar_right, target, result_shape, b, va::to_single_value(a), std::forward<Args>(args)...);
@@ -216,6 +350,11 @@ namespace va {
 
 	template <typename... Args>
 	inline void call_vfunc_binary(va::VStoreAllocator& allocator, const va::vfunc::tables::UFuncTablesBinary& table, const va::VArrayTarget& target, const va::VData& a, const va::VData& b, Args... args) {
+		if constexpr (sizeof...(Args) == 0) {
+			// Checked before combined_shape, which is a measurable part of small calls.
+			if (va::dimension(a) > 0 && va::shape(a) == va::shape(b) && _call::try_call_vfunc_flat(allocator, table.tensors[va::dtype(a)][va::dtype(b)], target, va::shape(a), a, b)) return;
+		}
+
 		const shape_type result_shape = combined_shape(va::shape(a), va::shape(b));
 
 		if (va::dimension(a) == 0) return _call_vfunc_binary(allocator, table.scalar_left, target, result_shape, va::to_single_value(a), b, std::forward<Args>(args)...);
@@ -224,6 +363,98 @@ namespace va {
 		_call_vfunc_binary(allocator, table.tensors, target, result_shape, a, b, std::forward<Args>(args)...);
 	}
 
+	// Functions with two outputs write both in one pass. Inputs are broadcast by the function itself.
+	inline void call_vfunc_unary2(VStoreAllocator& allocator, const vfunc::tables::UFuncTableUnary2& table, const VArrayTarget& target0, const VArrayTarget& target1, const VData& a) {
+		const auto& ufunc = table[va::dtype(a)];
+		if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
+
+		std::shared_ptr<VArray> a_;
+		if (va::dtype(a) != ufunc.input_types[0]) a_ = _call::_copy_as_dtype(allocator, a, ufunc.input_types[0]);
+
+		std::shared_ptr<VArray> temp0, temp1;
+		auto& target0_ = evaluate_exact_target(allocator, target0, ufunc.output_dtypes[0], va::shape(a), temp0);
+		auto& target1_ = evaluate_exact_target(allocator, target1, ufunc.output_dtypes[1], va::shape(a), temp1);
+
+		reinterpret_cast<_call::Unary2DummyFunction>(ufunc.function_ptr)(
+			_call::get_value_ptr(target0_),
+			_call::get_value_ptr(target1_),
+			_call::get_value_ptr(a_ ? a_->data : a)
+		);
+
+		// We wrote to temps because the targets mismatched; now we need to resolve that.
+		if (temp0 != nullptr) va::assign(*std::get<VData*>(target0), temp0->data);
+		if (temp1 != nullptr) va::assign(*std::get<VData*>(target1), temp1->data);
+	}
+
+	inline void call_vfunc_binary2(VStoreAllocator& allocator, const vfunc::tables::UFuncTableBinary2& table, const VArrayTarget& target0, const VArrayTarget& target1, const VData& a, const VData& b) {
+		const auto& ufunc = table[va::dtype(a)][va::dtype(b)];
+		if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
+
+		std::shared_ptr<VArray> a_, b_;
+		if (va::dtype(a) != ufunc.input_types[0]) a_ = _call::_copy_as_dtype(allocator, a, ufunc.input_types[0]);
+		if (va::dtype(b) != ufunc.input_types[1]) b_ = _call::_copy_as_dtype(allocator, b, ufunc.input_types[1]);
+
+		const shape_type result_shape = combined_shape(va::shape(a), va::shape(b));
+		std::shared_ptr<VArray> temp0, temp1;
+		auto& target0_ = evaluate_exact_target(allocator, target0, ufunc.output_dtypes[0], result_shape, temp0);
+		auto& target1_ = evaluate_exact_target(allocator, target1, ufunc.output_dtypes[1], result_shape, temp1);
+
+		reinterpret_cast<_call::Binary2DummyFunction>(ufunc.function_ptr)(
+			_call::get_value_ptr(target0_),
+			_call::get_value_ptr(target1_),
+			_call::get_value_ptr(a_ ? a_->data : a),
+			_call::get_value_ptr(b_ ? b_->data : b)
+		);
+
+		if (temp0 != nullptr) va::assign(*std::get<VData*>(target0), temp0->data);
+		if (temp1 != nullptr) va::assign(*std::get<VData*>(target1), temp1->data);
+	}
+
+	template<typename B, typename C, typename... Args>
+	void _call_vfunc_ternary(VStoreAllocator& allocator, const vfunc::tables::UFuncTableTernary& table, const VArrayTarget& target, const shape_type& result_shape, const VData& a, const B& b, const C& c, Args&&... args) {
+		const auto& ufunc = table[va::dtype(a)][va::dtype(b)][va::dtype(c)];
+		if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
+
+		if constexpr (sizeof...(Args) == 0) {
+			if (_call::try_call_vfunc_flat(allocator, ufunc, target, result_shape, a, b, c)) return;
+		}
+
+		std::shared_ptr<VArray> temp(nullptr);
+		auto& target_ = evaluate_target(allocator, target, ufunc.output_dtype, result_shape, temp);
+
+		// Arguments that don't match the function's input types are cast first.
+		// The casts are only kept alive until the call is done.
+		std::optional<decltype(_call::_copy_as_dtype(allocator, a, DType {}))> a_;
+		std::optional<decltype(_call::_copy_as_dtype(allocator, b, DType {}))> b_;
+		std::optional<decltype(_call::_copy_as_dtype(allocator, c, DType {}))> c_;
+		if (va::dtype(a) != ufunc.input_types[0]) a_ = _call::_copy_as_dtype(allocator, a, ufunc.input_types[0]);
+		if (va::dtype(b) != ufunc.input_types[1]) b_ = _call::_copy_as_dtype(allocator, b, ufunc.input_types[1]);
+		if (va::dtype(c) != ufunc.input_types[2]) c_ = _call::_copy_as_dtype(allocator, c, ufunc.input_types[2]);
+
+		reinterpret_cast<_call::TernaryDummyFunction<Args...>>(ufunc.function_ptr)(
+			_call::get_value_ptr(target_),
+			a_ ? _call::get_value_ptr(_call::deref(*a_)) : _call::get_value_ptr(a),
+			b_ ? _call::get_value_ptr(_call::deref(*b_)) : _call::get_value_ptr(b),
+			c_ ? _call::get_value_ptr(_call::deref(*c_)) : _call::get_value_ptr(c),
+			std::forward<Args>(args)...
+		);
+
+		if (temp != nullptr) {
+			// We wrote to temp because the return type mismatched; now we need to resolve that.
+			va::assign(*std::get<VData*>(target), temp->data);
+		}
+	}
+
+	template<typename... Args>
+	void call_vfunc_ternary(VStoreAllocator& allocator, const vfunc::tables::UFuncTablesTernary& table, const VArrayTarget& target, const VData& a, const VData& b, const VData& c, Args&&... args) {
+		if (va::dimension(b) == 0 && va::dimension(c) == 0) {
+			return _call_vfunc_ternary(allocator, table.scalar_right, target, va::shape(a), a, va::to_single_value(b), va::to_single_value(c), std::forward<Args>(args)...);
+		}
+
+		const shape_type result_shape = combined_shape(combined_shape(va::shape(a), va::shape(b)), va::shape(c));
+		_call_vfunc_ternary(allocator, table.tensors, target, result_shape, a, b, c, std::forward<Args>(args)...);
+	}
+
 	template<typename... Args>
 	void call_rfunc_binary(VStoreAllocator& allocator, const vfunc::tables::UFuncTablesBinaryCommutative& table, const VArrayTarget& target, const VData& a, const VData& b, Args&&... args) {
 		if (va::dimension(a) == 0) return _call_vfunc_binary(allocator, table.scalar_right, target, va::shape_type(), b, va::to_single_value(a), std::forward<Args>(args)...);
@@ -244,6 +475,31 @@ namespace va {
 			_call_vfunc_binary(allocator, table, target, va::shape_type(), a, b, nullptr, std::forward<Args>(args)...);
 		}
 	}
+
+	// Binary counterpart of call_rfunc_unary_scalar.
+	inline VScalar call_rfunc_binary_scalar(VStoreAllocator& allocator, const vfunc::tables::UFuncTableBinary& table, const VData& a, const VData& b) {
+		const DType a_type = va::dtype(a);
+		const DType b_type = va::dtype(b);
+
+		const auto& ufunc = table[a_type][b_type];
+		if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
+
+		VScalar result = dtype_to_variant_unchecked(ufunc.output_dtype);
+		VData target = _call::adapt_scalar(result);
+
+		std::shared_ptr<VArray> a_, b_;
+		if (a_type != ufunc.input_types[0]) a_ = _call::_copy_as_dtype(allocator, a, ufunc.input_types[0]);
+		if (b_type != ufunc.input_types[1]) b_ = _call::_copy_as_dtype(allocator, b, ufunc.input_types[1]);
+
+		reinterpret_cast<_call::BinaryDummyFunction<const axes_type*>>(ufunc.function_ptr)(
+			_call::get_value_ptr(target),
+			_call::get_value_ptr(a_ ? a_->data : a),
+			_call::get_value_ptr(b_ ? b_->data : b),
+			nullptr
+		);
+
+		return result;
+	}
 }
 
 #endif //VCALL_HPP
@@ -0,0 +1,196 @@
+#include "vexpr.hpp"
+
+#include <algorithm>                       // for max, min
+#include <functional>                      // for multiplies
+#include <numeric>                         // for accumulate
+#include <optional>                        // for optional
+#include <unordered_map>                   // for unordered_map
+
+#include "create.hpp"
+#include "vcall.hpp"
+#include "xtensor/views/xstrided_view.hpp"  // for range
+
+using namespace va;
+
+// Number of elements processed per block.
+// Small enough that all intermediate blocks of a typical expression stay in cache.
+static constexpr std::size_t block_size = 1 << 14;
+
+expr::NodePtr expr::leaf(const std::shared_ptr<VArray>& array) {
+	return std::make_shared<Node>(Node { array, {}, array->shape(), array->dtype() });
+}
+
+expr::NodePtr expr::unary(const vfunc::tables::UFuncTableUnary& table, const NodePtr& a) {
+	const auto& ufunc = table[a->dtype];
+	if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
+
+	return std::make_shared<Node>(Node { &table, { a }, a->shape, ufunc.output_dtype });
+}
+
+template <typename Table>
+expr::NodePtr binary_(const Table& table, const expr::NodePtr& a, const expr::NodePtr& b) {
+	const auto& ufunc = table.tensors[a->dtype][b->dtype];
+	if (ufunc.function_ptr == nullptr) throw std::runtime_error("Unsupported dtype for ufunc.");
+
+	return std::make_shared<expr::Node>(expr::Node {
+		expr::BinaryOp { &table },
+		{ a, b },
+		combined_shape(a->shape, b->shape),
+		ufunc.output_dtype
+	});
+}
+
+expr::NodePtr expr::binary(const vfunc::tables::UFuncTablesBinary& table, const NodePtr& a, const NodePtr& b) {
+	return binary_(table, a, b);
+}
+
+expr::NodePtr expr::binary(const vfunc::tables::UFuncTablesBinaryCommutative& table, const NodePtr& a, const NodePtr& b) {
+	return binary_(table, a, b);
+}
+
+namespace {
+	class BlockEvaluator {
+		struct State {
+			// If false, the node's result is the same for each block.
+			bool is_blocked = false;
+			bool is_evaluated = false;
+			std::shared_ptr<VArray> buffer;
+			std::optional<VData> view;
+		};
+
+		VStoreAllocator& allocator;
+		std::unordered_map<const expr::Node*, State> states;
+
+		std::size_t dimension;
+		std::size_t rows;
+		std::size_t rows_per_block;
+		std::size_t block_begin = 0;
+		std::size_t block_end = 0;
+
+		bool prepare(const expr::Node& node) {
+			if (const auto it = states.find(&node); it != states.end()) return it->second.is_blocked;
+
+			bool is_blocked = false;
+			if (std::holds_alternative<std::shared_ptr<VArray>>(node.op)) {
+				is_blocked = rows_per_block < rows && node.shape.size() == dimension && node.shape[0] == rows;
+			}
+			for (const auto& input : node.inputs) {
+				// Avoid short-circuiting; each input needs to be prepared.
+				is_blocked = prepare(*input) || is_blocked;
+			}
+
+			states[&node].is_blocked = is_blocked;
+			return is_blocked;
+		}
+
+		void apply(const expr::Node& node, const VArrayTarget& target) {
+			if (const auto unary = std::get_if<expr::UnaryOp>(&node.op)) {
+				va::call_vfunc_unary(allocator, **unary, target, visit(*node.inputs[0]));
+				return;
+			}
+
+			const auto& a = visit(*node.inputs[0]);
+			const auto& b = visit(*node.inputs[1]);
+			std::visit([this, &target, &a, &b](const auto* table) {
+				va::call_vfunc_binary(allocator, *table, target, a, b);
+			}, std::get<expr::BinaryOp>(node.op));
+		}
+
+		const VData& visit(const expr::Node& node) {
+			State& state = states[&node];
+			if (state.is_evaluated) return *state.view;
+
+			if (const auto leaf = std::get_if<std::shared_ptr<VArray>>(&node.op)) {
+				state.view = state.is_blocked ? block_of((*leaf)->data) : (*leaf)->data;
+			}
+			else if (!state.is_blocked) {
+				apply(node, &state.buffer);
+				state.view = state.buffer->data;
+			}
+			else {
+				if (!state.buffer) {
+					shape_type block_shape = node.shape;
+					block_shape[0] = rows_per_block;
+					state.buffer = va::empty(allocator, node.dtype, block_shape);
+				}
+				// The last block may be smaller than the others.
+				state.view = block_end - block_begin == rows_per_block
+					? state.buffer->data
+					: va::sliced_data(state.buffer->data, xt::range(std::ptrdiff_t { 0 }, static_cast<std::ptrdiff_t>(block_end - block_begin)), 0);
+				apply(node, &*state.view);
+			}
+
+			state.is_evaluated = true;
+			return *state.view;
+		}
+
+		VData block_of(const VData& data) const {
+			return va::sliced_data(data, xt::range(static_cast<std::ptrdiff_t>(block_begin), static_cast<std::ptrdiff_t>(block_end)), 0);
+		}
+
+	public:
+		BlockEvaluator(VStoreAllocator& allocator, const shape_type& shape) : allocator(allocator), dimension(shape.size()) {
+			rows = dimension == 0 ? 1 : shape[0];
+			const auto size = std::accumulate(shape.begin(), shape.end(), static_cast<std::size_t>(1), std::multiplies());
+			const auto row_size = rows == 0 ? 1 : std::max(size / rows, static_cast<std::size_t>(1));
+			rows_per_block = std::max(block_size / row_size, static_cast<std::size_t>(1));
+		}
+
+		void run(const expr::Node& root, VData& out) {
+			prepare(root);
+
+			if (!states[&root].is_blocked) {
+				block_end = rows;
+				apply(root, &out);
+				return;
+			}
+
+			for (block_begin = 0; block_begin < rows; block_begin = block_end) {
+				block_end = std::min(block_begin + rows_per_block, rows);
+
+				for (auto& [node, state] : states) {
+					if (state.is_blocked) state.is_evaluated = false;
+				}
+
+				VData out_block = block_of(out);
+				apply(root, &out_block);
+			}
+		}
+	};
+}
+
+void expr::evaluate(VStoreAllocator& allocator, const VArrayTarget& target, const NodePtr& root) {
+	if (const auto leaf = std::get_if<std::shared_ptr<VArray>>(&root->op)) {
+		// Nothing to fuse.
+		va::assign(allocator, target, (*leaf)->data);
+		return;
+	}
+
+	std::shared_ptr<VArray> temp;
+	VData* out;
+	if (const auto target_data = std::get_if<VData*>(&target)) {
+		if (!xt::broadcastable(root->shape, va::shape(**target_data))) {
+			throw std::runtime_error("Incompatible shape of tensor destination");
+		}
+
+		if (va::dtype(**target_data) == root->dtype && va::shape(**target_data) == root->shape) {
+			out = *target_data;
+		}
+		else {
+			// Blocks don't map onto the target; evaluate separately, then broadcast / cast.
+			temp = va::empty(allocator, root->dtype, root->shape);
+			out = &temp->data;
+		}
+	}
+	else {
+		auto& target_varray = *std::get<std::shared_ptr<VArray>*>(target);
+		target_varray = va::empty(allocator, root->dtype, root->shape);
+		out = &target_varray->data;
+	}
+
+	BlockEvaluator(allocator, root->shape).run(*root, *out);
+
+	if (temp != nullptr) {
+		va::assign(*std::get<VData*>(target), temp->data);
+	}
+}
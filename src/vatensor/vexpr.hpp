@@ -0,0 +1,40 @@
+#ifndef VATENSOR_VEXPR_HPP
+#define VATENSOR_VEXPR_HPP
+
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "varray.hpp"
+#include "vfunc/tables.hpp"
+
+namespace va::expr {
+	// Deferred element-wise expression graph.
+	// Nodes are immutable; a node may be shared by multiple parents, in which case it is evaluated only once.
+	struct Node;
+	using NodePtr = std::shared_ptr<const Node>;
+
+	using UnaryOp = const vfunc::tables::UFuncTableUnary*;
+	using BinaryOp = std::variant<const vfunc::tables::UFuncTablesBinary*, const vfunc::tables::UFuncTablesBinaryCommutative*>;
+
+	struct Node {
+		// Either a materialized input (leaf), or a vfunc applied to the inputs.
+		std::variant<std::shared_ptr<VArray>, UnaryOp, BinaryOp> op;
+		std::vector<NodePtr> inputs;
+		// Known when the graph is built, so the output can be allocated before evaluation.
+		shape_type shape;
+		DType dtype;
+	};
+
+	NodePtr leaf(const std::shared_ptr<VArray>& array);
+	NodePtr unary(const vfunc::tables::UFuncTableUnary& table, const NodePtr& a);
+	NodePtr binary(const vfunc::tables::UFuncTablesBinary& table, const NodePtr& a, const NodePtr& b);
+	NodePtr binary(const vfunc::tables::UFuncTablesBinaryCommutative& table, const NodePtr& a, const NodePtr& b);
+
+	// Evaluates the graph in cache-sized blocks along the first axis.
+	// Intermediate results only ever occupy one block, and sub-expressions that don't depend on the blocked
+	// axis are evaluated only once.
+	void evaluate(VStoreAllocator& allocator, const VArrayTarget& target, const NodePtr& root);
+}
+
+#endif //VATENSOR_VEXPR_HPP
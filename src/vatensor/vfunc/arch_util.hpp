@@ -1,12 +1,35 @@
 #ifndef VATENSOR_ARCH_UTIL_HPP
 #define VATENSOR_ARCH_UTIL_HPP
 
+#include <array>                            // for array
+#include <type_traits>                      // for is_pointer_v
+
+#include "xtensor/containers/xadapt.hpp"   // for adapt
+
+namespace va::vfunc::flat {
+	// Array arguments are passed as pointers, and adapted as 1-D arrays. Scalars are passed through.
+	template <typename T>
+	auto adapt(T arg, const std::size_t size) {
+		if constexpr (std::is_pointer_v<T>) {
+			return xt::adapt(arg, size, xt::no_ownership(), std::array<std::size_t, 1> { size });
+		}
+		else {
+			return arg;
+		}
+	}
+}
+
 #define DECLARE_VFUNC(UFUNC_NAME)\
 struct UFUNC_NAME {\
 	template <typename RETURN_TYPE, typename... ARGS>\
 	static void run(va::compute_case<RETURN_TYPE*>& ret, ARGS... args) {\
 		va::vfunc::impl::UFUNC_NAME(ret, std::forward<ARGS>(args)...);\
 	}\
+	template <typename RETURN_TYPE, typename... ARGS>\
+	static void run_flat(RETURN_TYPE* ret, const std::size_t size, ARGS... args) {\
+		auto ret_flat = va::vfunc::flat::adapt(ret, size);\
+		va::vfunc::impl::UFUNC_NAME(ret_flat, va::vfunc::flat::adapt<ARGS>(args, size)...);\
+	}\
 }
 
 template <typename C, typename RETURN_TYPE, typename... ARGS>
@@ -32,6 +55,10 @@ void add_native(va::vfunc::tables::UFuncTableUnary& table) {
 		out,
 		(void *)&C::template run<RETURN_TYPE, const va::compute_case<IN0*>&, ARGS...>
 	};
+	// Functions with extra arguments (e.g. reductions) are not element-wise.
+	if constexpr (sizeof...(ARGS) == 0) {
+		table[in0].flat_function_ptr = (void *)&C::template run_flat<RETURN_TYPE, const IN0*>;
+	}
 }
 
 template <typename C, typename RETURN_TYPE, typename IN0, typename IN1, typename... ARGS>
@@ -55,6 +82,11 @@ void add_native(va::vfunc::tables::UFuncTablesBinary& tables) {
 		out,
 		(void *)&C::template run<RETURN_TYPE, const va::compute_case<IN0*>&, const IN1&, ARGS...>
 	};
+	if constexpr (sizeof...(ARGS) == 0) {
+		tables.tensors[in0][in1].flat_function_ptr = (void *)&C::template run_flat<RETURN_TYPE, const IN0*, const IN1*>;
+		tables.scalar_left[in0][in1].flat_function_ptr = (void *)&C::template run_flat<RETURN_TYPE, const IN0&, const IN1*>;
+		tables.scalar_right[in0][in1].flat_function_ptr = (void *)&C::template run_flat<RETURN_TYPE, const IN0*, const IN1&>;
+	}
 }
 
 template <typename C, typename RETURN_TYPE, typename IN0, typename IN1, typename... ARGS>
@@ -73,6 +105,33 @@ void add_native(va::vfunc::tables::UFuncTablesBinaryCommutative& tables) {
 		out,
 		(void *)&C::template run<RETURN_TYPE, const va::compute_case<IN0*>&, const IN1&, ARGS...>
 	};
+	if constexpr (sizeof...(ARGS) == 0) {
+		tables.tensors[in0][in1].flat_function_ptr = (void *)&C::template run_flat<RETURN_TYPE, const IN0*, const IN1*>;
+		tables.scalar_right[in0][in1].flat_function_ptr = (void *)&C::template run_flat<RETURN_TYPE, const IN0*, const IN1&>;
+	}
+}
+
+template <typename C, typename RETURN_TYPE, typename IN0, typename IN1, typename IN2, typename... ARGS>
+void add_native(va::vfunc::tables::UFuncTablesTernary& tables) {
+	const auto in0 = va::dtype_of_type<IN0>();
+	const auto in1 = va::dtype_of_type<IN1>();
+	const auto in2 = va::dtype_of_type<IN2>();
+	const auto out = va::dtype_of_type<RETURN_TYPE>();
+
+	tables.tensors[in0][in1][in2] = va::vfunc::VFunc<3> {
+		{ in0, in1, in2 },
+		out,
+		(void *)&C::template run<RETURN_TYPE, const va::compute_case<IN0*>&, const va::compute_case<IN1*>&, const va::compute_case<IN2*>&, ARGS...>
+	};
+	tables.scalar_right[in0][in1][in2] = va::vfunc::VFunc<3> {
+		{ in0, in1, in2 },
+		out,
+		(void *)&C::template run<RETURN_TYPE, const va::compute_case<IN0*>&, const IN1&, const IN2&, ARGS...>
+	};
+	if constexpr (sizeof...(ARGS) == 0) {
+		tables.tensors[in0][in1][in2].flat_function_ptr = (void *)&C::template run_flat<RETURN_TYPE, const IN0*, const IN1*, const IN2*>;
+		tables.scalar_right[in0][in1][in2].flat_function_ptr = (void *)&C::template run_flat<RETURN_TYPE, const IN0*, const IN1&, const IN2&>;
+	}
 }
 
 template <typename C, typename RETURN_TYPE, typename IN0, typename IN1, typename... ARGS>
@@ -88,6 +147,30 @@ void add_native(va::vfunc::tables::UFuncTableBinary& table) {
 	};
 }
 
+// Functions with two outputs take the second output's array as their first argument.
+template <typename C, typename RETURN_TYPE0, typename RETURN_TYPE1, typename IN0>
+void add_native(va::vfunc::tables::UFuncTableUnary2& table) {
+	const auto in0 = va::dtype_of_type<IN0>();
+
+	table[in0] = va::vfunc::VFunc2<1> {
+		{ in0 },
+		{ va::dtype_of_type<RETURN_TYPE0>(), va::dtype_of_type<RETURN_TYPE1>() },
+		(void *)&C::template run<RETURN_TYPE0, va::compute_case<RETURN_TYPE1*>&, const va::compute_case<IN0*>&>
+	};
+}
+
+template <typename C, typename RETURN_TYPE0, typename RETURN_TYPE1, typename IN0, typename IN1>
+void add_native(va::vfunc::tables::UFuncTableBinary2& table) {
+	const auto in0 = va::dtype_of_type<IN0>();
+	const auto in1 = va::dtype_of_type<IN1>();
+
+	table[in0][in1] = va::vfunc::VFunc2<2> {
+		{ in0, in1 },
+		{ va::dtype_of_type<RETURN_TYPE0>(), va::dtype_of_type<RETURN_TYPE1>() },
+		(void *)&C::template run<RETURN_TYPE0, va::compute_case<RETURN_TYPE1*>&, const va::compute_case<IN0*>&, const va::compute_case<IN1*>&>
+	};
+}
+
 template <typename IN0, typename MODEL_IN0>
 void add_cast(va::vfunc::tables::UFuncTableUnary& table) {
 	const auto in0 = va::dtype_of_type<IN0>();
@@ -118,6 +201,19 @@ void add_cast(va::vfunc::tables::UFuncTablesBinaryCommutative& tables) {
 	tables.scalar_right[in0][in1] = tables.scalar_right[model_in0][model_in1];
 }
 
+template <typename IN0, typename IN1, typename IN2, typename MODEL_IN0, typename MODEL_IN1, typename MODEL_IN2>
+void add_cast(va::vfunc::tables::UFuncTablesTernary& tables) {
+	const auto in0 = va::dtype_of_type<IN0>();
+	const auto in1 = va::dtype_of_type<IN1>();
+	const auto in2 = va::dtype_of_type<IN2>();
+	const auto model_in0 = va::dtype_of_type<MODEL_IN0>();
+	const auto model_in1 = va::dtype_of_type<MODEL_IN1>();
+	const auto model_in2 = va::dtype_of_type<MODEL_IN2>();
+
+	tables.tensors[in0][in1][in2] = tables.tensors[model_in0][model_in1][model_in2];
+	tables.scalar_right[in0][in1][in2] = tables.scalar_right[model_in0][model_in1][model_in2];
+}
+
 template <typename IN0, typename IN1, typename MODEL_IN0, typename MODEL_IN1>
 void add_cast(va::vfunc::tables::UFuncTableBinary& table) {
 	const auto in0 = va::dtype_of_type<IN0>();
@@ -128,4 +224,21 @@ void add_cast(va::vfunc::tables::UFuncTableBinary& table) {
 	table[in0][in1] = table[model_in0][model_in1];
 }
 
+template <typename IN0, typename MODEL_IN0>
+void add_cast(va::vfunc::tables::UFuncTableUnary2& table) {
+	const auto in0 = va::dtype_of_type<IN0>();
+	const auto model_in0 = va::dtype_of_type<MODEL_IN0>();
+	table[in0] = table[model_in0];
+}
+
+template <typename IN0, typename IN1, typename MODEL_IN0, typename MODEL_IN1>
+void add_cast(va::vfunc::tables::UFuncTableBinary2& table) {
+	const auto in0 = va::dtype_of_type<IN0>();
+	const auto in1 = va::dtype_of_type<IN1>();
+	const auto model_in0 = va::dtype_of_type<MODEL_IN0>();
+	const auto model_in1 = va::dtype_of_type<MODEL_IN1>();
+
+	table[in0][in1] = table[model_in0][model_in1];
+}
+
 #endif //VATENSOR_ARCH_UTIL_HPP
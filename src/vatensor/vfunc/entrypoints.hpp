@@ -19,6 +19,9 @@ inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target, c
 #define DEFINE_RFUNC_CALLER_UNARY0(UFUNC_NAME)\
 inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const va::axes_type* axes) {\
 	va::call_rfunc_unary(allocator, vfunc::tables::UFUNC_NAME, target, a, axes);\
+}\
+inline VScalar UFUNC_NAME(VStoreAllocator& allocator, const VData& a) {\
+	return va::call_rfunc_unary_scalar(allocator, vfunc::tables::UFUNC_NAME, a);\
 }
 
 #define DEFINE_VFUNC_CALLER_BINARY0(UFUNC_NAME)\
@@ -26,6 +29,21 @@ inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target, c
 	va::call_vfunc_binary(allocator, vfunc::tables::UFUNC_NAME, target, a, b);\
 }
 
+#define DEFINE_VFUNC_CALLER_TERNARY0(UFUNC_NAME)\
+inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b, const VData& c) {\
+	va::call_vfunc_ternary(allocator, vfunc::tables::UFUNC_NAME, target, a, b, c);\
+}
+
+#define DEFINE_VFUNC2_CALLER_UNARY0(UFUNC_NAME)\
+inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target0, const VArrayTarget& target1, const VData& a) {\
+	va::call_vfunc_unary2(allocator, vfunc::tables::UFUNC_NAME, target0, target1, a);\
+}
+
+#define DEFINE_VFUNC2_CALLER_BINARY0(UFUNC_NAME)\
+inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target0, const VArrayTarget& target1, const VData& a, const VData& b) {\
+	va::call_vfunc_binary2(allocator, vfunc::tables::UFUNC_NAME, target0, target1, a, b);\
+}
+
 #define DEFINE_R0FUNC_CALLER_BINARY0(UFUNC_NAME)\
 inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b) {\
 	va::call_rfunc_binary(allocator, vfunc::tables::UFUNC_NAME, target, a, b);\
@@ -34,6 +52,9 @@ inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target, c
 #define DEFINE_RFUNC_CALLER_BINARY0(UFUNC_NAME)\
 inline void UFUNC_NAME(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b, const va::axes_type* axes) {\
 	va::call_rfunc_binary(allocator, vfunc::tables::UFUNC_NAME, target, a, b, axes);\
+}\
+inline VScalar UFUNC_NAME(VStoreAllocator& allocator, const VData& a, const VData& b) {\
+	return va::call_rfunc_binary_scalar(allocator, vfunc::tables::UFUNC_NAME, a, b);\
 }
 
 #define DEFINE_VFUNC_CALLER_BINARY3(UFUNC_NAME, VAR1, VAR2, VAR3)\
@@ -67,21 +88,25 @@ namespace va {
 	DEFINE_VFUNC_CALLER_BINARY0(multiply)
 	DEFINE_VFUNC_CALLER_BINARY0(divide)
 	DEFINE_VFUNC_CALLER_BINARY0(remainder)
+	// Quotient and remainder.
+	DEFINE_VFUNC2_CALLER_BINARY0(divmod)
 	DEFINE_VFUNC_CALLER_BINARY0(pow)
 	DEFINE_VFUNC_CALLER_BINARY0(minimum)
 	DEFINE_VFUNC_CALLER_BINARY0(maximum)
-	inline void clip(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& lo, const VData& hi) {
-		// TODO Re-evaluate if it's worth it to make it a ternary vfunc.
-		// TODO It should also be possible to do this without a temp variable.
-		std::shared_ptr<va::VArray> tmp;
-		va::minimum(allocator, &tmp, a, hi);
-		va::maximum(allocator, target, tmp->data, lo);
-	}
+	DEFINE_VFUNC_CALLER_TERNARY0(clip)
+	DEFINE_VFUNC_CALLER_TERNARY0(where)
 
 	DEFINE_RFUNC_CALLER_UNARY0(sum)
 	DEFINE_RFUNC_CALLER_UNARY0(prod)
 	DEFINE_RFUNC_CALLER_UNARY0(mean)
 	DEFINE_RFUNC_CALLER_UNARY0(median)
+	inline void quantile(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const double q, const axes_type* axes) {
+		// q is passed as a prvalue, so that it matches the double parameter of the table's functions.
+		va::call_rfunc_unary(allocator, vfunc::tables::quantile, target, a, axes, static_cast<double>(q));
+	}
+	inline void percentile(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const double q, const axes_type* axes) {
+		quantile(allocator, target, a, q / 100, axes);
+	}
 	DEFINE_RFUNC_CALLER_UNARY0(variance)
 	DEFINE_RFUNC_CALLER_UNARY0(standard_deviation)
 	DEFINE_RFUNC_CALLER_UNARY0(max)
@@ -91,13 +116,7 @@ namespace va {
 	DEFINE_RFUNC_CALLER_UNARY0(norm_l2)
 	DEFINE_RFUNC_CALLER_UNARY0(norm_linf)
 
-	inline void count_nonzero(VStoreAllocator& allocator, const VArrayTarget& target, const VData& array, const axes_type* axes) {
-		if (va::dtype(array) == va::Bool)
-			return va::sum(allocator, target, array, axes);
-
-		const auto is_nonzero = va::copy_as_dtype(allocator, array, va::Bool);
-		return va::sum(allocator, target, is_nonzero->data, axes);
-	}
+	DEFINE_RFUNC_CALLER_UNARY0(count_nonzero)
 
 	inline void trace(VStoreAllocator& allocator, const VArrayTarget& target, const VArray& varray, std::ptrdiff_t offset, std::ptrdiff_t axis1, std::ptrdiff_t axis2) {
 		const auto diagonal = va::diagonal(varray, offset, axis1, axis2);
@@ -121,6 +140,7 @@ namespace va {
 	DEFINE_VFUNC_CALLER_UNARY0(asinh)
 	DEFINE_VFUNC_CALLER_UNARY0(acosh)
 	DEFINE_VFUNC_CALLER_UNARY0(atanh)
+	DEFINE_VFUNC2_CALLER_UNARY0(sincos)
 
 	inline void angle(VStoreAllocator& allocator, const VArrayTarget& target, const std::shared_ptr<VArray>& array) {
 		va::atan2(allocator, target, va::imag(array)->data, va::real(array)->data);
@@ -131,6 +151,10 @@ namespace va {
 	DEFINE_VFUNC_CALLER_UNARY0(trunc)
 	DEFINE_VFUNC_CALLER_UNARY0(round)
 	DEFINE_VFUNC_CALLER_UNARY0(rint)
+	// Fractional and integral parts.
+	DEFINE_VFUNC2_CALLER_UNARY0(modf)
+	// Mantissa and exponent.
+	DEFINE_VFUNC2_CALLER_UNARY0(frexp)
 
 	DEFINE_VFUNC_CALLER_UNARY0(logical_not)
 	DEFINE_VFUNC_CALLER_BINARY0(logical_and)
@@ -166,8 +190,6 @@ namespace va {
 	}
 	DEFINE_R0FUNC_CALLER_BINARY3(all_close, double, double, bool)
 
-	DEFINE_VFUNC_CALLER_UNARY1(fft, std::ptrdiff_t)
-
 	DEFINE_RFUNC_CALLER_BINARY0(sum_product)
 
 	inline void a0xb1_minus_a1xb0(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const VData& b, const std::ptrdiff_t i0, const std::ptrdiff_t i1) {
@@ -9,6 +9,17 @@ namespace va::vfunc {
 		std::array<va::DType, N> input_types;
 		va::DType output_dtype;
 		void* function_ptr;
+		// Same function, on contiguous memory of the given size, for element-wise functions without extra arguments.
+		// Takes pointers instead of arrays. May be nullptr.
+		void* flat_function_ptr = nullptr;
+	};
+
+	// Like VFunc, for functions that write two outputs in one pass over their inputs.
+	template <int N>
+	struct VFunc2 {
+		std::array<va::DType, N> input_types;
+		std::array<va::DType, 2> output_dtypes;
+		void* function_ptr;
 	};
 }
 
@@ -28,6 +39,16 @@ namespace va::vfunc::tables {
 		UFuncTableBinary tensors;
 		UFuncTableBinary scalar_right;
 	};
+
+	using UFuncTableTernary = std::array<std::array<std::array<VFunc<3>, DTypeMax>, DTypeMax>, DTypeMax>;
+	struct UFuncTablesTernary {
+		UFuncTableTernary tensors;
+		// The second and third arguments are scalars.
+		UFuncTableTernary scalar_right;
+	};
+
+	using UFuncTableUnary2 = std::array<VFunc2<1>, DTypeMax>;
+	using UFuncTableBinary2 = std::array<std::array<VFunc2<2>, DTypeMax>, DTypeMax>;
 }
 
 #ifndef VA_TABLES_EXTERN
@@ -60,14 +81,18 @@ namespace va::vfunc::tables {
 	VA_TABLES_EXTERN UFuncTablesBinaryCommutative multiply;
 	VA_TABLES_EXTERN UFuncTablesBinary divide;
 	VA_TABLES_EXTERN UFuncTablesBinary remainder;
+	VA_TABLES_EXTERN UFuncTableBinary2 divmod;
 	VA_TABLES_EXTERN UFuncTablesBinary pow;
 	VA_TABLES_EXTERN UFuncTablesBinaryCommutative minimum;
 	VA_TABLES_EXTERN UFuncTablesBinaryCommutative maximum;
+	VA_TABLES_EXTERN UFuncTablesTernary clip;
+	VA_TABLES_EXTERN UFuncTablesTernary where;
 	
 	VA_TABLES_EXTERN UFuncTableUnary sum;
 	VA_TABLES_EXTERN UFuncTableUnary prod;
 	VA_TABLES_EXTERN UFuncTableUnary mean;
 	VA_TABLES_EXTERN UFuncTableUnary median;
+	VA_TABLES_EXTERN UFuncTableUnary quantile;
 	VA_TABLES_EXTERN UFuncTableUnary variance;
 	VA_TABLES_EXTERN UFuncTableUnary standard_deviation;
 	VA_TABLES_EXTERN UFuncTableUnary max;
@@ -76,6 +101,7 @@ namespace va::vfunc::tables {
 	VA_TABLES_EXTERN UFuncTableUnary norm_l1;
 	VA_TABLES_EXTERN UFuncTableUnary norm_l2;
 	VA_TABLES_EXTERN UFuncTableUnary norm_linf;
+	VA_TABLES_EXTERN UFuncTableUnary count_nonzero;
 
 	VA_TABLES_EXTERN UFuncTableUnary all;
 	VA_TABLES_EXTERN UFuncTableUnary any;
@@ -93,12 +119,15 @@ namespace va::vfunc::tables {
 	VA_TABLES_EXTERN UFuncTableUnary asinh;
 	VA_TABLES_EXTERN UFuncTableUnary acosh;
 	VA_TABLES_EXTERN UFuncTableUnary atanh;
+	VA_TABLES_EXTERN UFuncTableUnary2 sincos;
 
 	VA_TABLES_EXTERN UFuncTableUnary ceil;
 	VA_TABLES_EXTERN UFuncTableUnary floor;
 	VA_TABLES_EXTERN UFuncTableUnary trunc;
 	VA_TABLES_EXTERN UFuncTableUnary round;
 	VA_TABLES_EXTERN UFuncTableUnary rint;
+	VA_TABLES_EXTERN UFuncTableUnary2 modf;
+	VA_TABLES_EXTERN UFuncTableUnary2 frexp;
 
 	VA_TABLES_EXTERN UFuncTableUnary logical_not;
 	VA_TABLES_EXTERN UFuncTablesBinaryCommutative logical_and;
@@ -127,7 +156,6 @@ namespace va::vfunc::tables {
 	VA_TABLES_EXTERN UFuncTablesBinaryCommutative array_equiv;
 	VA_TABLES_EXTERN UFuncTablesBinaryCommutative all_close;
 
-	VA_TABLES_EXTERN UFuncTableUnary fft;
 	VA_TABLES_EXTERN UFuncTableUnary pad;
 
 	VA_TABLES_EXTERN UFuncTableBinary sum_product;
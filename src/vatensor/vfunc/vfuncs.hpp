@@ -1,7 +1,6 @@
 #ifndef VFUNCS_HPP
 #define VFUNCS_HPP
 
-#include <xtensor-signal/fft.hpp>
 #include <xtensor/reducers/xnorm.hpp>
 #include <xtensor/misc/xpad.hpp>
 #include <xtensor/generators/xrandom.hpp>
@@ -10,6 +9,10 @@
 #include "vatensor/varray.hpp"
 #include "vatensor/vpromote.hpp"
 #include "vatensor/vassign.hpp"
+#include "vatensor/short_circuit.hpp"
+#include "vatensor/elementwise.hpp"
+#include "vatensor/gather.hpp"
+#include "vatensor/select.hpp"
 #include "xtensor/core/xoperation.hpp"
 
 #define BIT_SHIFT_SAFE(NAME, OP)\
@@ -62,20 +65,6 @@ namespace va::op {
 		return static_cast<std::complex<float_t>>(i);
 	}
 
-	// FIXME These don't support axes yet, see https://github.com/xtensor-stack/xtensor/issues/1555
-	using namespace xt;
-	XTENSOR_REDUCER_FUNCTION(va_any, xt::detail::logical_or, bool, false)
-	XTENSOR_REDUCER_FUNCTION(va_all, xt::detail::logical_and, bool, true)
-
-	template <class T1>
-	auto median(const T1 &t1, const axes_type& axes) {
-		// TODO Improve implementation, this one is very finnicky
-		if (axes.size() > 1) {
-			throw std::runtime_error("only single axis median is supported right now");
-		}
-		return xt::median(t1, axes[0]);
-	}
-
 	template <class VWrite, class I>
 	auto vcast(const I& cvalue) {
 		using VRead = typename I::value_type;
@@ -106,6 +95,114 @@ namespace va::op {
 		}
 	}
 
+	struct is_zero {
+		template <class T1>
+		constexpr bool operator()(const T1& arg1) const { return arg1 == T1(0); }
+	};
+
+	struct is_nonzero {
+		template <class T1>
+		constexpr bool operator()(const T1& arg1) const { return arg1 != T1(0); }
+	};
+
+	struct max_fun {
+		template <class T1>
+		constexpr T1 operator()(const T1& arg1, const T1& arg2) const { return arg1 < arg2 ? arg2 : arg1; }
+	};
+
+	struct min_fun {
+		template <class T1>
+		constexpr T1 operator()(const T1& arg1, const T1& arg2) const { return arg2 < arg1 ? arg2 : arg1; }
+	};
+
+	// With optimizations, compilers fuse sin and cos of the same argument into one sincos call.
+	struct sincos_fun {
+		template <class T>
+		void operator()(T& s, T& c, const T& x) const {
+			s = std::sin(x);
+			c = std::cos(x);
+		}
+	};
+
+	// Floor division and its remainder, like numpy (and python): the remainder has the sign of the divisor.
+	struct divmod_fun {
+		template <class T>
+		void operator()(T& q, T& r, const T& a, const T& b) const {
+			if constexpr (std::is_floating_point_v<T>) {
+				// Same algorithm as numpy's npy_divmod, so that results match for all inputs.
+				T mod = std::fmod(a, b);
+				if (b == T(0)) {
+					q = a / b;
+					r = mod;
+					return;
+				}
+
+				T div = (a - mod) / b;
+				if (mod != T(0)) {
+					if ((b < T(0)) != (mod < T(0))) {
+						mod += b;
+						div -= T(1);
+					}
+				}
+				else {
+					mod = std::copysign(T(0), b);
+				}
+
+				if (div != T(0)) {
+					T floor_div = std::floor(div);
+					if (div - floor_div > T(0.5)) floor_div += T(1);
+					q = floor_div;
+				}
+				else {
+					q = std::copysign(T(0), a / b);
+				}
+				r = mod;
+			}
+			else {
+				// Division by zero gives 0 for both, like numpy (which also warns).
+				if (b == T(0)) {
+					q = T(0);
+					r = T(0);
+					return;
+				}
+				if constexpr (std::is_signed_v<T>) {
+					// Overflows in numpy too; avoids the undefined behavior of the division.
+					if (b == T(-1)) {
+						q = static_cast<T>(T(0) - static_cast<std::make_unsigned_t<T>>(a));
+						r = T(0);
+						return;
+					}
+				}
+
+				q = static_cast<T>(a / b);
+				r = static_cast<T>(a % b);
+				if constexpr (std::is_signed_v<T>) {
+					if (r != T(0) && (r < T(0)) != (b < T(0))) {
+						q -= T(1);
+						r += b;
+					}
+				}
+			}
+		}
+	};
+
+	// The exponent is 0 for non-finite values, which std::frexp leaves unspecified.
+	struct frexp_fun {
+		template <class T, class E>
+		void operator()(T& mantissa, E& exponent, const T& x) const {
+			int exponent_ = 0;
+			mantissa = std::frexp(x, &exponent_);
+			exponent = std::isfinite(x) ? static_cast<E>(exponent_) : E(0);
+		}
+	};
+
+	struct modf_fun {
+		template <class T>
+		void operator()(T& fractional, T& integral, const T& x) const {
+			fractional = std::modf(x, &integral);
+		}
+	};
+
 	template <class T1>
 	auto consecutive(const T1 &start, const T1 &step, const std::size_t &num) {
 		return start + xt::arange(num) * step;
@@ -121,20 +218,41 @@ inline void UFUNC_NAME(R& ret, ##__VA_ARGS__) {\
 #define IMPLEMENT_UNARY_VFUNC(UFUNC_NAME, OP, ...)\
 template <typename R, typename A>\
 inline void UFUNC_NAME(R& ret, const A& a, ##__VA_ARGS__) {\
-	va::broadcasting_assign_typesafe(ret, OP);\
+	va::parallel_assign_typesafe(ret, OP);\
 }
 
 #define IMPLEMENT_BINARY_VFUNC(UFUNC_NAME, OP, ...)\
 template <typename R, typename A, typename B>\
 inline void UFUNC_NAME(R& ret, const A& a, const B& b, ##__VA_ARGS__) {\
-	va::broadcasting_assign_typesafe(ret, OP);\
+	va::parallel_assign_typesafe(ret, OP);\
+}
+
+#define IMPLEMENT_TERNARY_VFUNC(UFUNC_NAME, OP, ...)\
+template <typename R, typename A, typename B, typename C>\
+inline void UFUNC_NAME(R& ret, const A& a, const B& b, const C& c, ##__VA_ARGS__) {\
+	va::parallel_assign_typesafe(ret, OP);\
+}
+
+#define IMPLEMENT_UNARY_VFUNC2(UFUNC_NAME, OP)\
+template <typename R0, typename R1, typename A>\
+inline void UFUNC_NAME(R0& ret0, R1& ret1, const A& a) {\
+	va::elementwise::map2(ret0, ret1, OP {}, a);\
+}
+
+#define IMPLEMENT_BINARY_VFUNC2(UFUNC_NAME, OP)\
+template <typename R0, typename R1, typename A, typename B>\
+inline void UFUNC_NAME(R0& ret0, R1& ret1, const A& a, const B& b) {\
+	va::elementwise::map2(ret0, ret1, OP {}, a, b);\
 }
 
+// The lambda arguments shadow ret and a, so that SINGLE and MULTI can be evaluated on chunks.
 #define IMPLEMENT_UNARY_RFUNC(UFUNC_NAME, SINGLE, MULTI)\
 template <typename R, typename A>\
 inline void UFUNC_NAME(R& ret, const A& a, const va::axes_type* axes) {\
 	if (axes) {\
-		va::broadcasting_assign_typesafe(ret, MULTI);\
+		va::parallel::reduce_axes(ret, a, *axes, [axes](auto& ret, const auto& a) {\
+			va::broadcasting_assign_typesafe(ret, MULTI);\
+		});\
 	}\
 	else {\
 		const typename R::value_type intermediate = va::op::va_cast<typename R::value_type>(SINGLE);\
@@ -142,6 +260,22 @@ inline void UFUNC_NAME(R& ret, const A& a, const va::axes_type* axes) {\
 	}\
 }
 
+// For reductions whose partial results can be combined with COMBINE, so that full reductions can be split too.
+#define IMPLEMENT_UNARY_COMBINABLE_RFUNC(UFUNC_NAME, SINGLE, MULTI, COMBINE)\
+template <typename R, typename A>\
+inline void UFUNC_NAME(R& ret, const A& a, const va::axes_type* axes) {\
+	if (axes) {\
+		va::parallel::reduce_axes(ret, a, *axes, [axes](auto& ret, const auto& a) {\
+			va::broadcasting_assign_typesafe(ret, MULTI);\
+		});\
+	}\
+	else {\
+		const auto single = va::parallel::reduce(a, [](const auto& a) { return SINGLE; }, COMBINE {});\
+		const typename R::value_type intermediate = va::op::va_cast<typename R::value_type>(single);\
+		broadcasting_assign_typesafe(ret, xt::xscalar<typename R::value_type>(intermediate));\
+	}\
+}
+
 #define IMPLEMENT_BINARY_RFUNC(UFUNC_NAME, SINGLE, MULTI)\
 template <typename R, typename A, typename B>\
 inline void UFUNC_NAME(R& ret, const A& a, const B& b, const va::axes_type* axes) {\
@@ -154,6 +288,24 @@ inline void UFUNC_NAME(R& ret, const A& a, const B& b, const va::axes_type* axes
 	}\
 }
 
+// Full reductions stop at the first element for which DECIDES holds, and return !IDENTITY if there is one.
+// Reductions over the innermost axes of contiguous inputs stop early for each result, too.
+#define IMPLEMENT_UNARY_SHORT_CIRCUIT_RFUNC(UFUNC_NAME, IDENTITY, DECIDES)\
+template <typename R, typename A>\
+inline void UFUNC_NAME(R& ret, const A& a, const va::axes_type* axes) {\
+	if (axes) {\
+		if (va::short_circuit::try_any_inner_axes(ret, a, *axes, IDENTITY, DECIDES {})) return;\
+		va::parallel::reduce_axes(ret, a, *axes, [axes](auto& ret, const auto& a) {\
+			const auto num_decided = xt::sum(xt::cast<int64_t>(xt::detail::make_xfunction<DECIDES>(a)), *axes);\
+			va::broadcasting_assign_typesafe(ret, xt::equal(xt::equal(num_decided, 0), IDENTITY));\
+		});\
+	}\
+	else {\
+		const bool is_decided = va::short_circuit::any(a, DECIDES {});\
+		broadcasting_assign_typesafe(ret, xt::xscalar<typename R::value_type>(is_decided != IDENTITY));\
+	}\
+}
+
 namespace va::vfunc::impl {
 	IMPLEMENT_INPLACE_VFUNC(fill, xt::xscalar(*static_cast<typename R::value_type*>(fill_value)), void* fill_value)
 	IMPLEMENT_UNARY_VFUNC(assign, va::op::vcast<typename R::value_type>(a))
@@ -202,25 +354,58 @@ namespace va::vfunc::impl {
 	IMPLEMENT_BINARY_VFUNC(multiply, xt::detail::make_xfunction<xt::detail::multiplies>(va::promote::to_num(a), va::promote::to_num(b)))
 	IMPLEMENT_BINARY_VFUNC(divide, xt::detail::make_xfunction<xt::detail::divides>(va::promote::to_num(a), va::promote::to_num(b)))
 	IMPLEMENT_BINARY_VFUNC(remainder, xt::remainder(va::promote::to_num(a), va::promote::to_num(b)))
+	IMPLEMENT_BINARY_VFUNC2(divmod, va::op::divmod_fun)
 	IMPLEMENT_BINARY_VFUNC(pow, xt::pow(va::promote::to_num(a), va::promote::to_num(b)))
 	IMPLEMENT_BINARY_VFUNC(minimum, xt::minimum(a, b))
 	IMPLEMENT_BINARY_VFUNC(maximum, xt::maximum(a, b))
+	// minimum(maximum(a, lo), hi) in one pass, like numpy: hi wins if lo > hi.
+	IMPLEMENT_TERNARY_VFUNC(clip, xt::minimum(xt::maximum(a, b), c))
+	IMPLEMENT_TERNARY_VFUNC(where, xt::where(a, b, c))
 
-	IMPLEMENT_UNARY_RFUNC(sum, xt::sum(a)(), xt::sum(a, *axes))
-	IMPLEMENT_UNARY_RFUNC(prod, xt::prod(a)(), xt::prod(a, *axes))
+	IMPLEMENT_UNARY_COMBINABLE_RFUNC(sum, xt::sum(a)(), xt::sum(a, *axes), std::plus)
+	IMPLEMENT_UNARY_COMBINABLE_RFUNC(prod, xt::prod(a)(), xt::prod(a, *axes), std::multiplies)
 	IMPLEMENT_UNARY_RFUNC(mean, xt::mean(a)(), xt::mean(a, *axes))
-	IMPLEMENT_UNARY_RFUNC(median, xt::median(a), va::op::median(a, *axes))
+	template <typename R, typename A>
+	inline void quantile(R& ret, const A& a, const va::axes_type* axes, double q) {
+		va::select::quantile(ret, a, axes, q);
+	}
+
+	template <typename R, typename A>
+	inline void median(R& ret, const A& a, const va::axes_type* axes) {
+		va::select::quantile(ret, a, axes, 0.5);
+	}
 	IMPLEMENT_UNARY_RFUNC(variance, xt::variance(a)(), xt::variance(a, *axes))
 	IMPLEMENT_UNARY_RFUNC(standard_deviation, xt::stddev(a)(), xt::stddev(a, *axes))
-	IMPLEMENT_UNARY_RFUNC(max, xt::amax(a)(), xt::amax(a, *axes))
-	IMPLEMENT_UNARY_RFUNC(min, xt::amin(a)(), xt::amin(a, *axes))
-	IMPLEMENT_UNARY_RFUNC(norm_l0, xt::norm_l0(a)(), xt::norm_l0(a, *axes, xt::evaluation_strategy::lazy))
-	IMPLEMENT_UNARY_RFUNC(norm_l1, xt::norm_l1(a)(), xt::norm_l1(a, *axes, xt::evaluation_strategy::lazy))
+	IMPLEMENT_UNARY_COMBINABLE_RFUNC(max, xt::amax(a)(), xt::amax(a, *axes), va::op::max_fun)
+	IMPLEMENT_UNARY_COMBINABLE_RFUNC(min, xt::amin(a)(), xt::amin(a, *axes), va::op::min_fun)
+	IMPLEMENT_UNARY_COMBINABLE_RFUNC(norm_l0, xt::norm_l0(a)(), xt::norm_l0(a, *axes, xt::evaluation_strategy::lazy), std::plus)
+	IMPLEMENT_UNARY_COMBINABLE_RFUNC(norm_l1, xt::norm_l1(a)(), xt::norm_l1(a, *axes, xt::evaluation_strategy::lazy), std::plus)
 	IMPLEMENT_UNARY_RFUNC(norm_l2, xt::norm_l2(a)(), xt::norm_l2(a, *axes, xt::evaluation_strategy::lazy))
-	IMPLEMENT_UNARY_RFUNC(norm_linf, xt::norm_linf(a)(), xt::norm_linf(a, *axes, xt::evaluation_strategy::lazy))
+	IMPLEMENT_UNARY_COMBINABLE_RFUNC(norm_linf, xt::norm_linf(a)(), xt::norm_linf(a, *axes, xt::evaluation_strategy::lazy), va::op::max_fun)
+
+	template <typename R, typename A>
+	inline void count_nonzero(R& ret, const A& a, const va::axes_type* axes) {
+		if (axes) {
+			const auto inner = va::util::innermost_axes_size(a.shape(), *axes);
+			if (inner && va::short_circuit::is_linear(a) && va::short_circuit::is_linear(ret) && ret.size() * *inner == a.size()) {
+				va::gather::parallel_count_nonzero_rows(ret.data(), a.data(), ret.size(), *inner);
+				return;
+			}
+
+			va::parallel::reduce_axes(ret, a, *axes, [axes](auto& ret, const auto& a) {
+				va::broadcasting_assign_typesafe(ret, xt::sum(xt::cast<int64_t>(xt::detail::make_xfunction<va::op::is_nonzero>(a)), *axes));
+			});
+		}
+		else {
+			const std::size_t count = va::short_circuit::is_linear(a)
+				? va::gather::parallel_count_nonzero(a.data(), a.size())
+				: static_cast<std::size_t>(xt::sum(xt::cast<int64_t>(xt::detail::make_xfunction<va::op::is_nonzero>(a)))());
+			broadcasting_assign_typesafe(ret, xt::xscalar<typename R::value_type>(count));
+		}
+	}
 
-	IMPLEMENT_UNARY_RFUNC(all, va::op::va_all(a)(), va::op::va_all(a, *axes))
-	IMPLEMENT_UNARY_RFUNC(any, va::op::va_any(a)(), va::op::va_any(a, *axes))
+	IMPLEMENT_UNARY_SHORT_CIRCUIT_RFUNC(all, true, va::op::is_zero)
+	IMPLEMENT_UNARY_SHORT_CIRCUIT_RFUNC(any, false, va::op::is_nonzero)
 
 	IMPLEMENT_UNARY_VFUNC(sin, xt::sin(va::promote::to_num(a)))
 	IMPLEMENT_UNARY_VFUNC(cos, xt::cos(va::promote::to_num(a)))
@@ -235,6 +420,7 @@ namespace va::vfunc::impl {
 	IMPLEMENT_UNARY_VFUNC(asinh, xt::asinh(va::promote::to_num(a)))
 	IMPLEMENT_UNARY_VFUNC(acosh, xt::acosh(va::promote::to_num(a)))
 	IMPLEMENT_UNARY_VFUNC(atanh, xt::atanh(va::promote::to_num(a)))
+	IMPLEMENT_UNARY_VFUNC2(sincos, va::op::sincos_fun)
 
 	IMPLEMENT_UNARY_VFUNC(ceil, xt::ceil(va::promote::to_num(a)))
 	IMPLEMENT_UNARY_VFUNC(floor, xt::floor(va::promote::to_num(a)))
@@ -242,6 +428,8 @@ namespace va::vfunc::impl {
 	IMPLEMENT_UNARY_VFUNC(round, xt::detail::make_xfunction<va::op::round_fun>(a))
 	// Actually uses nearbyint because rint can throw, which is undesirable in our case, and unlike numpy's behavior.
 	IMPLEMENT_UNARY_VFUNC(rint, xt::nearbyint(va::promote::to_num(a)))
+	IMPLEMENT_UNARY_VFUNC2(modf, va::op::modf_fun)
+	IMPLEMENT_UNARY_VFUNC2(frexp, va::op::frexp_fun)
 
 	IMPLEMENT_UNARY_VFUNC(logical_not, !va::promote::to_bool(a))
 	// TODO RE-optimize these to short circuit on scalars
@@ -268,10 +456,22 @@ namespace va::vfunc::impl {
 	IMPLEMENT_UNARY_VFUNC(isinf, xt::isinf(va::promote::to_num(a)))
 
 	IMPLEMENT_BINARY_VFUNC(is_close, xt::isclose(va::promote::to_num(a), va::promote::to_num(b), rtol, atol, equal_nan), double rtol, double atol, bool equal_nan)
-	IMPLEMENT_BINARY_VFUNC(array_equiv, xt::xscalar<bool>(xt::all(xt::equal(a, b))))
-	IMPLEMENT_BINARY_VFUNC(all_close, xt::xscalar<bool>(xt::all(xt::isclose(va::promote::to_num(a), va::promote::to_num(b), rtol, atol, equal_nan))), double rtol, double atol, bool equal_nan)
+	template <typename R, typename A, typename B>
+	inline void array_equiv(R& ret, const A& a, const B& b) {
+		const bool is_equiv = va::short_circuit::is_broadcastable(a, b)
+			&& !va::short_circuit::any(xt::not_equal(a, b), [](const bool x) { return x; });
+		va::broadcasting_assign_typesafe(ret, xt::xscalar<typename R::value_type>(is_equiv));
+	}
+
+	template <typename R, typename A, typename B>
+	inline void all_close(R& ret, const A& a, const B& b, double rtol, double atol, bool equal_nan) {
+		const bool is_close = !va::short_circuit::any(
+			xt::isclose(va::promote::to_num(a), va::promote::to_num(b), rtol, atol, equal_nan),
+			[](const bool x) { return !x; }
+		);
+		va::broadcasting_assign_typesafe(ret, xt::xscalar<typename R::value_type>(is_close));
+	}
 
-	IMPLEMENT_UNARY_VFUNC(fft, xt::fft::fft(std::forward<decltype(a)>(a), axis), std::ptrdiff_t axis)
 	IMPLEMENT_UNARY_VFUNC(
 		pad,
 		xt::pad(std::forward<decltype(a)>(a), pad_width, pad_mode, *static_cast<typename A::value_type*>(pad_value)),
@@ -1,7 +1,14 @@
 #include "vio.hpp"
 
+#include <algorithm>                       // for min
+#include <cstdint>                         // for uint32_t
+#include <cstring>                         // for memcmp
+#include <memory>                          // for unique_ptr
+#include <string_view>                     // for string_view
+
 #include "xtensor/io/xnpy.hpp"
 #include "array_store.hpp"
+#include "mmap_store.hpp"
 
 struct membuf : std::streambuf {
 	membuf(char* begin, char* end) {
@@ -45,6 +52,104 @@ va::DType dtype_from_typestring(std::string& type_string) {
 	else return va::DTypeMax;
 }
 
+// Returns the text after "'key':" in a npy header dict, or an empty view if the key is missing.
+std::string_view npy_header_value(const std::string_view header, const std::string_view key) {
+	const auto key_pos = header.find(key);
+	if (key_pos == std::string_view::npos) return {};
+
+	const auto colon = header.find(':', key_pos + key.size());
+	if (colon == std::string_view::npos) return {};
+
+	auto value = header.substr(colon + 1);
+	while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+	return value;
+}
+
+va::NpyHeader va::read_npy_header(const char* data, const std::size_t size) {
+	if (size < 10 || std::memcmp(data, "\x93NUMPY", 6) != 0) {
+		throw std::runtime_error("Not a npy file");
+	}
+
+	const auto major_version = static_cast<unsigned char>(data[6]);
+	const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+
+	std::size_t header_begin;
+	std::size_t header_length;
+	if (major_version == 1) {
+		header_begin = 10;
+		header_length = bytes[8] | bytes[9] << 8;
+	}
+	else if (major_version == 2 || major_version == 3) {
+		if (size < 12) throw std::runtime_error("Npy header is truncated");
+		header_begin = 12;
+		header_length = bytes[8] | bytes[9] << 8 | bytes[10] << 16 | static_cast<std::uint32_t>(bytes[11]) << 24;
+	}
+	else {
+		throw std::runtime_error("Unsupported npy version");
+	}
+
+	if (header_begin + header_length > size) {
+		throw std::runtime_error("Npy header is truncated");
+	}
+	const std::string_view header(data + header_begin, header_length);
+
+	NpyHeader result {};
+	result.data_offset = header_begin + header_length;
+
+	const auto descr = npy_header_value(header, "'descr'");
+	if (descr.size() < 2 || descr.front() != '\'') throw std::runtime_error("Npy header is missing 'descr'");
+	std::string type_string(descr.substr(1, descr.find('\'', 1) - 1));
+	result.dtype = dtype_from_typestring(type_string);
+	if (result.dtype == va::DTypeMax) {
+		throw std::runtime_error("Npy type is not supported");
+	}
+	std::visit([&type_string](auto t) {
+		using T = decltype(t);
+		// Also checks the byte order.
+		if (type_string != xt::detail::build_typestring<T>() && type_string.substr(1) != xt::detail::build_typestring<T>().substr(1)) {
+			throw std::runtime_error("Npy type is not supported");
+		}
+		if (type_string[0] == '>' && sizeof(T) > 1) {
+			throw std::runtime_error("Npy type is not supported");
+		}
+	}, dtype_to_variant(result.dtype));
+
+	result.fortran_order = npy_header_value(header, "'fortran_order'").substr(0, 4) == "True";
+
+	auto shape = npy_header_value(header, "'shape'");
+	if (shape.empty() || shape.front() != '(') throw std::runtime_error("Npy header is missing 'shape'");
+	shape = shape.substr(1, shape.find(')') - 1);
+	std::size_t dim = 0;
+	bool has_digits = false;
+	for (const char c : shape) {
+		if (c >= '0' && c <= '9') {
+			dim = dim * 10 + static_cast<std::size_t>(c - '0');
+			has_digits = true;
+		}
+		else if (c == ',' && has_digits) {
+			result.shape.push_back(dim);
+			dim = 0;
+			has_digits = false;
+		}
+	}
+	if (has_digits) result.shape.push_back(dim);
+
+	return result;
+}
+
+std::shared_ptr<va::VArray> va::load_npy_mmap(const char* path) {
+	const auto file = std::make_shared<store::MappedFile>(path);
+	const NpyHeader header = read_npy_header(file->data(), file->size());
+
+	return store::from_mapped_file(
+		file,
+		header.data_offset,
+		header.dtype,
+		header.shape,
+		header.fortran_order ? xt::layout_type::column_major : xt::layout_type::row_major
+	);
+}
+
 std::shared_ptr<va::VArray> va::load_npy(const char* data, std::size_t size) {
 	auto sbuf = membuf(const_cast<char*>(data), const_cast<char*>(data) + size);
 	std::istream in(&sbuf);
@@ -81,3 +186,235 @@ std::string va::save_npy(VData& data) {
 		return xt::dump_npy(data);
 	}, data);
 }
+
+// Number of bytes per write; bounds the temporary memory of non-contiguous writes.
+static constexpr std::size_t chunk_size = 1 << 20;
+// Spare header space, for the leading axis to grow by as many digits.
+static constexpr std::size_t header_growth_room = 20;
+
+std::string npy_header_dict(const va::DType dtype, const va::shape_type& shape) {
+	std::string dict = "{'descr': '";
+	dict += std::visit([](auto t) { return xt::detail::build_typestring<decltype(t)>(); }, va::dtype_to_variant(dtype));
+	dict += "', 'fortran_order': False, 'shape': (";
+	for (const auto dim : shape) {
+		dict += std::to_string(dim);
+		dict += ", ";
+	}
+	// 1-D tuples need their trailing comma, others don't.
+	if (shape.size() > 1) dict.resize(dict.size() - 2);
+	else if (shape.size() == 1) dict.pop_back();
+	dict += "), }";
+	return dict;
+}
+
+std::string npy_preamble(const std::string& dict, const std::size_t header_length) {
+	std::string result = "\x93NUMPY";
+	result += static_cast<char>(1);
+	result += static_cast<char>(0);
+	result += static_cast<char>(header_length & 0xff);
+	result += static_cast<char>(header_length >> 8);
+	result += dict;
+	result.append(header_length - dict.size() - 1, ' ');
+	result += '\n';
+	return result;
+}
+
+std::string va::npy_header(const DType dtype, const shape_type& shape) {
+	const std::string dict = npy_header_dict(dtype, shape);
+
+	// The data starts at a multiple of 64 bytes, like NumPy's own files.
+	const std::size_t min_length = 10 + dict.size() + header_growth_room + 1;
+	const std::size_t total_length = (min_length + 63) / 64 * 64;
+	return npy_preamble(dict, total_length - 10);
+}
+
+std::size_t va::npy_size(const VData& data) {
+	return npy_header(va::dtype(data), va::shape(data)).size() + va::size(data) * size_of_dtype_in_bytes(va::dtype(data));
+}
+
+void va::write_npy_data(const VData& data, const ByteWriter& write) {
+	const bool is_contiguous = va::is_contiguous(data);
+
+	std::visit([&write, is_contiguous](const auto& carray) {
+		using V = typename std::decay_t<decltype(carray)>::value_type;
+
+		if (is_contiguous) {
+			const char* ptr = reinterpret_cast<const char*>(carray.data() + carray.data_offset());
+			const std::size_t n_bytes = carray.size() * sizeof(V);
+			for (std::size_t begin = 0; begin < n_bytes; begin += chunk_size) {
+				write(ptr + begin, std::min(chunk_size, n_bytes - begin));
+			}
+			return;
+		}
+
+		constexpr std::size_t chunk_count = std::max<std::size_t>(chunk_size / sizeof(V), 1);
+		const std::unique_ptr<V[]> buffer(new V[std::min(chunk_count, carray.size())]);
+
+		std::size_t buffered = 0;
+		const auto end = carray.template end<xt::layout_type::row_major>();
+		for (auto it = carray.template begin<xt::layout_type::row_major>(); it != end; ++it) {
+			buffer[buffered++] = *it;
+			if (buffered == chunk_count) {
+				write(reinterpret_cast<const char*>(buffer.get()), buffered * sizeof(V));
+				buffered = 0;
+			}
+		}
+		if (buffered > 0) {
+			write(reinterpret_cast<const char*>(buffer.get()), buffered * sizeof(V));
+		}
+	}, data);
+}
+
+void va::write_npy(const VData& data, const ByteWriter& write) {
+	const std::string header = npy_header(va::dtype(data), va::shape(data));
+	write(header.data(), header.size());
+	write_npy_data(data, write);
+}
+
+std::string va::append_npy_header(const NpyHeader& header, const VData& data) {
+	if (header.fortran_order) {
+		throw std::runtime_error("Cannot append to a fortran-ordered npy file");
+	}
+	if (header.dtype != va::dtype(data)) {
+		throw std::runtime_error("Appended array dtype does not match the npy file");
+	}
+	if (header.shape.empty()) {
+		throw std::runtime_error("Cannot append to a 0-D npy file");
+	}
+
+	const auto& data_shape = va::shape(data);
+	std::size_t rows;
+	if (data_shape.size() + 1 == header.shape.size() && std::equal(data_shape.begin(), data_shape.end(), header.shape.begin() + 1)) {
+		rows = 1;
+	}
+	else if (data_shape.size() == header.shape.size() && std::equal(data_shape.begin() + 1, data_shape.end(), header.shape.begin() + 1)) {
+		rows = data_shape[0];
+	}
+	else {
+		throw std::runtime_error("Appended array shape does not match the npy file");
+	}
+
+	shape_type shape = header.shape;
+	shape[0] += rows;
+
+	const std::string dict = npy_header_dict(header.dtype, shape);
+	if (10 + dict.size() + 1 > header.data_offset || header.data_offset - 10 > 0xffff) {
+		throw std::runtime_error("The npy header has no room to grow; re-save the file before appending");
+	}
+	return npy_preamble(dict, header.data_offset - 10);
+}
+
+namespace {
+	struct Crc32Table {
+		std::uint32_t values[256] {};
+
+		constexpr Crc32Table() {
+			for (std::uint32_t i = 0; i < 256; ++i) {
+				std::uint32_t c = i;
+				for (int k = 0; k < 8; ++k) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				values[i] = c;
+			}
+		}
+	};
+
+	constexpr Crc32Table crc32_table;
+
+	std::uint32_t crc32(std::uint32_t crc, const char* data, const std::size_t size) {
+		crc = ~crc;
+		for (std::size_t i = 0; i < size; ++i) {
+			crc = crc32_table.values[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+	void put_u16(std::string& out, const std::size_t value) {
+		out += static_cast<char>(value & 0xff);
+		out += static_cast<char>((value >> 8) & 0xff);
+	}
+
+	void put_u32(std::string& out, const std::size_t value) {
+		put_u16(out, value & 0xffff);
+		put_u16(out, (value >> 16) & 0xffff);
+	}
+
+	struct ZipEntry {
+		std::string name;
+		std::uint32_t crc;
+		std::size_t size;
+		std::size_t offset;
+	};
+
+	// Fields shared by local and central headers, from 'version needed' to the name length.
+	void put_zip_entry_fields(std::string& out, const ZipEntry& entry) {
+		put_u16(out, 20);  // version needed: 2.0
+		put_u16(out, 0);  // flags
+		put_u16(out, 0);  // method: stored
+		put_u16(out, 0);  // time
+		put_u16(out, (1 << 5) | 1);  // date: 1980-01-01
+		put_u32(out, entry.crc);
+		put_u32(out, entry.size);  // compressed size
+		put_u32(out, entry.size);
+		put_u16(out, entry.name.size());
+	}
+}
+
+void va::write_npz(const std::vector<std::pair<std::string, VData>>& arrays, const ByteWriter& write) {
+	std::vector<ZipEntry> entries;
+	std::size_t offset = 0;
+	const auto write_counted = [&write, &offset](const char* data, const std::size_t size) {
+		write(data, size);
+		offset += size;
+	};
+
+	for (const auto& [name, data] : arrays) {
+		ZipEntry entry { name + ".npy", 0, npy_size(data), offset };
+		// Without zip64, sizes and offsets must fit in 32 bits.
+		if (entry.size > 0xffffffffu || entry.offset > 0xffffffffu) {
+			throw std::runtime_error("npz archives larger than 4 GiB are not supported");
+		}
+
+		write_npy(data, [&entry](const char* data, const std::size_t size) {
+			entry.crc = crc32(entry.crc, data, size);
+		});
+
+		std::string header;
+		put_u32(header, 0x04034b50);
+		put_zip_entry_fields(header, entry);
+		put_u16(header, 0);  // extra length
+		header += entry.name;
+		write_counted(header.data(), header.size());
+
+		write_npy(data, write_counted);
+		entries.push_back(std::move(entry));
+	}
+
+	const std::size_t directory_offset = offset;
+	std::string directory;
+	for (const auto& entry : entries) {
+		put_u32(directory, 0x02014b50);
+		put_u16(directory, 20);  // version made by
+		put_zip_entry_fields(directory, entry);
+		put_u16(directory, 0);  // extra length
+		put_u16(directory, 0);  // comment length
+		put_u16(directory, 0);  // disk number
+		put_u16(directory, 0);  // internal attributes
+		put_u32(directory, 0);  // external attributes
+		put_u32(directory, entry.offset);
+		directory += entry.name;
+	}
+
+	const std::size_t directory_size = directory.size();
+	if (directory_offset > 0xffffffffu || entries.size() > 0xffff) {
+		throw std::runtime_error("npz archives larger than 4 GiB are not supported");
+	}
+
+	put_u32(directory, 0x06054b50);
+	put_u16(directory, 0);  // disk number
+	put_u16(directory, 0);  // disk with the directory
+	put_u16(directory, entries.size());
+	put_u16(directory, entries.size());
+	put_u32(directory, directory_size);
+	put_u32(directory, directory_offset);
+	put_u16(directory, 0);  // comment length
+	write_counted(directory.data(), directory.size());
+}
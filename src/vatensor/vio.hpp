@@ -2,11 +2,49 @@
 #define VATENSOR_VIO_HPP
 
 #include "varray.hpp"
+#include <functional>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace va {
+	struct NpyHeader {
+		DType dtype;
+		shape_type shape;
+		bool fortran_order;
+		// Number of bytes before the array data.
+		std::size_t data_offset;
+	};
+
+	// Parses the header of a .npy file. The data need only contain the header.
+	NpyHeader read_npy_header(const char* data, std::size_t size);
+
 	std::shared_ptr<VArray> load_npy(const char* data, std::size_t size);
+	// Maps the file into memory and reads from it directly. The result is copied on the first write.
+	std::shared_ptr<VArray> load_npy_mmap(const char* path);
 	std::string save_npy(VData& data);
+
+	// Receives consecutive pieces of a file being written.
+	using ByteWriter = std::function<void(const char* data, std::size_t size)>;
+
+	// Header of a row-major .npy file, including the magic string.
+	// The header is padded so that the leading axis can grow in place, see append_npy_header.
+	std::string npy_header(DType dtype, const shape_type& shape);
+	// Number of bytes write_npy will write.
+	std::size_t npy_size(const VData& data);
+	// Writes data in row-major order, in chunks, without copying the whole array.
+	void write_npy_data(const VData& data, const ByteWriter& write);
+	void write_npy(const VData& data, const ByteWriter& write);
+
+	// Header of the file after data was appended along its leading axis.
+	// data must either have the shape of one row of the file, or the same shape except for the leading axis.
+	// Throws if the new header does not fit in the space of the old one.
+	std::string append_npy_header(const NpyHeader& header, const VData& data);
+
+	// Writes an uncompressed .npz (zip) archive, with each array stored as name.npy.
+	// Each array is streamed twice: once for its checksum, once for its content.
+	void write_npz(const std::vector<std::pair<std::string, VData>>& arrays, const ByteWriter& write);
 }
 
 #endif //VATENSOR_VIO_HPP
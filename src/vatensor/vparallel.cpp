@@ -0,0 +1,168 @@
+#include "vparallel.hpp"
+
+#include <algorithm>           // for min
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <deque>               // for deque
+#include <exception>           // for exception_ptr
+#include <memory>              // for shared_ptr
+#include <mutex>               // for mutex, unique_lock
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+using namespace va;
+
+#ifdef NUMDOT_DISABLE_THREADS
+
+std::size_t parallel::get_num_threads() { return 1; }
+void parallel::set_num_threads(std::size_t num_threads) {}
+
+#else
+
+namespace {
+	struct Job {
+		std::function<void(std::size_t)> fn;
+		std::size_t count;
+		std::atomic<std::size_t> next = 0;
+		std::size_t finished = 0;
+		std::exception_ptr error;
+
+		std::mutex mutex;
+		std::condition_variable done;
+
+		// Processes items until none are left.
+		void work() {
+			std::size_t i;
+			while ((i = next.fetch_add(1)) < count) {
+				try {
+					fn(i);
+				}
+				catch (...) {
+					std::unique_lock lock(mutex);
+					if (!error) error = std::current_exception();
+				}
+
+				std::unique_lock lock(mutex);
+				if (++finished == count) done.notify_all();
+			}
+		}
+	};
+
+	// Set on pool threads, so that nested jobs don't wait on the pool that is running them.
+	thread_local bool is_pool_thread = false;
+
+	class ThreadPool {
+		std::vector<std::thread> workers;
+		std::deque<std::shared_ptr<Job>> queue;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool stopping = false;
+
+		void worker_loop() {
+			is_pool_thread = true;
+
+			while (true) {
+				std::shared_ptr<Job> job;
+				{
+					std::unique_lock lock(mutex);
+					condition.wait(lock, [this] { return stopping || !queue.empty(); });
+					if (stopping) return;
+
+					job = std::move(queue.front());
+					queue.pop_front();
+				}
+				job->work();
+			}
+		}
+
+	public:
+		// Including the calling thread.
+		std::size_t num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+		~ThreadPool() {
+			stop();
+		}
+
+		void stop() {
+			{
+				std::unique_lock lock(mutex);
+				stopping = true;
+			}
+			condition.notify_all();
+			for (auto& worker : workers) worker.join();
+
+			workers.clear();
+			queue.clear();
+			stopping = false;
+		}
+
+		void run(std::size_t count, const std::function<void(std::size_t)>& fn) {
+			const auto job = std::make_shared<Job>();
+			job->fn = fn;
+			job->count = count;
+
+			const std::size_t helpers = std::min(count, num_threads) - 1;
+			{
+				std::unique_lock lock(mutex);
+				// Workers are only started once they are first needed.
+				while (workers.size() < num_threads - 1) {
+					workers.emplace_back(&ThreadPool::worker_loop, this);
+				}
+				for (std::size_t i = 0; i < helpers; ++i) queue.push_back(job);
+			}
+			if (helpers == 1) condition.notify_one();
+			else condition.notify_all();
+
+			job->work();
+
+			std::unique_lock lock(job->mutex);
+			job->done.wait(lock, [&job] { return job->finished == job->count; });
+			if (job->error) std::rethrow_exception(job->error);
+		}
+	};
+
+	ThreadPool pool;
+}
+
+std::size_t parallel::get_num_threads() {
+	return pool.num_threads;
+}
+
+void parallel::set_num_threads(const std::size_t num_threads) {
+	pool.stop();
+	pool.num_threads = num_threads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : num_threads;
+}
+
+#endif
+
+namespace {
+	std::size_t min_size = 1 << 16;
+}
+
+std::size_t parallel::get_min_size() {
+	return min_size;
+}
+
+void parallel::set_min_size(const std::size_t min_size_) {
+	min_size = min_size_;
+}
+
+std::size_t parallel::num_chunks(const std::size_t size, const std::size_t outer) {
+#ifdef NUMDOT_DISABLE_THREADS
+	return 1;
+#else
+	if (size < min_size || is_pool_thread) return 1;
+	return std::min(get_num_threads(), outer);
+#endif
+}
+
+void parallel::run(const std::size_t count, const std::function<void(std::size_t)>& fn) {
+#ifndef NUMDOT_DISABLE_THREADS
+	if (count > 1 && get_num_threads() > 1 && !is_pool_thread) {
+		pool.run(count, fn);
+		return;
+	}
+#endif
+
+	for (std::size_t i = 0; i < count; ++i) fn(i);
+}
@@ -0,0 +1,102 @@
+#ifndef VATENSOR_VPARALLEL_HPP
+#define VATENSOR_VPARALLEL_HPP
+
+#include <algorithm>                        // for none_of
+#include <cstddef>                          // for size_t
+#include <functional>                       // for function
+#include <memory>                           // for unique_ptr
+#include <numeric>                          // for accumulate
+#include <utility>                          // for pair
+
+#include "varray.hpp"
+#include "util.hpp"
+#include "xtensor/views/xstrided_view.hpp"  // for strided_view, range
+#include "xtensor/views/xview.hpp"          // for view
+
+namespace va::parallel {
+	// Number of threads used for large operations, including the calling thread.
+	std::size_t get_num_threads();
+	// 0 resets to the number of hardware threads. 1 disables multithreading.
+	void set_num_threads(std::size_t num_threads);
+
+	// Operations on fewer elements than this are always run on the calling thread.
+	std::size_t get_min_size();
+	void set_min_size(std::size_t min_size);
+
+	// Number of chunks to split an operation of the given size into, with outer being the size of the split axis.
+	// Returns 1 if the operation should not be split.
+	std::size_t num_chunks(std::size_t size, std::size_t outer);
+
+	// Calls fn(i) for each i in [0, count), using the thread pool. Blocks until all calls have finished.
+	// The first exception thrown by any call is re-thrown on the calling thread.
+	void run(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+	inline std::pair<std::size_t, std::size_t> chunk_range(const std::size_t chunk, const std::size_t num_chunks, const std::size_t size) {
+		return { size * chunk / num_chunks, size * (chunk + 1) / num_chunks };
+	}
+
+	// Calls fn(begin, end) for chunks of the lanes, in parallel.
+	template<typename F>
+	void run_lanes(const util::Lanes& lanes, F&& fn) {
+		const std::size_t chunks = num_chunks(lanes.count * lanes.size, lanes.count);
+		run(chunks, [&fn, &lanes, chunks](const std::size_t i) {
+			const auto [begin, end] = chunk_range(i, chunks, lanes.count);
+			fn(begin, end);
+		});
+	}
+
+	// Full reduction: Reduces chunks of the first axis with fn, and the partial results with combine.
+	template<typename A, typename F, typename C>
+	auto reduce(const A& a, F&& fn, C&& combine) {
+		using T = std::decay_t<decltype(fn(a))>;
+
+		const std::size_t chunks = a.dimension() == 0 ? 1 : num_chunks(a.size(), a.shape()[0]);
+		if (chunks <= 1) {
+			return T(fn(a));
+		}
+
+		// Not a vector, because std::vector<bool> cannot be written to concurrently.
+		const std::unique_ptr<T[]> partials(new T[chunks]);
+		const std::size_t rows = a.shape()[0];
+		run(chunks, [&a, &fn, &partials, chunks, rows](const std::size_t i) {
+			const auto [begin, end] = chunk_range(i, chunks, rows);
+			partials[i] = fn(xt::strided_view(a, { xt::range(static_cast<std::ptrdiff_t>(begin), static_cast<std::ptrdiff_t>(end)) }));
+		});
+
+		return std::accumulate(partials.get() + 1, partials.get() + chunks, partials[0], std::forward<C>(combine));
+	}
+
+	// Reduction over axes: Splits along the first axis that is not reduced.
+	// That axis is always the first axis of the result.
+	template<typename R, typename A, typename F>
+	void reduce_axes(R& ret, const A& a, const axes_type& axes, F&& fn) {
+		const std::size_t dimension = a.dimension();
+
+		std::size_t split_axis = 0;
+		for (; split_axis < dimension; ++split_axis) {
+			if (std::none_of(axes.begin(), axes.end(), [split_axis, dimension](const auto axis) { return util::normalize_axis(axis, dimension) == split_axis; })) {
+				break;
+			}
+		}
+
+		const std::size_t chunks = split_axis == dimension ? 1 : num_chunks(a.size(), a.shape()[split_axis]);
+		if (chunks <= 1) {
+			fn(ret, a);
+			return;
+		}
+
+		const std::size_t rows = a.shape()[split_axis];
+		run(chunks, [&ret, &a, &fn, chunks, rows, split_axis](const std::size_t i) {
+			const auto [begin, end] = chunk_range(i, chunks, rows);
+
+			xt::xstrided_slice_vector slices(split_axis + 1, xt::all());
+			slices.back() = xt::range(static_cast<std::ptrdiff_t>(begin), static_cast<std::ptrdiff_t>(end));
+			const auto a_chunk = xt::strided_view(a, slices);
+
+			auto ret_chunk = xt::view(ret, xt::range(begin, end));
+			fn(ret_chunk, a_chunk);
+		});
+	}
+}
+
+#endif //VATENSOR_VPARALLEL_HPP
@@ -1,9 +1,19 @@
 #include "vsignal.hpp"
 
+#include <algorithm>                       // for min
+#include <array>                           // for array
+#include <complex>                         // for complex, conj
+#include <cstddef>                         // for size_t, ptrdiff_t
+#include <stdexcept>                       // for runtime_error
+#include <type_traits>                     // for is_same_v
+#include <vector>                          // for vector
+
 #include "create.hpp"
+#include "dft.hpp"
+#include "util.hpp"
+#include "vcall.hpp"
 #include "vcompute.hpp"
-#include "xtensor-signal/fft.hpp"
-#include "vatensor/vfunc/entrypoints.hpp"
+#include "vparallel.hpp"
 
 std::shared_ptr<va::VArray> va::fft_freq(VStoreAllocator& allocator, std::size_t n, double_t d) {
 	// From NumPy docs:
@@ -21,3 +31,356 @@ std::shared_ptr<va::VArray> va::fft_freq(VStoreAllocator& allocator, std::size_t
 
 	return array;
 }
+
+namespace {
+	// Lines are transformed in blocks, interleaved, so that the butterflies vectorize across the lines of a block.
+	constexpr std::size_t lines_per_block = 8;
+
+	template <typename T>
+	constexpr va::DType real_dtype = std::is_same_v<T, float> ? va::DType::Float32 : va::DType::Float64;
+	template <typename T>
+	constexpr va::DType complex_dtype = std::is_same_v<T, float> ? va::DType::Complex64 : va::DType::Complex128;
+
+	bool is_single_precision(const va::DType dtype) {
+		return dtype == va::DType::Float32 || dtype == va::DType::Complex64;
+	}
+
+	bool is_complex(const va::DType dtype) {
+		return dtype == va::DType::Complex64 || dtype == va::DType::Complex128;
+	}
+
+	template <typename T>
+	T* data_of(const va::VData& data) {
+		const auto& data_ = std::get<va::compute_case<T*>>(data);
+		return data_.data() + data_.data_offset();
+	}
+
+	// Element offset of a line along axis, with lines counted in row-major order of the other axes.
+	std::ptrdiff_t line_offset(std::size_t line, const va::shape_type& shape, const va::strides_type& strides, const std::size_t axis) {
+		std::ptrdiff_t offset = 0;
+		for (std::size_t i = shape.size(); i-- > 0;) {
+			if (i == axis) continue;
+			offset += static_cast<std::ptrdiff_t>(line % shape[i]) * strides[i];
+			line /= shape[i];
+		}
+		return offset;
+	}
+
+	// Calls fn(begin, end) for chunks of the lines, in parallel. Chunks start at multiples of lines_per_block.
+	template <typename F>
+	void run_lines(const std::size_t line_count, const std::size_t line_size, F&& fn) {
+		if (line_count == 0) return;
+
+		const std::size_t blocks = (line_count + lines_per_block - 1) / lines_per_block;
+		const std::size_t chunks = va::parallel::num_chunks(line_count * line_size, blocks);
+		va::parallel::run(chunks, [&fn, chunks, blocks, line_count](const std::size_t chunk) {
+			const auto [begin, end] = va::parallel::chunk_range(chunk, chunks, blocks);
+			fn(begin * lines_per_block, std::min(end * lines_per_block, line_count));
+		});
+	}
+
+	// Offsets of the lines [line, line + count) in an array.
+	using LineOffsets = std::array<std::ptrdiff_t, lines_per_block>;
+
+	void fill_line_offsets(LineOffsets& offsets, const std::size_t line, const std::size_t count, const va::VData& data, const std::size_t axis) {
+		for (std::size_t q = 0; q < count; ++q) offsets[q] = line_offset(line + q, va::shape(data), va::strides(data), axis);
+	}
+
+	// Transforms data along axis, in place. The inverse transform is conj(fft(conj(x))) / n.
+	template <typename T>
+	void transform_axis(va::VData& data, const std::size_t axis, const bool inverse) {
+		using C = std::complex<T>;
+		const std::size_t n = va::shape(data)[axis];
+		if (n <= 1) return;
+
+		const auto plan = va::dft::get_plan<T>(n);
+		const std::ptrdiff_t stride = va::strides(data)[axis];
+		C* ptr = data_of<C>(data);
+		const T scale = T(1) / static_cast<T>(n);
+
+		run_lines(va::size(data) / n, n, [&](const std::size_t begin, const std::size_t end) {
+			std::vector<C> buffer(n * lines_per_block);
+			std::vector<C> work(plan->work_size * lines_per_block);
+			LineOffsets offsets;
+
+			for (std::size_t line = begin; line < end; line += lines_per_block) {
+				const std::size_t count = std::min(lines_per_block, end - line);
+				fill_line_offsets(offsets, line, count, data, axis);
+
+				for (std::size_t j = 0; j < n; ++j) {
+					for (std::size_t q = 0; q < count; ++q) {
+						const C value = ptr[offsets[q] + static_cast<std::ptrdiff_t>(j) * stride];
+						buffer[j * count + q] = inverse ? std::conj(value) : value;
+					}
+				}
+
+				va::dft::execute(*plan, buffer.data(), work.data(), count);
+
+				for (std::size_t j = 0; j < n; ++j) {
+					for (std::size_t q = 0; q < count; ++q) {
+						const C value = buffer[j * count + q];
+						ptr[offsets[q] + static_cast<std::ptrdiff_t>(j) * stride] = inverse ? std::conj(value) * scale : value;
+					}
+				}
+			}
+		});
+	}
+
+	template <typename T>
+	void transform_axes(va::VStoreAllocator& allocator, const va::VArrayTarget& target, const va::VData& a, const va::axes_type& axes, const bool inverse) {
+		va::axes_type axes_;
+		for (const auto axis : axes) axes_.push_back(static_cast<std::ptrdiff_t>(va::util::normalize_axis(axis, va::dimension(a))));
+
+		// The transforms run in place on the result, so the target is used directly if it has the right dtype and shape.
+		std::shared_ptr<va::VArray> temp;
+		va::VData& result = va::evaluate_exact_target(allocator, target, complex_dtype<T>, va::shape(a), temp);
+		va::assign(result, a);
+
+		for (const auto axis : axes_) transform_axis<T>(result, axis, inverse);
+
+		if (temp) va::assign(*std::get<va::VData*>(target), temp->data);
+	}
+
+	void transform_axes(va::VStoreAllocator& allocator, const va::VArrayTarget& target, const va::VData& a, const va::axes_type& axes, const bool inverse) {
+		if (is_single_precision(va::dtype(a))) transform_axes<float>(allocator, target, a, axes, inverse);
+		else transform_axes<double>(allocator, target, a, axes, inverse);
+	}
+
+	// Real input I is T, or std::complex<T>, whose imaginary parts are ignored.
+	template <typename T, typename I>
+	void rfft_axis(const va::VData& in, va::VData& out, const std::size_t axis) {
+		using C = std::complex<T>;
+		const std::size_t n = va::shape(in)[axis];
+		const std::size_t h = n / 2;
+
+		const I* in_ptr = data_of<I>(in);
+		C* out_ptr = data_of<C>(out);
+		const std::ptrdiff_t in_stride = va::strides(in)[axis];
+		const std::ptrdiff_t out_stride = va::strides(out)[axis];
+
+		const auto read = [in_ptr, in_stride](const std::ptrdiff_t offset, const std::size_t j) -> T {
+			const I value = in_ptr[offset + static_cast<std::ptrdiff_t>(j) * in_stride];
+			if constexpr (std::is_same_v<I, T>) return value;
+			else return value.real();
+		};
+		const auto write = [out_ptr, out_stride](const C* x, const LineOffsets& offsets, const std::size_t count, const std::size_t size) {
+			for (std::size_t k = 0; k < size; ++k) {
+				for (std::size_t q = 0; q < count; ++q) out_ptr[offsets[q] + static_cast<std::ptrdiff_t>(k) * out_stride] = x[k * count + q];
+			}
+		};
+
+		if (n % 2 == 0) {
+			// Half the work: The even and odd elements are transformed together as one complex sequence of n / 2 elements.
+			const auto real_plan = va::dft::get_real_plan<T>(n);
+			const auto& plan = *real_plan->half_plan;
+
+			run_lines(va::size(in) / n, n, [&](const std::size_t begin, const std::size_t end) {
+				std::vector<C> z(h * lines_per_block);
+				std::vector<C> x((h + 1) * lines_per_block);
+				std::vector<C> work(plan.work_size * lines_per_block);
+				LineOffsets in_offsets, out_offsets;
+
+				for (std::size_t line = begin; line < end; line += lines_per_block) {
+					const std::size_t count = std::min(lines_per_block, end - line);
+					fill_line_offsets(in_offsets, line, count, in, axis);
+					fill_line_offsets(out_offsets, line, count, out, axis);
+
+					for (std::size_t j = 0; j < h; ++j) {
+						for (std::size_t q = 0; q < count; ++q) z[j * count + q] = { read(in_offsets[q], 2 * j), read(in_offsets[q], 2 * j + 1) };
+					}
+
+					va::dft::execute(plan, z.data(), work.data(), count);
+					va::dft::unpack_real(*real_plan, z.data(), x.data(), count);
+					write(x.data(), out_offsets, count, h + 1);
+				}
+			});
+		}
+		else {
+			const auto plan = va::dft::get_plan<T>(n);
+
+			run_lines(va::size(in) / n, n, [&](const std::size_t begin, const std::size_t end) {
+				std::vector<C> x(n * lines_per_block);
+				std::vector<C> work(plan->work_size * lines_per_block);
+				LineOffsets in_offsets, out_offsets;
+
+				for (std::size_t line = begin; line < end; line += lines_per_block) {
+					const std::size_t count = std::min(lines_per_block, end - line);
+					fill_line_offsets(in_offsets, line, count, in, axis);
+					fill_line_offsets(out_offsets, line, count, out, axis);
+
+					for (std::size_t j = 0; j < n; ++j) {
+						for (std::size_t q = 0; q < count; ++q) x[j * count + q] = read(in_offsets[q], j);
+					}
+
+					va::dft::execute(*plan, x.data(), work.data(), count);
+					write(x.data(), out_offsets, count, h + 1);
+				}
+			});
+		}
+	}
+
+	template <typename T>
+	void transform_real(va::VStoreAllocator& allocator, const va::VArrayTarget& target, const va::VData& a, const std::ptrdiff_t axis) {
+		const std::size_t axis_ = va::util::normalize_axis(axis, va::dimension(a));
+		const std::size_t n = va::shape(a)[axis_];
+		if (n == 0) throw std::runtime_error("rfft needs at least one element along axis");
+
+		va::shape_type result_shape = va::shape(a);
+		result_shape[axis_] = n / 2 + 1;
+
+		std::shared_ptr<va::VArray> temp;
+		va::VData& result = va::evaluate_exact_target(allocator, target, complex_dtype<T>, result_shape, temp);
+
+		const bool is_complex_input = is_complex(va::dtype(a));
+		const va::DType input_dtype = is_complex_input ? complex_dtype<T> : real_dtype<T>;
+		std::shared_ptr<va::VArray> input_temp;
+		const va::VData& input = va::dtype(a) == input_dtype ? a : (input_temp = va::copy_as_dtype(allocator, a, input_dtype))->data;
+
+		if (is_complex_input) rfft_axis<T, std::complex<T>>(input, result, axis_);
+		else rfft_axis<T, T>(input, result, axis_);
+
+		if (temp) va::assign(*std::get<va::VData*>(target), temp->data);
+	}
+
+	template <typename T>
+	void irfft_axis(const va::VData& in, va::VData& out, const std::size_t axis) {
+		using C = std::complex<T>;
+		const std::size_t m = va::shape(in)[axis];
+		const std::size_t n = va::shape(out)[axis];
+		const std::size_t h = n / 2;
+		// Terms beyond n / 2 are ignored, and missing ones are zero.
+		const std::size_t used = std::min(m, h + 1);
+
+		const C* in_ptr = data_of<C>(in);
+		T* out_ptr = data_of<T>(out);
+		const std::ptrdiff_t in_stride = va::strides(in)[axis];
+		const std::ptrdiff_t out_stride = va::strides(out)[axis];
+
+		// The spectrum of a real signal is conjugate symmetric, so the imaginary parts of the 0 and (for even n) n / 2 terms are ignored.
+		const bool has_nyquist = n % 2 == 0;
+		const auto read = [in_ptr, in_stride, used, h, has_nyquist](C* x, const LineOffsets& offsets, const std::size_t count) {
+			for (std::size_t k = 0; k <= h; ++k) {
+				for (std::size_t q = 0; q < count; ++q) x[k * count + q] = k < used ? in_ptr[offsets[q] + static_cast<std::ptrdiff_t>(k) * in_stride] : C(0);
+			}
+			for (std::size_t q = 0; q < count; ++q) {
+				x[q].imag(0);
+				if (has_nyquist) x[h * count + q].imag(0);
+			}
+		};
+		const auto write = [out_ptr, out_stride](const LineOffsets& offsets, const std::size_t q, const std::size_t j, const T value) {
+			out_ptr[offsets[q] + static_cast<std::ptrdiff_t>(j) * out_stride] = value;
+		};
+
+		if (n % 2 == 0) {
+			// The inverse transform of n / 2 complex elements yields the even and odd elements as real and imaginary parts.
+			const auto real_plan = va::dft::get_real_plan<T>(n);
+			const auto& plan = *real_plan->half_plan;
+			const T scale = T(1) / static_cast<T>(h);
+
+			run_lines(va::size(out) / n, n, [&](const std::size_t begin, const std::size_t end) {
+				std::vector<C> x((h + 1) * lines_per_block);
+				std::vector<C> z(h * lines_per_block);
+				std::vector<C> work(plan.work_size * lines_per_block);
+				LineOffsets in_offsets, out_offsets;
+
+				for (std::size_t line = begin; line < end; line += lines_per_block) {
+					const std::size_t count = std::min(lines_per_block, end - line);
+					fill_line_offsets(in_offsets, line, count, in, axis);
+					fill_line_offsets(out_offsets, line, count, out, axis);
+
+					read(x.data(), in_offsets, count);
+					va::dft::pack_real(*real_plan, x.data(), z.data(), count);
+					for (std::size_t i = 0; i < h * count; ++i) z[i] = std::conj(z[i]);
+
+					va::dft::execute(plan, z.data(), work.data(), count);
+
+					for (std::size_t j = 0; j < h; ++j) {
+						for (std::size_t q = 0; q < count; ++q) {
+							const C value = z[j * count + q];
+							write(out_offsets, q, 2 * j, value.real() * scale);
+							write(out_offsets, q, 2 * j + 1, -value.imag() * scale);
+						}
+					}
+				}
+			});
+		}
+		else {
+			const auto plan = va::dft::get_plan<T>(n);
+			const T scale = T(1) / static_cast<T>(n);
+
+			run_lines(va::size(out) / n, n, [&](const std::size_t begin, const std::size_t end) {
+				std::vector<C> x(n * lines_per_block);
+				std::vector<C> work(plan->work_size * lines_per_block);
+				LineOffsets in_offsets, out_offsets;
+
+				for (std::size_t line = begin; line < end; line += lines_per_block) {
+					const std::size_t count = std::min(lines_per_block, end - line);
+					fill_line_offsets(in_offsets, line, count, in, axis);
+					fill_line_offsets(out_offsets, line, count, out, axis);
+
+					// The conjugated full spectrum, whose transform has the real part n x.
+					read(x.data(), in_offsets, count);
+					for (std::size_t k = 1; k <= h; ++k) {
+						for (std::size_t q = 0; q < count; ++q) {
+							x[(n - k) * count + q] = x[k * count + q];
+							x[k * count + q] = std::conj(x[k * count + q]);
+						}
+					}
+
+					va::dft::execute(*plan, x.data(), work.data(), count);
+
+					for (std::size_t j = 0; j < n; ++j) {
+						for (std::size_t q = 0; q < count; ++q) write(out_offsets, q, j, x[j * count + q].real() * scale);
+					}
+				}
+			});
+		}
+	}
+
+	template <typename T>
+	void transform_real_inverse(va::VStoreAllocator& allocator, const va::VArrayTarget& target, const va::VData& a, std::size_t n, const std::ptrdiff_t axis) {
+		const std::size_t axis_ = va::util::normalize_axis(axis, va::dimension(a));
+		const std::size_t m = va::shape(a)[axis_];
+		if (n == 0 && m > 0) n = 2 * (m - 1);
+		if (n == 0) throw std::runtime_error("irfft needs at least one output element along axis");
+
+		va::shape_type result_shape = va::shape(a);
+		result_shape[axis_] = n;
+
+		std::shared_ptr<va::VArray> temp;
+		va::VData& result = va::evaluate_exact_target(allocator, target, real_dtype<T>, result_shape, temp);
+
+		std::shared_ptr<va::VArray> input_temp;
+		const va::VData& input = va::dtype(a) == complex_dtype<T> ? a : (input_temp = va::copy_as_dtype(allocator, a, complex_dtype<T>))->data;
+
+		irfft_axis<T>(input, result, axis_);
+
+		if (temp) va::assign(*std::get<va::VData*>(target), temp->data);
+	}
+}
+
+void va::fft(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const std::ptrdiff_t axis) {
+	transform_axes(allocator, target, a, { axis }, false);
+}
+
+void va::ifft(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const std::ptrdiff_t axis) {
+	transform_axes(allocator, target, a, { axis }, true);
+}
+
+void va::fftn(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const axes_type& axes) {
+	transform_axes(allocator, target, a, axes, false);
+}
+
+void va::ifftn(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const axes_type& axes) {
+	transform_axes(allocator, target, a, axes, true);
+}
+
+void va::rfft(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const std::ptrdiff_t axis) {
+	if (is_single_precision(va::dtype(a))) transform_real<float>(allocator, target, a, axis);
+	else transform_real<double>(allocator, target, a, axis);
+}
+
+void va::irfft(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const std::size_t n, const std::ptrdiff_t axis) {
+	if (is_single_precision(va::dtype(a))) transform_real_inverse<float>(allocator, target, a, n, axis);
+	else transform_real_inverse<double>(allocator, target, a, n, axis);
+}
@@ -6,6 +6,18 @@
 
 namespace va {
 	std::shared_ptr<VArray> fft_freq(VStoreAllocator& allocator, std::size_t n, double_t d);
+
+	// Discrete Fourier transforms. Float32 and Complex64 inputs are transformed in single precision, all others in double precision.
+	void fft(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, std::ptrdiff_t axis);
+	// The inverse of fft, normalized by 1 / n.
+	void ifft(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, std::ptrdiff_t axis);
+	// Transforms over each of the axes, in order.
+	void fftn(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const axes_type& axes);
+	void ifftn(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, const axes_type& axes);
+	// The n / 2 + 1 non-negative frequency terms of the transform of real input. Imaginary parts of complex input are ignored.
+	void rfft(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, std::ptrdiff_t axis);
+	// The inverse of rfft, with n real outputs along axis. If n is 0, it is 2 (m - 1) for m inputs along axis.
+	void irfft(VStoreAllocator& allocator, const VArrayTarget& target, const VData& a, std::size_t n, std::ptrdiff_t axis);
 }
 
 #endif //VSIGNAL_HPP
@@ -28,3 +28,10 @@ std::shared_ptr<VStore> store::XArrayStoreAllocator::allocate(const DType dtype,
 		return make_store<T>(count);
 	}, dtype_to_variant(dtype));
 }
+
+std::shared_ptr<VStore> store::DefaultStoreAllocator::allocate(const DType dtype, std::size_t count) {
+	if (arena_depth > 0) {
+		return pooled_allocator.allocate(dtype, count);
+	}
+	return static_cast<VStoreAllocator&>(xarray_allocator).allocate(dtype, count);
+}
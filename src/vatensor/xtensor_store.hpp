@@ -1,6 +1,7 @@
 #ifndef VSTORE_HPP
 #define VSTORE_HPP
 
+#include <atomic>
 #include <memory>
 #include <cmath>                           // for double_t, float_t
 #include <complex>
@@ -8,6 +9,7 @@
 #include <cstdint>                         // for int16_t, int32_t, int64_t
 
 #include "varray.hpp"
+#include "pool_store.hpp"
 
 namespace va::store {
 	template<typename T>
@@ -43,7 +45,18 @@ namespace va::store {
 		std::shared_ptr<VStore> allocate(DType dtype, std::size_t count) override;
 	};
 
-	inline XArrayStoreAllocator default_allocator = {};
+	// Allocates from the pool while an arena is open, and new xtensors otherwise.
+	class DefaultStoreAllocator: public VStoreAllocator {
+	public:
+		XArrayStoreAllocator xarray_allocator;
+		PooledStoreAllocator pooled_allocator;
+		// Arenas may be nested; the pool is used until the outermost one is closed.
+		std::atomic<std::size_t> arena_depth = 0;
+
+		std::shared_ptr<VStore> allocate(DType dtype, std::size_t count) override;
+	};
+
+	inline DefaultStoreAllocator default_allocator = {};
 
 	// For deducted V, from xexpressions
 	template<typename T>
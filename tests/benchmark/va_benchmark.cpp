@@ -0,0 +1,454 @@
+// Benchmarks the va:: layer directly, without Godot.
+// Build with `scons va_benchmark`, then run build/va_benchmark/va_benchmark --help.
+// The output is a CSV file in the same format as tests/run_tests.py --benchmark-numdot-only writes,
+//  so it can be compared with configure/derive_module_from_benchmark.py.
+
+#include <algorithm>                       // for min
+#include <chrono>                          // for steady_clock
+#include <cstdlib>                         // for exit
+#include <fstream>                         // for ofstream
+#include <functional>                      // for function
+#include <iostream>                        // for cout, cerr
+#include <memory>                          // for shared_ptr
+#include <sstream>                         // for stringstream
+#include <stdexcept>                       // for runtime_error
+#include <string>                          // for string, stoull, stod
+#include <utility>                         // for pair
+#include <vector>                          // for vector
+
+#include "vatensor/create.hpp"
+#include "vatensor/linalg.hpp"
+#include "vatensor/stride_tricks.hpp"
+#include "vatensor/varray.hpp"
+#include "vatensor/vcall.hpp"
+#include "vatensor/vparallel.hpp"
+#include "vatensor/vrandom.hpp"
+#include "vatensor/vsignal.hpp"
+#include "vatensor/vfunc/entrypoints.hpp"
+#include "vatensor/xtensor_store.hpp"
+
+using namespace va;
+
+namespace {
+	enum class Layout {
+		// Operands have the same shape and are contiguous.
+		Contiguous,
+		// Operands have the same shape, with every other element of a buffer twice the size.
+		Strided,
+		// The first operand is 2-D, the second is broadcast along its first axis.
+		Broadcast,
+	};
+
+	const char* layout_name(const Layout layout) {
+		switch (layout) {
+			case Layout::Contiguous: return "contiguous";
+			case Layout::Strided: return "strided";
+			case Layout::Broadcast: return "broadcast";
+		}
+		return "";
+	}
+
+	// Same names as numpy, so that test names match tests/run_tests.py.
+	const char* dtype_name(const DType dtype) {
+		switch (dtype) {
+			case Bool: return "bool";
+			case Float32: return "float32";
+			case Float64: return "float64";
+			case Complex64: return "complex64";
+			case Complex128: return "complex128";
+			case Int8: return "int8";
+			case Int16: return "int16";
+			case Int32: return "int32";
+			case Int64: return "int64";
+			case UInt8: return "uint8";
+			case UInt16: return "uint16";
+			case UInt32: return "uint32";
+			case UInt64: return "uint64";
+			case DTypeMax: break;
+		}
+		return "";
+	}
+
+	struct Case {
+		std::string name;
+		// Cases that create their own arrays only run with the contiguous layout.
+		bool uses_operands;
+		std::function<void(std::size_t size, DType dtype, VArray& a, VArray& b)> run;
+	};
+
+#define UNARY_CASE(UFUNC_NAME) Case { #UFUNC_NAME, true, [](std::size_t, DType, VArray& a, VArray&) {\
+	std::shared_ptr<VArray> result;\
+	va::UFUNC_NAME(default_allocator, &result, a.data);\
+}}
+
+#define BINARY_CASE(UFUNC_NAME) Case { #UFUNC_NAME, true, [](std::size_t, DType, VArray& a, VArray& b) {\
+	std::shared_ptr<VArray> result;\
+	va::UFUNC_NAME(default_allocator, &result, a.data, b.data);\
+}}
+
+#define UNARY2_CASE(UFUNC_NAME) Case { #UFUNC_NAME, true, [](std::size_t, DType, VArray& a, VArray&) {\
+	std::shared_ptr<VArray> result0, result1;\
+	va::UFUNC_NAME(default_allocator, &result0, &result1, a.data);\
+}}
+
+#define BINARY2_CASE(UFUNC_NAME) Case { #UFUNC_NAME, true, [](std::size_t, DType, VArray& a, VArray& b) {\
+	std::shared_ptr<VArray> result0, result1;\
+	va::UFUNC_NAME(default_allocator, &result0, &result1, a.data, b.data);\
+}}
+
+#define REDUCTION_CASE(UFUNC_NAME) Case { #UFUNC_NAME, true, [](std::size_t, DType, VArray& a, VArray&) {\
+	std::shared_ptr<VArray> result;\
+	va::UFUNC_NAME(default_allocator, &result, a.data, nullptr);\
+}}
+
+	// One case per table in vfunc/tables.hpp.
+	std::vector<Case> make_cases() {
+		random::VRandomEngine engine(0);
+
+		return {
+			Case { "fill", true, [](std::size_t, DType, VArray& a, VArray&) {
+				va::fill(a.data, VScalar(true));
+			}},
+			Case { "assign", true, [](std::size_t, DType, VArray& a, VArray& b) {
+				if (a.shape() == b.shape()) va::assign(a.data, b.data);
+				else va::assign(a.data, va::copy(default_allocator, b.data)->data);
+			}},
+			Case { "fill_random_float", false, [engine](std::size_t size, DType dtype, VArray&, VArray&) mutable {
+				engine.random_floats(default_allocator, shape_type { size }, dtype);
+			}},
+			Case { "fill_random_int", false, [engine](std::size_t size, DType dtype, VArray&, VArray&) mutable {
+				engine.random_integers(default_allocator, 0, 100, shape_type { size }, dtype, false);
+			}},
+			Case { "fill_random_normal", false, [engine](std::size_t size, DType dtype, VArray&, VArray&) mutable {
+				engine.random_normal(default_allocator, shape_type { size }, dtype);
+			}},
+			Case { "fill_consecutive", false, [](std::size_t size, DType dtype, VArray&, VArray&) {
+				va::arange(default_allocator, VScalar(0), VScalar(static_cast<int64_t>(size)), VScalar(1), dtype);
+			}},
+
+			UNARY_CASE(negative),
+			UNARY_CASE(sign),
+			UNARY_CASE(abs),
+			UNARY_CASE(square),
+			UNARY_CASE(sqrt),
+			UNARY_CASE(exp),
+			UNARY_CASE(log),
+			UNARY_CASE(rad2deg),
+			UNARY_CASE(deg2rad),
+			UNARY_CASE(conjugate),
+
+			BINARY_CASE(add),
+			BINARY_CASE(subtract),
+			BINARY_CASE(multiply),
+			BINARY_CASE(divide),
+			BINARY_CASE(remainder),
+			BINARY2_CASE(divmod),
+			BINARY_CASE(pow),
+			BINARY_CASE(minimum),
+			BINARY_CASE(maximum),
+			Case { "clip", true, [](std::size_t, DType, VArray& a, VArray& b) {
+				std::shared_ptr<VArray> result;
+				va::clip(default_allocator, &result, a.data, a.data, b.data);
+			}},
+			Case { "where", true, [condition = std::shared_ptr<VArray>()](std::size_t, DType, VArray& a, VArray& b) mutable {
+				// The bool condition is created once per shape, so that only where is timed.
+				if (!condition || condition->shape() != a.shape()) condition = va::full(default_allocator, VScalar(true), a.shape());
+				std::shared_ptr<VArray> result;
+				va::where(default_allocator, &result, condition->data, a.data, b.data);
+			}},
+
+			REDUCTION_CASE(sum),
+			REDUCTION_CASE(prod),
+			REDUCTION_CASE(mean),
+			REDUCTION_CASE(median),
+			Case { "quantile", true, [](std::size_t, DType, VArray& a, VArray&) {
+				std::shared_ptr<VArray> result;
+				va::quantile(default_allocator, &result, a.data, 0.25, nullptr);
+			}},
+			Case { "quantile_axis", true, [](std::size_t, DType, VArray& a, VArray&) {
+				const axes_type axes { -1 };
+				std::shared_ptr<VArray> result;
+				va::quantile(default_allocator, &result, a.data, 0.25, &axes);
+			}},
+			REDUCTION_CASE(variance),
+			REDUCTION_CASE(standard_deviation),
+			REDUCTION_CASE(max),
+			REDUCTION_CASE(min),
+			REDUCTION_CASE(norm_l0),
+			REDUCTION_CASE(norm_l1),
+			REDUCTION_CASE(norm_l2),
+			REDUCTION_CASE(norm_linf),
+			REDUCTION_CASE(count_nonzero),
+			REDUCTION_CASE(all),
+			REDUCTION_CASE(any),
+
+			UNARY_CASE(sin),
+			UNARY_CASE(cos),
+			UNARY_CASE(tan),
+			UNARY_CASE(asin),
+			UNARY_CASE(acos),
+			UNARY_CASE(atan),
+			BINARY_CASE(atan2),
+			UNARY_CASE(sinh),
+			UNARY_CASE(cosh),
+			UNARY_CASE(tanh),
+			UNARY_CASE(asinh),
+			UNARY_CASE(acosh),
+			UNARY_CASE(atanh),
+			UNARY2_CASE(sincos),
+
+			UNARY_CASE(ceil),
+			UNARY_CASE(floor),
+			UNARY_CASE(trunc),
+			UNARY_CASE(round),
+			UNARY_CASE(rint),
+			UNARY2_CASE(modf),
+			UNARY2_CASE(frexp),
+
+			UNARY_CASE(logical_not),
+			BINARY_CASE(logical_and),
+			BINARY_CASE(logical_or),
+			BINARY_CASE(logical_xor),
+
+			UNARY_CASE(bitwise_not),
+			BINARY_CASE(bitwise_and),
+			BINARY_CASE(bitwise_or),
+			BINARY_CASE(bitwise_xor),
+			BINARY_CASE(bitwise_left_shift),
+			BINARY_CASE(bitwise_right_shift),
+
+			BINARY_CASE(equal),
+			BINARY_CASE(not_equal),
+			BINARY_CASE(less),
+			BINARY_CASE(less_equal),
+			BINARY_CASE(greater),
+			BINARY_CASE(greater_equal),
+
+			UNARY_CASE(isnan),
+			UNARY_CASE(isfinite),
+			UNARY_CASE(isinf),
+
+			Case { "is_close", true, [](std::size_t, DType, VArray& a, VArray& b) {
+				std::shared_ptr<VArray> result;
+				va::is_close(default_allocator, &result, a.data, b.data, 1e-05, 1e-08, false);
+			}},
+			BINARY_CASE(array_equiv),
+			Case { "all_close", true, [](std::size_t, DType, VArray& a, VArray& b) {
+				std::shared_ptr<VArray> result;
+				va::all_close(default_allocator, &result, a.data, b.data, 1e-05, 1e-08, false);
+			}},
+
+			Case { "fft", true, [](std::size_t, DType, VArray& a, VArray&) {
+				std::shared_ptr<VArray> result;
+				va::fft(default_allocator, &result, a.data, -1);
+			}},
+			Case { "rfft", true, [](std::size_t, DType, VArray& a, VArray&) {
+				std::shared_ptr<VArray> result;
+				va::rfft(default_allocator, &result, a.data, -1);
+			}},
+			Case { "pad", true, [](std::size_t, DType, VArray& a, VArray&) {
+				std::shared_ptr<VArray> result;
+				va::pad(default_allocator, &result, a, { { 1, 1 } }, xt::pad_mode::constant, VScalar(0));
+			}},
+
+			Case { "sum_product", true, [](std::size_t, DType, VArray& a, VArray& b) {
+				std::shared_ptr<VArray> result;
+				va::sum_product(default_allocator, &result, a.data, b.data, nullptr);
+			}},
+			Case { "a0xb1_minus_a1xb0", true, [](std::size_t, DType, VArray& a, VArray& b) {
+				std::shared_ptr<VArray> result;
+				va::a0xb1_minus_a1xb0(default_allocator, &result, a.data, b.data, 0, 1);
+			}},
+		};
+	}
+
+#undef UNARY_CASE
+#undef BINARY_CASE
+#undef UNARY2_CASE
+#undef BINARY2_CASE
+#undef REDUCTION_CASE
+
+	std::shared_ptr<VArray> full(const DType dtype, const shape_type& shape, const int value) {
+		return va::full(default_allocator, static_cast_scalar(VScalar(value), dtype), shape);
+	}
+
+	// Returns operands a and b for the layout. Values are 1 and 2, which are in the domain of all functions.
+	std::pair<std::shared_ptr<VArray>, std::shared_ptr<VArray>> make_operands(const DType dtype, const std::size_t size, const Layout layout) {
+		switch (layout) {
+			case Layout::Contiguous:
+				return { full(dtype, { size }, 1), full(dtype, { size }, 2) };
+			case Layout::Strided: {
+				const strides_type strides { 2 };
+				return {
+					va::as_strided(*full(dtype, { size * 2 }, 1), { size }, strides),
+					va::as_strided(*full(dtype, { size * 2 }, 2), { size }, strides)
+				};
+			}
+			case Layout::Broadcast: {
+				const std::size_t columns = std::min<std::size_t>(size, 100);
+				const std::size_t rows = size / columns;
+				return { full(dtype, { rows, columns }, 1), full(dtype, { columns }, 2) };
+			}
+		}
+		throw std::runtime_error("unknown layout");
+	}
+
+	struct Options {
+		std::vector<std::size_t> sizes { 1, 100, 10'000, 1'000'000, 10'000'000 };
+		std::vector<Layout> layouts { Layout::Contiguous, Layout::Strided, Layout::Broadcast };
+		std::vector<std::string> filters;
+		// Each case is repeated until it has run for at least this long.
+		double min_time = 0.05;
+		std::size_t num_threads = 0;
+		std::string output;
+	};
+
+	std::vector<std::string> split(const std::string& string, const char separator) {
+		std::vector<std::string> parts;
+		std::stringstream stream(string);
+		std::string part;
+		while (std::getline(stream, part, separator)) {
+			if (!part.empty()) parts.push_back(part);
+		}
+		return parts;
+	}
+
+	void print_help() {
+		std::cout <<
+			"Usage: va_benchmark [options]\n"
+			"  --filter a,b        Only run cases whose names contain any of the given strings.\n"
+			"  --sizes 1,100       Array sizes to benchmark. Default: 1,100,10000,1000000,10000000\n"
+			"  --layouts a,b       Any of contiguous, strided, broadcast. Default: all.\n"
+			"  --min-time s        Minimum seconds to repeat each case for. Default: 0.05\n"
+			"  --threads n         Number of threads. Default: 0 (all hardware threads).\n"
+			"  --output path       Write the CSV to path instead of stdout.\n";
+	}
+
+	Options parse_options(const int argc, char** argv) {
+		Options options;
+
+		for (int i = 1; i < argc; ++i) {
+			const std::string arg = argv[i];
+			if (arg == "--help") {
+				print_help();
+				std::exit(0);
+			}
+			if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+			const std::string value = argv[++i];
+
+			if (arg == "--filter") {
+				options.filters = split(value, ',');
+			}
+			else if (arg == "--sizes") {
+				options.sizes.clear();
+				for (const auto& size : split(value, ',')) options.sizes.push_back(std::stoull(size));
+			}
+			else if (arg == "--layouts") {
+				options.layouts.clear();
+				for (const auto& layout : split(value, ',')) {
+					if (layout == "contiguous") options.layouts.push_back(Layout::Contiguous);
+					else if (layout == "strided") options.layouts.push_back(Layout::Strided);
+					else if (layout == "broadcast") options.layouts.push_back(Layout::Broadcast);
+					else throw std::runtime_error("unknown layout: " + layout);
+				}
+			}
+			else if (arg == "--min-time") {
+				options.min_time = std::stod(value);
+			}
+			else if (arg == "--threads") {
+				options.num_threads = std::stoull(value);
+			}
+			else if (arg == "--output") {
+				options.output = value;
+			}
+			else {
+				throw std::runtime_error("unknown option: " + arg);
+			}
+		}
+
+		return options;
+	}
+
+	bool matches_filter(const Options& options, const std::string& name) {
+		if (options.filters.empty()) return true;
+		for (const auto& filter : options.filters) {
+			if (name.find(filter) != std::string::npos) return true;
+		}
+		return false;
+	}
+
+	// Returns the average seconds per call.
+	double time_case(const Case& case_, const std::size_t size, const DType dtype, VArray& a, VArray& b, const double min_time) {
+		using clock = std::chrono::steady_clock;
+
+		// Warm up, and make sure allocations for the result are cached.
+		case_.run(size, dtype, a, b);
+
+		std::size_t count = 0;
+		const auto start = clock::now();
+		double elapsed;
+		do {
+			case_.run(size, dtype, a, b);
+			count += 1;
+			elapsed = std::chrono::duration<double>(clock::now() - start).count();
+		} while (elapsed < min_time);
+
+		return elapsed / static_cast<double>(count);
+	}
+}
+
+int main(const int argc, char** argv) {
+	Options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << "\n";
+		print_help();
+		return 1;
+	}
+
+	parallel::set_num_threads(options.num_threads);
+
+	std::ofstream file;
+	if (!options.output.empty()) {
+		file.open(options.output);
+		if (!file) {
+			std::cerr << "Could not open " << options.output << "\n";
+			return 1;
+		}
+	}
+	std::ostream& out = options.output.empty() ? std::cout : file;
+
+	// Same columns as tests/gen/benchmark.csv.
+	out << ",numdot\n";
+
+	for (const auto& case_ : make_cases()) {
+		if (!matches_filter(options, case_.name)) continue;
+
+		for (int dtype_index = 0; dtype_index < DTypeMax; ++dtype_index) {
+			const auto dtype = static_cast<DType>(dtype_index);
+
+			for (const auto layout : options.layouts) {
+				if (!case_.uses_operands && layout != Layout::Contiguous) continue;
+
+				for (const auto size : options.sizes) {
+					const std::string name = case_.name + "_" + dtype_name(dtype) + "_" + layout_name(layout) + "_" + std::to_string(size);
+
+					try {
+						auto [a, b] = make_operands(dtype, size, layout);
+						const double seconds = time_case(case_, size, dtype, *a, *b, options.min_time);
+						out << name << "," << seconds << "\n";
+						out.flush();
+					}
+					catch (const std::exception& e) {
+						// Most tables don't support every dtype.
+						std::cerr << "Skipped " << name << ": " << e.what() << "\n";
+					}
+				}
+			}
+		}
+	}
+
+	return 0;
+}